@@ -148,6 +148,23 @@ for curr_file in files:
 
     assert (mixed_size[0] <= aig_size[0] or mixed_size[0] <= mig_size[0]) or (brute_size[0] <= aig_size[0] or brute_size[0] <= mig_size[0])
 
+#Snapshot tests: save each network, load it back in a fresh process and check
+#that the verilog written from the reloaded network, including all names, is unchanged
+print('\nSnapshot tests: ')
+for curr_file in files:
+    print('\n' + curr_file)
+    os.chdir(lstools_path)
+    snapshot_file = curr_file + '.snap'
+    orig_file = curr_file + '_orig.v'
+    reload_file = curr_file + '_reload.v'
+    cmd = ['./lsoracle','-c', 'read_aig ' + curr_file + '; write_verilog ' + orig_file + '; save_snapshot ' + snapshot_file + ';']
+    subprocess.run(cmd, stdin=subprocess.PIPE, stdout=subprocess.PIPE, check=True)
+    cmd = ['./lsoracle','-c', 'load_snapshot ' + snapshot_file + '; write_verilog ' + reload_file + ';']
+    subprocess.run(cmd, stdin=subprocess.PIPE, stdout=subprocess.PIPE, check=True)
+    with open(orig_file) as orig, open(reload_file) as reloaded:
+        assert(orig.read() == reloaded.read())
+    print('snapshot round trip preserves network and names')
+
 #unit tests.  This is a stub.
 #Grab my test files
 print('\nUnit tests:')
@@ -0,0 +1,333 @@
+/*!
+  \file npn_cache.hpp
+  \brief Process wide cache of exact NPN canonizations, optionally kept on disk
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <ostream>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <kitty/dynamic_truth_table.hpp>
+#include <kitty/hash.hpp>
+#include <kitty/npn.hpp>
+#include <kitty/operators.hpp>
+#include <kitty/print.hpp>
+
+namespace oracle
+{
+
+  /*! \brief Cache of exact NPN canonizations of functions with up to six inputs
+   *
+   * Entries are keyed by the raw 64-bit truth table, one table per number of
+   * inputs, and hold the canonical function with the phase and permutation of
+   * kitty::exact_npn_canonization. Functions with more inputs are canonized
+   * without caching. The cache is shared by all users in the process (see
+   * global()), is safe to use from several threads, and can be saved to and
+   * loaded from a binary file so that classes seen in earlier runs are not
+   * canonized again.
+   */
+  class npn_cache
+  {
+  public:
+    using npn_config = std::tuple<kitty::dynamic_truth_table, uint32_t, std::vector<uint8_t>>;
+
+    static constexpr uint32_t max_vars = 6u;
+
+    /*! \brief The cache shared by the whole process */
+    static npn_cache& global()
+    {
+      static npn_cache cache;
+      return cache;
+    }
+
+    /*! \brief Exact NPN canonization of func, computed once per function */
+    npn_config canonize( kitty::dynamic_truth_table const& func )
+    {
+      const auto num_vars = static_cast<uint32_t>( func.num_vars() );
+      if ( num_vars > max_vars )
+        return kitty::exact_npn_canonization( func );
+
+      const uint64_t bits = func._bits[0];
+      {
+        std::shared_lock<std::shared_mutex> lock( mutex );
+        const auto it = tables[num_vars].find( bits );
+        if ( it != tables[num_vars].end() )
+          return expand( num_vars, it->second );
+      }
+      const auto result = kitty::exact_npn_canonization( func );
+      std::unique_lock<std::shared_mutex> lock( mutex );
+      tables[num_vars].emplace( bits, compress( result ) );
+      return result;
+    }
+
+    /*! \brief Canonizes the functions that are not cached yet, spread over num_threads threads */
+    void canonize_all( std::vector<kitty::dynamic_truth_table> const& functions, unsigned num_threads = std::thread::hardware_concurrency() )
+    {
+      std::vector<kitty::dynamic_truth_table> missing;
+      {
+        std::array<std::unordered_map<uint64_t, bool>, max_vars + 1u> seen;
+        std::shared_lock<std::shared_mutex> lock( mutex );
+        for ( auto const& func : functions )
+        {
+          const auto num_vars = static_cast<uint32_t>( func.num_vars() );
+          if ( num_vars > max_vars || tables[num_vars].count( func._bits[0] ) )
+            continue;
+          if ( seen[num_vars].emplace( func._bits[0], true ).second )
+            missing.push_back( func );
+        }
+      }
+      if ( missing.empty() )
+        return;
+
+      std::vector<entry> results( missing.size() );
+      std::atomic<std::size_t> next{0u};
+      auto worker = [&]() {
+        for ( std::size_t i = next++; i < missing.size(); i = next++ )
+          results[i] = compress( kitty::exact_npn_canonization( missing[i] ) );
+      };
+      num_threads = std::max( 1u, std::min<unsigned>( num_threads, static_cast<unsigned>( missing.size() ) ) );
+      std::vector<std::thread> threads;
+      for ( unsigned i = 1u; i < num_threads; i++ )
+        threads.emplace_back( worker );
+      worker();
+      for ( auto& thread : threads )
+        thread.join();
+
+      std::unique_lock<std::shared_mutex> lock( mutex );
+      for ( std::size_t i = 0u; i < missing.size(); i++ )
+        tables[missing[i].num_vars()].emplace( missing[i]._bits[0], results[i] );
+    }
+
+    /*! \brief Number of cached functions */
+    std::size_t size() const
+    {
+      std::shared_lock<std::shared_mutex> lock( mutex );
+      std::size_t result = 0u;
+      for ( auto const& table : tables )
+        result += table.size();
+      return result;
+    }
+
+    /*! \brief Adds the entries of a cache file; returns false if it cannot be read or is not a cache file */
+    bool load( std::string const& path )
+    {
+      std::ifstream in( path, std::ios::binary );
+      if ( !in.is_open() )
+        return false;
+      char header[sizeof( magic )];
+      uint64_t count = 0u;
+      if ( !in.read( header, sizeof( header ) ) || !std::equal( header, header + sizeof( header ), magic ) ||
+           !read( in, count ) )
+      {
+        std::cout << path << " is not an NPN cache file\n";
+        return false;
+      }
+
+      std::vector<std::tuple<uint8_t, uint64_t, entry>> entries;
+      for ( uint64_t i = 0u; i < count; i++ )
+      {
+        uint8_t num_vars = 0u;
+        uint64_t bits = 0u;
+        entry e;
+        if ( !read( in, num_vars ) || !read( in, bits ) || !read( in, e.canonical ) || !read( in, e.phase ) ||
+             !in.read( reinterpret_cast<char*>( e.perm.data() ), e.perm.size() ) || !valid( num_vars, bits, e ) )
+        {
+          std::cout << "NPN cache file " << path << " is corrupted\n";
+          return false;
+        }
+        entries.emplace_back( num_vars, bits, e );
+      }
+
+      std::unique_lock<std::shared_mutex> lock( mutex );
+      for ( auto const& [num_vars, bits, e] : entries )
+        tables[num_vars].emplace( bits, e );
+      return true;
+    }
+
+    /*! \brief Writes all entries to a cache file */
+    bool save( std::string const& path ) const
+    {
+      std::ofstream out( path, std::ios::binary | std::ios::trunc );
+      if ( !out.is_open() )
+        return false;
+      std::shared_lock<std::shared_mutex> lock( mutex );
+      uint64_t count = 0u;
+      for ( auto const& table : tables )
+        count += table.size();
+      out.write( magic, sizeof( magic ) );
+      write( out, count );
+      for ( uint32_t num_vars = 0u; num_vars <= max_vars; num_vars++ )
+      {
+        for ( auto const& [bits, e] : tables[num_vars] )
+        {
+          write( out, static_cast<uint8_t>( num_vars ) );
+          write( out, bits );
+          write( out, e.canonical );
+          write( out, e.phase );
+          out.write( reinterpret_cast<char const*>( e.perm.data() ), e.perm.size() );
+        }
+      }
+      return static_cast<bool>( out );
+    }
+
+  private:
+    struct entry
+    {
+      uint64_t canonical = 0u;
+      uint32_t phase = 0u;
+      std::array<uint8_t, max_vars> perm{};
+    };
+
+    static constexpr char magic[8] = {'L', 'S', 'O', 'N', 'P', 'N', '0', '1'};
+
+    static entry compress( npn_config const& config )
+    {
+      entry e;
+      e.canonical = std::get<0>( config )._bits[0];
+      e.phase = std::get<1>( config );
+      std::copy( std::get<2>( config ).begin(), std::get<2>( config ).end(), e.perm.begin() );
+      return e;
+    }
+
+    static npn_config expand( uint32_t num_vars, entry const& e )
+    {
+      kitty::dynamic_truth_table canonical( num_vars );
+      canonical._bits[0] = e.canonical;
+      return {canonical, e.phase, std::vector<uint8_t>( e.perm.begin(), e.perm.begin() + num_vars )};
+    }
+
+    /* the bits fit the number of inputs, the phase has one bit per input and
+     * the output, and the permutation is one of the inputs */
+    static bool valid( uint8_t num_vars, uint64_t bits, entry const& e )
+    {
+      if ( num_vars > max_vars )
+        return false;
+      const uint64_t mask = num_vars == max_vars ? ~uint64_t( 0u ) : ( uint64_t( 1u ) << ( 1u << num_vars ) ) - 1u;
+      if ( ( bits & ~mask ) || ( e.canonical & ~mask ) || ( e.phase >> ( num_vars + 1u ) ) )
+        return false;
+      uint32_t used = 0u;
+      for ( uint32_t i = 0u; i < num_vars; i++ )
+      {
+        if ( e.perm[i] >= num_vars )
+          return false;
+        used |= 1u << e.perm[i];
+      }
+      return used == ( 1u << num_vars ) - 1u;
+    }
+
+    template<typename T>
+    static bool read( std::istream& in, T& value )
+    {
+      return static_cast<bool>( in.read( reinterpret_cast<char*>( &value ), sizeof( T ) ) );
+    }
+
+    template<typename T>
+    static void write( std::ostream& out, T const& value )
+    {
+      out.write( reinterpret_cast<char const*>( &value ), sizeof( T ) );
+    }
+
+    mutable std::shared_mutex mutex;
+    std::array<std::unordered_map<uint64_t, entry>, max_vars + 1u> tables;
+  };
+
+  /*! \brief Number of LUTs in one NPN class */
+  struct npn_class_count
+  {
+    kitty::dynamic_truth_table canonical;
+    uint32_t count = 0;
+  };
+
+  /*! \brief Counts the LUTs of a k-LUT network per NPN class
+   *
+   * Node functions are collected first, the distinct ones are canonized in
+   * parallel through the global npn_cache, and the counts are then summed per
+   * class. Classes are sorted by decreasing count, ties by number of inputs
+   * and function.
+   */
+  template<typename Ntk>
+  std::vector<npn_class_count> npn_class_histogram( Ntk const& ntk, unsigned num_threads = std::thread::hardware_concurrency() )
+  {
+    struct function_hash
+    {
+      std::size_t operator()( kitty::dynamic_truth_table const& tt ) const
+      {
+        return kitty::hash<kitty::dynamic_truth_table>()( tt ) ^ tt.num_vars();
+      }
+    };
+    struct function_equal
+    {
+      bool operator()( kitty::dynamic_truth_table const& a, kitty::dynamic_truth_table const& b ) const
+      {
+        return a.num_vars() == b.num_vars() && a == b;
+      }
+    };
+
+    std::unordered_map<kitty::dynamic_truth_table, uint32_t, function_hash, function_equal> functions;
+    ntk.foreach_node( [&]( auto const& n ) {
+      if ( ntk.is_constant( n ) || ntk.is_pi( n ) )
+        return;
+      ++functions[ntk.node_function( n )];
+    } );
+
+    std::vector<kitty::dynamic_truth_table> distinct;
+    distinct.reserve( functions.size() );
+    for ( auto const& f : functions )
+      distinct.push_back( f.first );
+    auto& cache = npn_cache::global();
+    cache.canonize_all( distinct, num_threads );
+
+    std::unordered_map<kitty::dynamic_truth_table, uint32_t, function_hash, function_equal> classes;
+    for ( auto const& f : functions )
+      classes[std::get<0>( cache.canonize( f.first ) )] += f.second;
+
+    std::vector<npn_class_count> result;
+    result.reserve( classes.size() );
+    for ( auto const& c : classes )
+      result.push_back( {c.first, c.second} );
+    std::sort( result.begin(), result.end(), []( auto const& a, auto const& b ) {
+      if ( a.count != b.count )
+        return a.count > b.count;
+      if ( a.canonical.num_vars() != b.canonical.num_vars() )
+        return a.canonical.num_vars() < b.canonical.num_vars();
+      return a.canonical < b.canonical;
+    } );
+    return result;
+  }
+
+  /*! \brief Writes an NPN class histogram as CSV, one line per class */
+  inline void write_npn_histogram_csv( std::vector<npn_class_count> const& histogram, std::ostream& os )
+  {
+    os << "class,inputs,count\n";
+    for ( auto const& c : histogram )
+      os << kitty::to_hex( c.canonical ) << ',' << c.canonical.num_vars() << ',' << c.count << '\n';
+  }
+
+  /*! \brief Writes an NPN class histogram as a JSON array of objects */
+  inline void write_npn_histogram_json( std::vector<npn_class_count> const& histogram, std::ostream& os )
+  {
+    os << "[";
+    for ( std::size_t i = 0u; i < histogram.size(); i++ )
+    {
+      auto const& c = histogram[i];
+      os << ( i == 0u ? "\n" : ",\n" ) << "  {\"class\": \"" << kitty::to_hex( c.canonical )
+         << "\", \"inputs\": " << c.canonical.num_vars() << ", \"count\": " << c.count << "}";
+    }
+    os << "\n]\n";
+  }
+
+} /* namespace oracle */
@@ -0,0 +1,329 @@
+/*!
+  \file npn_cell_library.hpp
+  \brief Standard cell implementations of NPN classes, parsed once per library file
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+#include <kitty/constructors.hpp>
+#include <kitty/dynamic_truth_table.hpp>
+#include <kitty/npn.hpp>
+#include <kitty/print.hpp>
+
+#include "npn_cache.hpp"
+
+namespace oracle
+{
+
+  /*! \brief Standard cell netlists of NPN classes, indexed by class
+   *
+   * The json database maps every NPN class ("out_<hex>") to a list of
+   * Verilog gate instances such as
+   * "NAND2xp33_ASAP7_75t_R g1(.A(a), .B(new_n6_), .Y(new_n7_));".
+   * The instances are parsed once when the library is loaded: the fanins
+   * of every gate become LUT input indices (a, b, c, ...) or internal wire
+   * ids, and the function of every cell is built up front. Libraries are
+   * loaded once per file and shared, see get().
+   *
+   * match() returns the exact NPN canonization of a LUT function together
+   * with the cells of its class. Canonizations are only memoized by the
+   * process wide npn_cache; the class is then found by its hex string.
+   */
+  class npn_cell_library
+  {
+  public:
+    /*! \brief One standard cell of a class netlist */
+    struct gate
+    {
+      std::string cell;
+      /*! \brief LUT input index if non-negative, otherwise ~wire */
+      std::vector<int32_t> fanins;
+      /*! \brief Wire driven by the cell, or -1 for the LUT output */
+      int32_t output = -1;
+      kitty::dynamic_truth_table function;
+    };
+
+    /*! \brief Netlist of an NPN class */
+    struct netlist
+    {
+      std::string name;
+      std::vector<gate> gates;
+      std::vector<std::string> wires;
+      /*! \brief Total area of the cells, 0 if the library does not give it */
+      double area = 0.0;
+    };
+
+    /*! \brief NPN canonization of a function and the netlist of its class (nullptr if not in the library) */
+    struct npn_match
+    {
+      kitty::dynamic_truth_table canonical;
+      uint32_t phase = 0;
+      std::vector<uint8_t> perm;
+      netlist const* cells = nullptr;
+    };
+
+  public:
+    npn_cell_library() = default;
+
+    explicit npn_cell_library( std::istream& in )
+    {
+      nlohmann::json json_library;
+      in >> json_library;
+      for ( auto it = json_library.begin(); it != json_library.end(); ++it )
+      {
+        const std::string key = it.key();
+        const auto gates = it.value().find( "gates" );
+        if ( key.compare( 0, 4, "out_" ) != 0 || gates == it.value().end() )
+          continue;
+        netlist& entry = classes[upper( key.substr( 4 ) )];
+        entry.name = key;
+        const auto area = it.value().find( "area" );
+        if ( area != it.value().end() && area->is_string() )
+          entry.area = std::strtod( area->get<std::string>().c_str(), nullptr );
+        else if ( area != it.value().end() && area->is_number() )
+          entry.area = area->get<double>();
+        std::unordered_map<std::string, int32_t> wire_ids;
+        for ( auto const& instance : *gates )
+        {
+          if ( instance.is_string() )
+            parse_gate( instance.get_ref<std::string const&>(), entry, wire_ids );
+        }
+      }
+    }
+
+    /*! \brief The library read from path, loaded on first use and shared afterwards
+     *
+     * Returns nullptr if path cannot be opened; it is tried again on the next call.
+     */
+    static npn_cell_library const* get( std::string const& path )
+    {
+      static std::mutex mutex;
+      static std::map<std::string, std::unique_ptr<npn_cell_library>> libraries;
+
+      std::lock_guard<std::mutex> lock( mutex );
+      auto& library = libraries[path];
+      if ( !library )
+      {
+        std::ifstream in( path );
+        if ( !in.is_open() )
+        {
+          libraries.erase( path );
+          return nullptr;
+        }
+        library = std::make_unique<npn_cell_library>( in );
+      }
+      return library.get();
+    }
+
+    std::size_t num_classes() const
+    {
+      return classes.size();
+    }
+
+    /*! \brief Netlist of the NPN class printed as hex, nullptr if the library has none */
+    netlist const* find( std::string const& hex ) const
+    {
+      const auto it = classes.find( upper( hex ) );
+      return it == classes.end() ? nullptr : &it->second;
+    }
+
+    /*! \brief Exact NPN canonization of func and the cells of its class */
+    npn_match match( kitty::dynamic_truth_table const& func ) const
+    {
+      npn_match result;
+      std::tie( result.canonical, result.phase, result.perm ) = npn_cache::global().canonize( func );
+      result.cells = find( kitty::to_hex( result.canonical ) );
+      return result;
+    }
+
+    /*! \brief Function of the standard cell with the given name and number of inputs */
+    static kitty::dynamic_truth_table cell_function( std::string const& func, uint32_t num_inputs )
+    {
+      kitty::dynamic_truth_table result (num_inputs);
+      if (func.substr(0,3) == "INV" || func == "NOT"){
+         kitty::create_from_hex_string(result, "1");
+      } else if (func.substr(0,3) == "AND"){
+        if (num_inputs == 2)
+          kitty::create_from_hex_string(result, "8");
+        if (num_inputs == 3)
+          kitty::create_from_hex_string(result, "80");
+        if (num_inputs == 4)
+          kitty::create_from_hex_string(result, "8000");
+      } else if (func.substr(0,3) == "NOR"){
+        if (num_inputs == 2)
+          kitty::create_from_hex_string(result, "1");
+        if (num_inputs == 3)
+          kitty::create_from_hex_string(result, "01");
+        if (num_inputs == 4)
+          kitty::create_from_hex_string(result, "0001");
+      } else if (func.substr(0,3) == "NAN"){
+        if (num_inputs == 2)
+          kitty::create_from_hex_string(result, "7");
+        if (num_inputs == 3)
+          kitty::create_from_hex_string(result, "7F");
+        if (num_inputs == 4)
+          kitty::create_from_hex_string(result, "7FFF");
+      } else if (func.substr(0,3) == "XOR"){
+        if (num_inputs == 2)
+          kitty::create_from_hex_string(result, "6");
+        if (num_inputs == 3)
+          kitty::create_from_hex_string(result, "96");
+        if (num_inputs == 4)
+          kitty::create_from_hex_string(result, "6996");
+      } else if (func.substr(0,3) == "XNO"){
+        if (num_inputs == 2)
+          kitty::create_from_hex_string(result, "9");
+        if (num_inputs == 3)
+          kitty::create_from_hex_string(result, "69");
+        if (num_inputs == 4)
+          kitty::create_from_hex_string(result, "9669");
+      } else if (func.substr(0,2) == "OR"){
+        if (num_inputs == 2)
+          kitty::create_from_hex_string(result, "E");
+        if (num_inputs == 3)
+          kitty::create_from_hex_string(result, "FE");
+        if (num_inputs == 4)
+          kitty::create_from_hex_string(result, "FFFE");
+      } else if (func.substr(0,4) == "MAJI"){
+        //  !((A * B) + (A * C) + (B * C))
+         kitty::create_from_hex_string(result, "17");
+      } else if (func.substr(0,3) == "MAJ"){
+         kitty::create_from_hex_string(result, "E8");
+      }else if (func.substr(0,6) == "AOI21x"){
+      //  (!A1 * !B) + (!A2 * !B)
+        kitty::create_from_chain(result, {"x4 = x1 !| x3", "x5 = x2 !| x3", "x6 = x4 | x5"});
+      } else if (func.substr(0,6) == "AOI211"){
+      //  (!A1 * !B * !C) + (!A2 * !B * !C)
+        kitty::create_from_hex_string(result, "0007");
+      } else if (func.substr(0,6) == "AOI31x"){
+      //  (!A1 * !B) + (!A2 * !B) + (!A3 * !B)
+        kitty::create_from_chain(result, {"x5 = x1 !| x4", "x6 = x2 !| x4", "x7 = x3 !| x4", "x8 = x5 | x6", "x9 = x7 | x8"});
+      } else if (func.substr(0,6) == "AOI311"){
+      //  (!A1 * !B * !C) + (!A2 * !B * !C) + (!A3 * !B * !C)
+        kitty::create_from_hex_string(result, "0000007F");
+      } else if (func.substr(0,6) == "AOI22x"){
+      //  !(A1 * A2 + B1 * B2)
+         kitty::create_from_hex_string(result, "0777");
+      } else if (func.substr(0,6) == "AOI221"){
+      //  !(A1 * A2 + B1 * B2 + C)
+        kitty::create_from_hex_string(result, "00000777");
+      } else if (func.substr(0,6) == "OAI21x"){
+        //  !((A1 + A2) * B)
+        kitty::create_from_hex_string(result, "1F");
+      } else if (func.substr(0,6) == "OAI211"){
+        //  !((A1 + A2) * B * C)
+        kitty::create_from_hex_string(result, "1FFF");
+      } else if (func.substr(0,6) == "OAI22x"){
+        //  !((A1 + A2) * (B1 + B2))
+         kitty::create_from_hex_string(result, "111F");
+      } else if (func.substr(0,6) == "OAI311"){
+        //  !((A1 + A2 + A3) * B1 * C1)
+        kitty::create_from_hex_string(result, "01FFFFFF");
+      } else if (func.substr(0,6) == "OAI32x"){
+        //function : "(!A1 * !A2 * !A3) + (!B1 * !B2)";
+        kitty::create_from_hex_string(result, "010101FF");
+      } else if (func.substr(0,6) == "OAI31x"){
+        //  !((A1 + A2 + A3) * B)
+        kitty::create_from_hex_string(result, "01FF");
+      } else if (func.substr(0,6) == "OA21x2"){
+        kitty::create_from_chain(result, {"x4 = x1 & x3", "x5 = x2 & x3", "x6 = x4 | x5"});
+      } else if (func.substr(0,6) == "OA22x2"){
+        // function : "(A1 * B1) + (A1 * B2) + (A2 * B1) + (A2 * B2)";
+        kitty::create_from_chain(result, {"x5 = x1 & x3", "x6 = x1 & x4", "x7 = x2 & x3", "x8 = x2 & x4", "x9 = x5 | x6", "x10 = x7 | x8", "x11 = x9 | x10"});
+      } else if (func.substr(0,6) == "OA31x2"){
+        // function : "(A1 * B1) + (A2 * B1) + (A3 * B1)";
+        kitty::create_from_chain(result, {"x5 = x1 & x4", "x6 = x2 & x4", "x7 = x3 & x4", "x8 = x5 | x6", "x9 = x8 | x7"});
+      } else if (func.substr(0,6) == "AO211x"){
+        //      function : "(A1 * A2) + (B) + (C)";
+        kitty::create_from_chain(result, {"x5 = x1 & x2", "x6 = x5 | x3", "x7 = x6 | x4"});
+      } else if (func.substr(0,6) == "AO21x2"){
+        //      function : "(A1 * A2) + (B)";
+        kitty::create_from_chain(result, {"x4 = x1 & x2", "x5 = x4 | x3"});
+      } else if (func.substr(0,6) == "AO22x1"){
+        //      function : "(A1 * A2) + (B1 * B2)";
+        kitty::create_from_chain(result, {"x5 = x1 & x2", "x6 = x3 & x4", "x7 = x5 | x6"});
+      } else if (func.substr(0,6) == "AO31x2"){
+        //       function : "(A1 * A2 * A3) + (B)";
+        kitty::create_from_chain(result, {"x5 = x1 & x2", "x6 = x5 & x3", "x7 = x6 | x4"});
+      }else {
+        result = kitty::dynamic_truth_table(8);
+      };
+      return result;
+    }
+
+  private:
+    static std::string upper( std::string s )
+    {
+      std::transform( s.begin(), s.end(), s.begin(), ::toupper );
+      return s;
+    }
+
+    static bool is_port_char( char c )
+    {
+      return c == 'A' || c == 'B' || c == 'C' || c == 'D' || c == 'Y' || c == '1' || c == '2' || c == '3';
+    }
+
+    /* Reads the connections .<port>(<net>) of a gate instance in order and
+     * adds the gate to entry once its output Y is found. Ports other than Y
+     * are inputs, which the library lists in pin order. */
+    static void parse_gate( std::string const& instance, netlist& entry, std::unordered_map<std::string, int32_t>& wire_ids )
+    {
+      auto wire = [&]( std::string const& name ) {
+        const auto it = wire_ids.emplace( name, static_cast<int32_t>( entry.wires.size() ) );
+        if ( it.second )
+          entry.wires.push_back( name );
+        return it.first->second;
+      };
+
+      gate g;
+      g.cell = instance.substr( 0, instance.find( " " ) );
+      for ( std::size_t pos = instance.find( '.' ); pos != std::string::npos; pos = instance.find( '.', pos + 1 ) )
+      {
+        std::size_t open = pos + 1;
+        while ( open < instance.size() && is_port_char( instance[open] ) )
+          ++open;
+        if ( open == pos + 1 || open >= instance.size() || instance[open] != '(' )
+          continue;
+        const auto close = instance.find( ')', open + 2 );
+        if ( close == std::string::npos )
+          break;
+
+        const std::string port = instance.substr( pos + 1, open - pos - 1 );
+        const std::string net = instance.substr( open + 1, close - open - 1 );
+        if ( port != "Y" )
+        {
+          if ( net.size() == 1u && net[0] >= 'a' && net[0] <= 'f' )
+            g.fanins.push_back( net[0] - 'a' );
+          else
+            g.fanins.push_back( ~wire( net ) );
+        }
+        else
+        {
+          g.output = net == "F" ? -1 : wire( net );
+          g.function = cell_function( g.cell, static_cast<uint32_t>( g.fanins.size() ) );
+          entry.gates.push_back( std::move( g ) );
+          return;
+        }
+        pos = close;
+      }
+    }
+
+    std::unordered_map<std::string, netlist> classes;
+  };
+
+} /* namespace oracle */
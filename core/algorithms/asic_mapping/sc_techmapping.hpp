@@ -0,0 +1,279 @@
+/*!
+  \file sc_techmapping.hpp
+  \brief Standard cell mapping of logic networks to the NPN class netlists of the techmap library
+
+  Instead of LUT mapping and expanding every LUT through its NPN class,
+  cuts are matched directly against the class netlists, which are costed
+  as supergates by npn_supergate_library, and the selected cells are placed
+  in a single topological pass.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include <kitty/dynamic_truth_table.hpp>
+#include <kitty/hash.hpp>
+#include <mockturtle/algorithms/sc_mapping.hpp>
+#include <mockturtle/io/liberty_reader.hpp>
+#include <mockturtle/utils/node_map.hpp>
+#include <mockturtle/views/mapping_view.hpp>
+#include <mockturtle/views/topo_view.hpp>
+
+#include "npn_cell_library.hpp"
+#include "techmapping.hpp"
+
+namespace oracle
+{
+
+  /*! \brief Area and delays of the NPN class netlists, the library of mockturtle::sc_mapping
+   *
+   * A function of up to four inputs is implemented by the netlist of its NPN
+   * class plus an inverter for every negated input and for a negated output,
+   * as npn_cell_builder places them. Without a Liberty library the area of a
+   * class is the one given by the json database and every cell has delay 1.
+   * With one, the areas of the cells are summed and their delay is the
+   * slowest arc at the middle of its tables. Matches are memoized by
+   * function.
+   */
+  class npn_supergate_library
+  {
+  public:
+    explicit npn_supergate_library( npn_cell_library const& cells, mockturtle::liberty_library const* liberty = nullptr )
+        : cells( cells ), liberty( liberty )
+    {
+      /* the json database lists the inverter as a class of one cell */
+      for ( auto const& hex : {"3", "0F", "1"} )
+      {
+        auto const* netlist = cells.find( hex );
+        if ( netlist != nullptr && netlist->gates.size() == 1u && netlist->gates[0].cell.compare( 0, 3, "INV" ) == 0 && netlist->area > 0.0 )
+        {
+          inverter_area = netlist->area;
+          break;
+        }
+      }
+      if ( liberty != nullptr )
+      {
+        if ( auto const* inv = liberty->find( "INVx2_ASAP7_75t_R" ) )
+        {
+          inverter_area = inv->area;
+          inverter_delay = cell_delay( *inv );
+        }
+      }
+    }
+
+    mockturtle::sc_supergate const* match( kitty::dynamic_truth_table const& function ) const
+    {
+      auto it = memo.find( function );
+      if ( it == memo.end() )
+        it = memo.emplace( function, compute( function ) ).first;
+      return it->second ? &*it->second : nullptr;
+    }
+
+  private:
+    std::optional<mockturtle::sc_supergate> compute( kitty::dynamic_truth_table const& function ) const
+    {
+      const auto num_vars = static_cast<uint32_t>( function.num_vars() );
+      if ( num_vars == 1u )
+      {
+        /* buffers are not cells, constants are not cuts */
+        if ( ( function._bits[0] & 3u ) != 1u )
+          return std::nullopt;
+        return mockturtle::sc_supergate{inverter_area, {inverter_delay}};
+      }
+      if ( num_vars == 0u || num_vars > 4u )
+        return std::nullopt;
+
+      const auto match = cells.match( function );
+      if ( match.cells == nullptr )
+        return std::nullopt;
+      auto const& netlist = *match.cells;
+
+      /* longest path from every netlist input to the output */
+      std::vector<double> input_delays( num_vars, -1.0 );
+      std::vector<double> wire_delays( netlist.wires.size() );
+      double area{0.0};
+      bool all_cells{liberty != nullptr};
+      for ( auto j = 0u; j < num_vars; ++j )
+      {
+        std::fill( wire_delays.begin(), wire_delays.end(), -1.0 );
+        for ( auto const& gate : netlist.gates )
+        {
+          double arrival{-1.0};
+          for ( auto fanin : gate.fanins )
+          {
+            if ( fanin >= static_cast<int32_t>( num_vars ) )
+              return std::nullopt;
+            if ( fanin == static_cast<int32_t>( j ) )
+              arrival = std::max( arrival, 0.0 );
+            else if ( fanin < 0 )
+              arrival = std::max( arrival, wire_delays[~fanin] );
+          }
+          if ( arrival >= 0.0 )
+            arrival += gate_delay( gate.cell );
+          if ( gate.output < 0 )
+            input_delays[j] = std::max( input_delays[j], arrival );
+          else
+            wire_delays[gate.output] = std::max( wire_delays[gate.output], arrival );
+        }
+      }
+      for ( auto const& gate : netlist.gates )
+      {
+        auto const* cell = liberty != nullptr ? liberty->find( gate.cell ) : nullptr;
+        all_cells = all_cells && cell != nullptr;
+        area += cell != nullptr ? cell->area : 0.0;
+      }
+      if ( !all_cells )
+        area = netlist.area;
+
+      /* netlist input j is driven by cut leaf perm[j], through an inverter if the leaf is negated */
+      const bool negated_output = ( match.phase >> num_vars ) & 1u;
+      mockturtle::sc_supergate gate;
+      gate.delays.assign( num_vars, 0.0 );
+      for ( auto j = 0u; j < num_vars; ++j )
+      {
+        const auto leaf = match.perm[j];
+        if ( input_delays[j] < 0.0 )
+          continue;
+        const double delay = input_delays[j] + ( ( ( match.phase >> leaf ) & 1u ) ? inverter_delay : 0.0 ) + ( negated_output ? inverter_delay : 0.0 );
+        gate.delays[leaf] = std::max( gate.delays[leaf], delay );
+      }
+      gate.area = area;
+      for ( auto i = 0u; i <= num_vars; ++i )
+      {
+        if ( ( match.phase >> i ) & 1u )
+          gate.area += inverter_area;
+      }
+      return gate;
+    }
+
+    double gate_delay( std::string const& cell ) const
+    {
+      if ( liberty == nullptr )
+        return 1.0;
+      auto const* lib_cell = liberty->find( cell );
+      return lib_cell != nullptr ? cell_delay( *lib_cell ) : 1.0;
+    }
+
+    /* slowest arc of the cell at the middle of its tables */
+    static double cell_delay( mockturtle::liberty_cell const& cell )
+    {
+      double delay{0.0};
+      for ( auto const& arc : cell.arcs )
+      {
+        for ( auto const* table : {&arc.cell_rise, &arc.cell_fall} )
+        {
+          if ( table->empty() )
+            continue;
+          const double slew = table->slews.empty() ? 0.0 : table->slews[table->slews.size() / 2u];
+          const double load = table->loads.empty() ? 0.0 : table->loads[table->loads.size() / 2u];
+          delay = std::max( delay, table->lookup( slew, load ) );
+        }
+      }
+      return delay;
+    }
+
+    /* truth tables of different sizes may share the same bits */
+    struct function_hash
+    {
+      std::size_t operator()( kitty::dynamic_truth_table const& tt ) const
+      {
+        return kitty::hash<kitty::dynamic_truth_table>()( tt ) ^ tt.num_vars();
+      }
+    };
+
+    struct function_equal
+    {
+      bool operator()( kitty::dynamic_truth_table const& a, kitty::dynamic_truth_table const& b ) const
+      {
+        return a.num_vars() == b.num_vars() && a == b;
+      }
+    };
+
+    npn_cell_library const& cells;
+    mockturtle::liberty_library const* liberty;
+    double inverter_area{1.0};
+    double inverter_delay{1.0};
+    mutable std::unordered_map<kitty::dynamic_truth_table, std::optional<mockturtle::sc_supergate>, function_hash, function_equal> memo;
+  };
+
+  /*! \brief Maps ntk to the standard cells of the NPN class netlists in cells
+   *
+   * Runs mockturtle::sc_mapping with an npn_supergate_library and places the
+   * cells of the selected cuts in one pass over a topo_view of ntk. Returns
+   * the cell network and the cell of every node, like techmap_mapped_network.
+   * Cells whose class cannot be placed are reported and left unmapped.
+   */
+  template<class NtkDest, class Ntk>
+  std::tuple<NtkDest, std::unordered_map<int, std::string>> sc_techmap_network( Ntk const& ntk, npn_cell_library const& cells,
+                                                                               mockturtle::sc_mapping_params const& ps = {}, mockturtle::liberty_library const* liberty = nullptr,
+                                                                               mockturtle::sc_mapping_stats* pst = nullptr )
+  {
+    mockturtle::mapping_view<Ntk, true> mapped{ntk};
+    npn_supergate_library supergates( cells, liberty );
+    mockturtle::sc_mapping( mapped, supergates, ps, pst );
+
+    NtkDest dest;
+    npn_cell_builder<NtkDest> builder( dest, cells );
+    mockturtle::node_map<mockturtle::signal<NtkDest>, Ntk> node_to_signal( ntk );
+    uint32_t failed{0};
+
+    mockturtle::topo_view<Ntk>{ntk}.foreach_node( [&]( auto const& n ) {
+      if ( ntk.is_constant( n ) )
+      {
+        node_to_signal[n] = dest.get_constant( ntk.constant_value( n ) );
+      }
+      else if ( ntk.is_pi( n ) )
+      {
+        node_to_signal[n] = dest.create_pi();
+      }
+      else if ( mapped.is_cell_root( n ) )
+      {
+        std::vector<mockturtle::signal<NtkDest>> children;
+        mapped.foreach_cell_fanin( n, [&]( auto const& leaf ) {
+          children.push_back( node_to_signal[leaf] );
+        } );
+        const auto output = builder.build( children, mapped.cell_function( n ) );
+        if ( output )
+          node_to_signal[n] = *output;
+        else
+          ++failed;
+      }
+    } );
+    if ( failed > 0u )
+      std::cout << failed << " cells could not be placed and are left unmapped\n";
+
+    /* complemented outputs of a node share one inverter */
+    std::unordered_map<uint64_t, mockturtle::signal<NtkDest>> inverted;
+    ntk.foreach_po( [&]( auto const& f ) {
+      const auto n = ntk.get_node( f );
+      if ( !ntk.is_complemented( f ) )
+      {
+        dest.create_po( node_to_signal[n] );
+      }
+      else if ( ntk.is_constant( n ) )
+      {
+        dest.create_po( dest.get_constant( !ntk.constant_value( n ) ) );
+      }
+      else
+      {
+        auto it = inverted.find( ntk.node_to_index( n ) );
+        if ( it == inverted.end() )
+          it = inverted.emplace( ntk.node_to_index( n ), builder.place_inverter( node_to_signal[n] ) ).first;
+        dest.create_po( it->second );
+      }
+    } );
+
+    builder.remove_double_inverters();
+
+    return std::tuple<NtkDest, std::unordered_map<int, std::string>>( dest, builder.cell_names );
+  }
+
+} /* namespace oracle */
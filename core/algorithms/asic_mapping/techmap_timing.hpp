@@ -0,0 +1,81 @@
+/*!
+  \file techmap_timing.hpp
+  \brief Liberty timing of standard cell networks written by techmap_mapped_network
+*/
+
+#pragma once
+
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <lorina/liberty.hpp>
+#include <mockturtle/algorithms/sta.hpp>
+#include <mockturtle/io/liberty_reader.hpp>
+
+#include "../output/mapped_verilog.hpp"
+
+namespace oracle
+{
+
+  /*! \brief The cells of the given Liberty files, read on first use and shared afterwards
+   *
+   * Files that cannot be read are reported and skipped.
+   */
+  inline mockturtle::liberty_library const& liberty_library_for( std::vector<std::string> const& paths )
+  {
+    static std::mutex mutex;
+    static std::map<std::vector<std::string>, std::unique_ptr<mockturtle::liberty_library>> libraries;
+
+    std::lock_guard<std::mutex> lock( mutex );
+    auto& library = libraries[paths];
+    if ( !library )
+    {
+      library = std::make_unique<mockturtle::liberty_library>();
+      for ( auto const& path : paths )
+      {
+        std::ifstream in( path );
+        if ( !in.is_open() )
+          std::cout << "Unable to open Liberty file " << path << "\n";
+        else if ( lorina::read_liberty( in, mockturtle::liberty_reader( *library ) ) != lorina::return_code::success )
+          std::cout << "Unable to parse Liberty file " << path << "\n";
+      }
+    }
+    return *library;
+  }
+
+  /*! \brief Static timing analysis of a techmapped network
+   *
+   * cell_names gives the standard cell of every node, as returned by
+   * techmap_mapped_network. Fanins are bound to cell pins in the order the
+   * mapped Verilog writer connects them. Cells missing from the library are
+   * added to missing and timed as wires.
+   */
+  template<class Ntk>
+  mockturtle::sta_result techmap_timing( Ntk const& ntk, std::unordered_map<int, std::string> const& cell_names, mockturtle::liberty_library const& library,
+                                         mockturtle::sta_params const& ps = {}, std::vector<std::string>* missing = nullptr )
+  {
+    std::unordered_map<std::string, std::optional<mockturtle::liberty_binding>> bindings;
+    std::vector<mockturtle::liberty_binding const*> node_bindings( ntk.size(), nullptr );
+    for ( auto const& cell : cell_names )
+    {
+      auto it = bindings.find( cell.second );
+      if ( it == bindings.end() )
+      {
+        it = bindings.emplace( cell.second, mockturtle::bind_cell( library, cell.second, detail::cell_port_names( cell.second ) ) ).first;
+        if ( !it->second && missing != nullptr )
+          missing->push_back( cell.second );
+      }
+      if ( it->second && cell.first >= 0 && static_cast<uint32_t>( cell.first ) < ntk.size() )
+        node_bindings[cell.first] = &*it->second;
+    }
+    return mockturtle::static_timing_analysis( ntk, [&]( auto const& n ) { return node_bindings[ntk.node_to_index( n )]; }, ps );
+  }
+
+} /* namespace oracle */
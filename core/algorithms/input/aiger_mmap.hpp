@@ -0,0 +1,341 @@
+/*!
+  \file aiger_mmap.hpp
+  \brief Binary AIGER reader working on a memory mapped file
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <lorina/aiger.hpp>
+#include <mockturtle/io/aiger_reader.hpp>
+#include <mockturtle/traits.hpp>
+
+#include "mapped_file.hpp"
+
+namespace oracle
+{
+
+  namespace detail
+  {
+    template<class Ntk, class = void>
+    struct has_node_storage : std::false_type
+    {
+    };
+
+    template<class Ntk>
+    struct has_node_storage<Ntk, std::void_t<decltype( std::declval<Ntk&>()._storage->nodes.reserve( 0u ) ),
+                                             decltype( std::declval<Ntk&>()._storage->hash.reserve( 0u ) )>> : std::true_type
+    {
+    };
+
+    /* Cursor over the mapped bytes */
+    struct aiger_cursor
+    {
+      char const* pos;
+      char const* end;
+
+      /* unsigned decimal number, skipping leading blanks; false if there is none */
+      bool number( uint64_t& value )
+      {
+        while ( pos < end && *pos == ' ' )
+          ++pos;
+        if ( pos == end || *pos < '0' || *pos > '9' )
+          return false;
+        value = 0u;
+        while ( pos < end && *pos >= '0' && *pos <= '9' )
+          value = value * 10u + ( *pos++ - '0' );
+        return true;
+      }
+
+      /* the rest of the current line (without the newline) */
+      std::pair<char const*, char const*> line()
+      {
+        char const* first = pos;
+        char const* last = static_cast<char const*>( std::memchr( pos, '\n', end - pos ) );
+        if ( !last )
+          last = end;
+        pos = last < end ? last + 1 : end;
+        return {first, last};
+      }
+
+      /* delta of the binary AND section; false if the file ends before it does */
+      bool delta( uint64_t& value )
+      {
+        value = 0u;
+        for ( uint32_t shift = 0u; pos < end && shift < 64u; shift += 7u )
+        {
+          const uint8_t c = *pos++;
+          value |= static_cast<uint64_t>( c & 0x7fu ) << shift;
+          if ( ( c & 0x80u ) == 0u )
+            return true;
+        }
+        return false;
+      }
+    };
+
+    /* One entry of the symbol table, e.g. "i12 name" */
+    struct aiger_symbol
+    {
+      char type;
+      uint64_t index;
+      char const* first;
+      char const* last;
+    };
+
+    /* Parses the symbol table lines in [first, last); lines that are not symbols are skipped */
+    inline std::vector<aiger_symbol> parse_aiger_symbols( char const* first, char const* last )
+    {
+      std::vector<aiger_symbol> symbols;
+      aiger_cursor cursor{first, last};
+      while ( cursor.pos < cursor.end )
+      {
+        auto [begin, end] = cursor.line();
+        if ( end - begin < 3 || !std::strchr( "ilobcjf", *begin ) || begin[1] < '0' || begin[1] > '9' )
+          continue;
+        aiger_cursor entry{begin + 1, end};
+        aiger_symbol symbol{*begin, 0u, nullptr, end};
+        if ( !entry.number( symbol.index ) || entry.pos == end || *entry.pos != ' ' )
+          continue;
+        /* names run to the end of the line and may not contain a carriage return */
+        symbol.first = entry.pos + 1;
+        if ( std::memchr( symbol.first, '\r', end - symbol.first ) )
+          continue;
+        symbols.push_back( symbol );
+      }
+      return symbols;
+    }
+  } /* namespace detail */
+
+  /*! \brief Reads a binary AIGER file into ntk
+   *
+   * Builds the same network, with the same input, output and latch names, as
+   * lorina::read_aiger with mockturtle::aiger_reader. The file is memory
+   * mapped and decoded in place; the node storage and structural hash table
+   * are reserved up front. Large symbol tables are split at line boundaries
+   * and parsed by several threads before the names are set in file order.
+   * Files that do not start with a binary AIGER header are handed to lorina.
+   * Like lorina, returns lorina::return_code::parse_error for truncated files
+   * and literals that refer to variables not defined before their use; ntk
+   * may then hold part of the network.
+   */
+  template<class Ntk>
+  lorina::return_code read_aiger_mmap( std::string const& filename, Ntk& ntk, unsigned num_threads = std::thread::hardware_concurrency() )
+  {
+    detail::mapped_file file( lorina::detail::word_exp_filename( filename ) );
+    if ( !file.is_open() )
+      return lorina::return_code::parse_error;
+
+    detail::aiger_cursor cursor{file.begin(), file.end()};
+
+    /* header: aig M I L O A [B C J F] */
+    std::vector<uint64_t> header;
+    bool binary = std::distance( cursor.pos, cursor.end ) > 4 && std::equal( cursor.pos, cursor.pos + 4, "aig " );
+    if ( binary )
+    {
+      auto [first, last] = cursor.line();
+      detail::aiger_cursor fields{first + 3, last};
+      uint64_t value;
+      while ( fields.number( value ) )
+        header.push_back( value );
+      binary = fields.pos == last && header.size() >= 5u && header.size() <= 9u;
+    }
+    if ( !binary )
+    {
+      return lorina::read_aiger( filename, mockturtle::aiger_reader( ntk ) );
+    }
+    header.resize( 9u, 0u );
+    const uint64_t num_inputs = header[1], num_latches = header[2], num_outputs = header[3], num_ands = header[4];
+    const uint64_t num_other = header[5] + header[6] + header[8];
+
+    /* every latch, output and AND record takes at least two bytes */
+    const uint64_t remaining = cursor.end - cursor.pos;
+    if ( num_latches > remaining / 2u || num_outputs > remaining / 2u || num_ands > remaining / 2u )
+      return lorina::return_code::parse_error;
+
+    if constexpr ( detail::has_node_storage<Ntk>::value )
+    {
+      ntk._storage->nodes.reserve( 1u + num_inputs + num_latches + num_ands );
+      ntk._storage->inputs.reserve( num_inputs + num_latches );
+      ntk._storage->outputs.reserve( num_outputs + num_latches );
+      ntk._storage->hash.reserve( num_ands );
+    }
+
+    std::vector<mockturtle::signal<Ntk>> signals;
+    signals.reserve( 1u + num_inputs + num_latches + num_ands );
+    signals.push_back( ntk.get_constant( false ) );
+    for ( uint64_t i = 0u; i < num_inputs; ++i )
+    {
+      signals.push_back( ntk.create_pi() );
+      if constexpr ( mockturtle::has_set_name_v<Ntk> )
+      {
+        if ( !ntk.has_name( signals.back() ) )
+          ntk.set_name( signals.back(), "pi" + std::to_string( i ) );
+      }
+    }
+    for ( uint64_t i = 0u; i < num_latches; ++i )
+      signals.push_back( ntk.create_ro() );
+
+    /* latches (next state and optional reset value) and outputs */
+    std::vector<std::pair<uint64_t, int8_t>> latches( num_latches );
+    for ( auto& latch : latches )
+    {
+      auto [first, last] = cursor.line();
+      detail::aiger_cursor fields{first, last};
+      uint64_t reset;
+      if ( !fields.number( latch.first ) )
+        return lorina::return_code::parse_error;
+      latch.second = -1;
+      if ( fields.pos < last && *fields.pos == ' ' && fields.number( reset ) && fields.pos == last && reset <= 1u )
+        latch.second = static_cast<int8_t>( reset );
+    }
+    std::vector<uint64_t> outputs( num_outputs );
+    for ( auto& output : outputs )
+    {
+      auto [first, last] = cursor.line();
+      detail::aiger_cursor fields{first, last};
+      if ( !fields.number( output ) )
+        return lorina::return_code::parse_error;
+    }
+
+    /* bad states, constraints and fairness take one line each, justice
+     * properties a header line each plus one line per literal */
+    for ( uint64_t i = 0u; i < num_other; ++i )
+      cursor.line();
+    uint64_t num_justice_lits = 0u;
+    for ( uint64_t i = 0u; i < header[7]; ++i )
+    {
+      auto [first, last] = cursor.line();
+      detail::aiger_cursor fields{first, last};
+      uint64_t size = 0u;
+      fields.number( size );
+      num_justice_lits += size;
+    }
+    for ( uint64_t i = 0u; i < num_justice_lits; ++i )
+      cursor.line();
+
+    /* AND gates, delta encoded; both fanins of gate g are smaller than g */
+    auto literal = [&]( uint64_t lit ) {
+      return ( lit & 1u ) ? ntk.create_not( signals[lit >> 1] ) : signals[lit >> 1];
+    };
+    for ( uint64_t i = num_inputs + num_latches + 1u; i < num_inputs + num_latches + num_ands + 1u; ++i )
+    {
+      const uint64_t g = i << 1;
+      uint64_t delta0, delta1;
+      if ( !cursor.delta( delta0 ) || delta0 == 0u || delta0 > g || !cursor.delta( delta1 ) || delta1 > g - delta0 )
+        return lorina::return_code::parse_error;
+      const uint64_t left = g - delta0;
+      const uint64_t right = left - delta1;
+      signals.push_back( ntk.create_and( literal( left ), literal( right ) ) );
+    }
+
+    /* outputs and latch inputs may refer to any variable */
+    const auto is_defined = [&]( uint64_t lit ) {
+      return ( lit >> 1 ) < signals.size();
+    };
+    if ( !std::all_of( outputs.begin(), outputs.end(), is_defined ) ||
+         !std::all_of( latches.begin(), latches.end(), [&]( auto const& latch ) { return is_defined( latch.first ); } ) )
+      return lorina::return_code::parse_error;
+
+    /* symbol table, up to the comment section */
+    char const* symbols_end = cursor.pos;
+    for ( detail::aiger_cursor lines{cursor.pos, cursor.end}; lines.pos < lines.end; )
+    {
+      auto [first, last] = lines.line();
+      if ( last - first == 1 && *first == 'c' )
+        break;
+      symbols_end = lines.pos;
+    }
+
+    std::vector<std::vector<detail::aiger_symbol>> chunks;
+    const std::size_t min_chunk = 1u << 20;
+    const std::size_t total = symbols_end - cursor.pos;
+    const std::size_t num_chunks = std::max<std::size_t>( 1u, std::min<std::size_t>( std::max( num_threads, 1u ), total / min_chunk ) );
+    if ( num_chunks == 1u )
+    {
+      chunks.push_back( detail::parse_aiger_symbols( cursor.pos, symbols_end ) );
+    }
+    else
+    {
+      /* chunk boundaries are moved to the start of the next line */
+      std::vector<char const*> bounds{cursor.pos};
+      for ( std::size_t i = 1u; i < num_chunks; ++i )
+      {
+        char const* bound = std::max( bounds.back(), cursor.pos + i * ( total / num_chunks ) );
+        char const* newline = static_cast<char const*>( std::memchr( bound, '\n', symbols_end - bound ) );
+        bounds.push_back( newline ? newline + 1 : symbols_end );
+      }
+      bounds.push_back( symbols_end );
+
+      chunks.resize( num_chunks );
+      std::vector<std::thread> threads;
+      for ( std::size_t i = 0u; i < num_chunks; ++i )
+      {
+        threads.emplace_back( [&chunks, &bounds, i]() {
+          chunks[i] = detail::parse_aiger_symbols( bounds[i], bounds[i + 1u] );
+        } );
+      }
+      for ( auto& thread : threads )
+        thread.join();
+    }
+
+    for ( auto const& chunk : chunks )
+    {
+      for ( auto const& symbol : chunk )
+      {
+        const std::string name( symbol.first, symbol.last );
+        if ( symbol.type == 'i' && symbol.index < num_inputs )
+        {
+          if constexpr ( mockturtle::has_set_name_v<Ntk> )
+            ntk.set_name( signals[1u + symbol.index], name );
+        }
+        else if ( symbol.type == 'l' && symbol.index < num_latches )
+        {
+          if constexpr ( mockturtle::has_set_name_v<Ntk> )
+            ntk.set_name( signals[1u + num_inputs + symbol.index], name );
+        }
+        else if ( symbol.type == 'o' )
+        {
+          if constexpr ( mockturtle::has_set_output_name_v<Ntk> )
+            ntk.set_output_name( symbol.index, name );
+        }
+      }
+    }
+
+    /* outputs, then latch inputs, with default names where the file has none */
+    uint32_t output_index = 0u;
+    for ( auto lit : outputs )
+    {
+      ntk.create_po( literal( lit ) );
+      if constexpr ( mockturtle::has_set_output_name_v<Ntk> )
+      {
+        if ( !ntk.has_output_name( output_index ) )
+          ntk.set_output_name( output_index, "po" + std::to_string( output_index ) );
+      }
+      output_index++;
+    }
+    uint32_t latch_index = 1u;
+    for ( auto const& [lit, reset] : latches )
+    {
+      ntk.create_ri( literal( lit ), reset );
+      if constexpr ( mockturtle::has_set_output_name_v<Ntk> )
+      {
+        if ( !ntk.has_output_name( output_index ) )
+          ntk.set_output_name( output_index, "li" + std::to_string( latch_index ) );
+      }
+      latch_index++;
+      output_index++;
+    }
+
+    return lorina::return_code::success;
+  }
+
+} /* namespace oracle */
@@ -0,0 +1,63 @@
+/*!
+  \file mapped_file.hpp
+  \brief Read-only memory mapping of a file
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace oracle
+{
+
+  namespace detail
+  {
+    /* Read-only mapping of a whole file */
+    class mapped_file
+    {
+    public:
+      explicit mapped_file( std::string const& filename )
+      {
+        const int fd = ::open( filename.c_str(), O_RDONLY );
+        if ( fd < 0 )
+          return;
+        struct stat st;
+        if ( ::fstat( fd, &st ) == 0 && st.st_size > 0 )
+        {
+          void* addr = ::mmap( nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+          if ( addr != MAP_FAILED )
+          {
+            ::madvise( addr, st.st_size, MADV_SEQUENTIAL );
+            _data = static_cast<char const*>( addr );
+            _size = st.st_size;
+          }
+        }
+        ::close( fd );
+      }
+
+      ~mapped_file()
+      {
+        if ( _data )
+          ::munmap( const_cast<char*>( _data ), _size );
+      }
+
+      mapped_file( mapped_file const& ) = delete;
+      mapped_file& operator=( mapped_file const& ) = delete;
+
+      char const* begin() const { return _data; }
+      char const* end() const { return _data + _size; }
+      bool is_open() const { return _data != nullptr; }
+
+    private:
+      char const* _data = nullptr;
+      std::size_t _size = 0u;
+    };
+  } /* namespace detail */
+
+} /* namespace oracle */
@@ -0,0 +1,145 @@
+/*!
+  \file lut_sweep.hpp
+  \brief LUT mapping for several LUT sizes and cut limits from one cut enumeration
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include <mockturtle/algorithms/collapse_mapped.hpp>
+#include <mockturtle/algorithms/cut_enumeration.hpp>
+#include <mockturtle/algorithms/cut_enumeration/mf_cut.hpp>
+#include <mockturtle/algorithms/lut_mapping.hpp>
+#include <mockturtle/networks/klut.hpp>
+#include <mockturtle/views/depth_view.hpp>
+#include <mockturtle/views/mapping_view.hpp>
+
+namespace oracle
+{
+
+  /*! \brief Result of mapping with one LUT size and cut limit */
+  struct lut_sweep_point
+  {
+    uint32_t lut_size = 0;
+    uint32_t cut_limit = 0;
+    uint32_t luts = 0;
+    uint32_t depth = 0;
+    bool pareto = false; /* no other point has at most as many LUTs and levels */
+  };
+
+  struct lut_sweep_result
+  {
+    std::vector<lut_sweep_point> points;
+    std::optional<mockturtle::klut_network> best; /* mapping with the smallest LUT level product */
+    std::size_t best_point = 0;
+  };
+
+  /*! \brief Maps ntk for every combination of LUT size and cut limit
+   *
+   * Cuts, with their functions, are enumerated once per LUT size, for the
+   * largest cut limit. Every cut limit of that LUT size restricts them with
+   * mockturtle::restrict_cuts and runs mockturtle::lut_mapping on them, so
+   * the largest cut limit maps exactly as lut_mapping alone would. (Deriving
+   * smaller LUT sizes from the cuts of a larger one as well loses most small
+   * cuts to the priority limit and gives far worse mappings.)
+   *
+   * The configurations are spread over num_threads threads; every thread maps
+   * a private copy of the network storage, as mapping and collapsing mark
+   * visited nodes in the storage. The cuts of a LUT size are freed once all
+   * its cut limits are mapped. LUT sizes must be at least the largest fan-in
+   * of the network and at most 16, cut limits between 2 and 25.
+   */
+  template<typename Ntk>
+  lut_sweep_result lut_sweep( Ntk const& ntk, std::vector<uint32_t> const& lut_sizes, std::vector<uint32_t> const& cut_limits,
+                              unsigned num_threads = std::thread::hardware_concurrency() )
+  {
+    using mapped_ntk = mockturtle::mapping_view<Ntk, true>;
+    using network_cuts = mockturtle::network_cuts<mapped_ntk, true, mockturtle::cut_enumeration_mf_cut>;
+
+    lut_sweep_result result;
+    for ( auto k : lut_sizes )
+    {
+      for ( auto c : cut_limits )
+        result.points.push_back( {k, c, 0u, 0u, false} );
+    }
+    if ( result.points.empty() )
+      return result;
+
+    struct size_cuts
+    {
+      std::once_flag enumerated;
+      std::unique_ptr<network_cuts> cuts;
+      std::atomic<std::size_t> remaining{0u};
+    };
+    std::vector<size_cuts> sizes( lut_sizes.size() );
+    for ( auto& size : sizes )
+      size.remaining = cut_limits.size();
+    const uint32_t max_cut_limit = *std::max_element( cut_limits.begin(), cut_limits.end() );
+
+    std::mutex mutex;
+    std::tuple<uint64_t, uint32_t, std::size_t> best_key{UINT64_MAX, UINT32_MAX, 0u};
+    std::atomic<std::size_t> next{0u};
+    auto worker = [&]() {
+      Ntk local{std::make_shared<typename Ntk::storage::element_type>( *ntk._storage )};
+      for ( std::size_t i = next++; i < result.points.size(); i = next++ )
+      {
+        auto& point = result.points[i];
+        auto& size = sizes[i / cut_limits.size()];
+        mapped_ntk mapped{local};
+
+        mockturtle::lut_mapping_params ps;
+        ps.cut_enumeration_ps.cut_size = point.lut_size;
+        ps.cut_enumeration_ps.cut_limit = point.cut_limit;
+        std::call_once( size.enumerated, [&]() {
+          auto cps = ps.cut_enumeration_ps;
+          cps.cut_limit = max_cut_limit;
+          size.cuts = std::make_unique<network_cuts>( mockturtle::cut_enumeration<mapped_ntk, true, mockturtle::cut_enumeration_mf_cut>( mapped, cps ) );
+        } );
+        auto cuts = mockturtle::restrict_cuts( mapped, *size.cuts, ps.cut_enumeration_ps );
+        if ( --size.remaining == 0u )
+          size.cuts.reset();
+        mockturtle::lut_mapping<mapped_ntk, true>( mapped, std::move( cuts ), ps );
+
+        auto klut = *mockturtle::collapse_mapped_network<mockturtle::klut_network>( mapped );
+        mockturtle::depth_view klut_depth{klut};
+        point.luts = mapped.num_cells();
+        point.depth = klut_depth.depth();
+
+        const std::tuple<uint64_t, uint32_t, std::size_t> key{uint64_t( point.luts ) * point.depth, point.luts, i};
+        std::lock_guard<std::mutex> lock( mutex );
+        if ( key < best_key )
+        {
+          best_key = key;
+          result.best = klut;
+          result.best_point = i;
+        }
+      }
+    };
+
+    num_threads = std::max( 1u, std::min<unsigned>( num_threads, static_cast<unsigned>( result.points.size() ) ) );
+    std::vector<std::thread> threads;
+    for ( unsigned i = 1u; i < num_threads; i++ )
+      threads.emplace_back( worker );
+    worker();
+    for ( auto& thread : threads )
+      thread.join();
+
+    for ( auto& p : result.points )
+    {
+      p.pareto = std::none_of( result.points.begin(), result.points.end(), [&]( auto const& q ) {
+        return q.luts <= p.luts && q.depth <= p.depth && ( q.luts < p.luts || q.depth < p.depth );
+      } );
+    }
+    return result;
+  }
+
+} /* namespace oracle */
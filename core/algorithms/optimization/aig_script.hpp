@@ -17,6 +17,7 @@ namespace oracle{
             mockturtle::xag_npn_resynthesis<mockturtle::aig_network> resyn;
             mockturtle::cut_rewriting_params ps;
             ps.cut_enumeration_ps.cut_size = 4;
+            ps.cut_enumeration_ps.num_threads = num_threads;
 
             mockturtle::cut_rewriting(aig, resyn, ps);
             aig = mockturtle::cleanup_dangling(aig);
@@ -49,5 +50,8 @@ namespace oracle{
 
             return aig;
         }
+
+        /*threads enumerating the cuts of every rewriting pass*/
+        uint32_t num_threads{1u};
     };
 }
\ No newline at end of file
@@ -30,6 +30,7 @@ namespace oracle{
             mockturtle::cut_rewriting_params ps;
 
             ps.cut_enumeration_ps.cut_size = 4;
+            ps.cut_enumeration_ps.num_threads = num_threads;
 
             mockturtle::cut_rewriting(mig, resyn, ps);
             mig = mockturtle::cleanup_dangling( mig );
@@ -94,5 +95,8 @@ namespace oracle{
 
             return mig;
         }
+
+        /*threads enumerating the cuts of every rewriting pass*/
+        uint32_t num_threads{1u};
     };
 }
\ No newline at end of file
@@ -19,6 +19,7 @@ namespace oracle{
             mockturtle::refactoring_params rp;
 
             ps.cut_enumeration_ps.cut_size = 4;
+            ps.cut_enumeration_ps.num_threads = num_threads;
             rp.allow_zero_gain = false;
 
             mockturtle::depth_view mig_depth{mig};
@@ -73,5 +74,8 @@ namespace oracle{
 
             return mig;
         }
+
+        /*threads enumerating the cuts of every rewriting pass*/
+        uint32_t num_threads{1u};
     };
 }
\ No newline at end of file
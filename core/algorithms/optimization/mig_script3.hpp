@@ -19,6 +19,7 @@ namespace oracle{
             pm.selective;
 
             ps.cut_enumeration_ps.cut_size = 4;
+            ps.cut_enumeration_ps.num_threads = num_threads;
 
             mockturtle::depth_view mig_depth{mig};
             
@@ -83,5 +84,8 @@ namespace oracle{
 
             return mig;
         }
+
+        /*threads enumerating the cuts of every rewriting pass*/
+        uint32_t num_threads{1u};
     };
 }
\ No newline at end of file
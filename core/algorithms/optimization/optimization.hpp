@@ -232,9 +232,7 @@ namespace oracle{
     }
 
     auto ntk_mig = *aig_to_mig(ntk_aig, 1);
-    oracle::partition_manager<mig_names> partitions_mig(ntk_mig, partitions_aig.get_all_part_connections(), 
-            partitions_aig.get_all_partition_inputs(), partitions_aig.get_all_partition_outputs(),
-            partitions_aig.get_all_partition_regs(), partitions_aig.get_all_partition_regin(), partitions_aig.get_part_num());
+    oracle::partition_manager<mig_names> partitions_mig(ntk_mig, partitions_aig);
 
     for(int i = 0; i < aig_parts.size(); i++){
       
@@ -0,0 +1,168 @@
+/*!
+  \file optimization_cache.hpp
+  \brief Cache of optimized partitions keyed by partition structure
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <mockturtle/networks/mig.hpp>
+#include <mockturtle/views/names_view.hpp>
+
+#include "../partitioning/partition_view.hpp"
+
+namespace oracle
+{
+
+  /*! \brief Optimization results of partitions, looked up by partition structure
+   *
+   * The key of a partition lists the gate size of the network and, in view
+   * order, the fanins of every gate and the outputs as view-local literals.
+   * Two partitions with the same key are converted into the same network by
+   * part_to_mig, so a script result computed for one of them can be
+   * synchronized into the other.
+   * Results are kept separately for every script. The cache is safe to use
+   * from several threads at once; results are shared, never copied, and
+   * must not be modified by their users.
+   *
+   * The cache holds at most max_nodes nodes of optimized networks. Once an
+   * insertion exceeds it, the results looked up least recently are evicted,
+   * which only costs running their script again.
+   */
+  class optimization_cache
+  {
+  public:
+    using mig_names = mockturtle::names_view<mockturtle::mig_network>;
+    using key = std::vector<uint64_t>;
+
+    enum class script : uint64_t { aig = 0, mig = 1 };
+
+    static constexpr std::size_t default_max_nodes = 1u << 20;
+
+    /*! \brief Optimized partition (as an MIG) with the size and depth the script reported */
+    struct entry
+    {
+      mig_names opt;
+      int size = 0;
+      int depth = 0;
+    };
+
+    explicit optimization_cache( std::size_t max_nodes = default_max_nodes ) : max_nodes( max_nodes ) {}
+
+    template<typename Ntk>
+    static key key_of( partition_view<Ntk> const& part, script s )
+    {
+      key k;
+      k.reserve( 5u + 3u * part.num_gates() + part.num_pos() );
+      k.push_back( static_cast<uint64_t>( s ) );
+      k.push_back( Ntk::max_fanin_size );
+      k.push_back( part.num_pis() + part.num_latches() );
+      k.push_back( part.size() );
+
+      auto literal = [&]( auto const& f ) {
+        return ( static_cast<uint64_t>( part.node_to_index( part.get_node( f ) ) ) << 1 ) | ( part.is_complemented( f ) ? 1u : 0u );
+      };
+      part.foreach_gate( [&]( auto n ) {
+        part.foreach_fanin( n, [&]( auto const& f ) {
+          k.push_back( literal( f ) );
+        } );
+      } );
+      part.foreach_po( [&]( auto const& f ) {
+        k.push_back( literal( f ) );
+      } );
+      return k;
+    }
+
+    std::shared_ptr<const entry> find( key const& k )
+    {
+      std::lock_guard<std::mutex> lock( mutex );
+      const auto it = entries.find( k );
+      if ( it == entries.end() )
+        return nullptr;
+      uses.splice( uses.begin(), uses, it->second.use );
+      return it->second.value;
+    }
+
+    std::shared_ptr<const entry> insert( key k, entry e )
+    {
+      auto value = std::make_shared<const entry>( std::move( e ) );
+      std::lock_guard<std::mutex> lock( mutex );
+      const auto [it, inserted] = entries.emplace( std::move( k ), slot{value, {}} );
+      if ( !inserted )
+        return it->second.value;
+      it->second.use = uses.insert( uses.begin(), &it->first );
+      num_nodes += value->opt.size();
+      evict();
+      return value;
+    }
+
+    /*! \brief Limits the cache to max_nodes nodes of optimized networks, evicting results if needed */
+    void set_max_nodes( std::size_t max_nodes )
+    {
+      std::lock_guard<std::mutex> lock( mutex );
+      this->max_nodes = max_nodes;
+      evict();
+    }
+
+    std::size_t size() const
+    {
+      std::lock_guard<std::mutex> lock( mutex );
+      return entries.size();
+    }
+
+    void clear()
+    {
+      std::lock_guard<std::mutex> lock( mutex );
+      entries.clear();
+      uses.clear();
+      num_nodes = 0u;
+    }
+
+  private:
+    struct key_hash
+    {
+      std::size_t operator()( key const& k ) const
+      {
+        uint64_t h = 0xcbf29ce484222325ull;
+        for ( auto v : k )
+        {
+          h ^= v;
+          h *= 0x100000001b3ull;
+        }
+        return static_cast<std::size_t>( h );
+      }
+    };
+
+    struct slot
+    {
+      std::shared_ptr<const entry> value;
+      std::list<key const*>::iterator use;
+    };
+
+    /* drops the least recently used results, the mutex must be held */
+    void evict()
+    {
+      while ( num_nodes > max_nodes && !uses.empty() )
+      {
+        const auto it = entries.find( *uses.back() );
+        num_nodes -= it->second.value->opt.size();
+        uses.pop_back();
+        entries.erase( it );
+      }
+    }
+
+    mutable std::mutex mutex;
+    std::unordered_map<key, slot, key_hash> entries;
+    /* keys of entries, most recently used first */
+    std::list<key const*> uses;
+    std::size_t num_nodes = 0u;
+    std::size_t max_nodes;
+  };
+
+} /* namespace oracle */
@@ -11,6 +11,11 @@
 
 #include <stdio.h>
 #include <fstream>
+#include <future>
+#include <memory>
+#include <numeric>
+#include <optional>
+#include <type_traits>
 
 #include <sys/stat.h>
 #include <stdlib.h>
@@ -27,8 +32,162 @@ namespace oracle{
   using part_man_mig = oracle::partition_manager<mig_names>;
   using part_man_mig_ntk = std::shared_ptr<part_man_mig>;
     
-  mig_names optimization_test(aig_names ntk_aig, part_man_aig partitions_aig, unsigned strategy,std::string nn_model, 
-    bool high, bool aig, bool mig, bool combine){
+  /* Result of the high effort trial of a single partition */
+  struct trial_result{
+    bool use_aig = false;
+    std::optional<mig_names> opt;
+  };
+
+  /* Decides whether the AIG result of a high effort trial beats the MIG result */
+  bool aig_wins(unsigned strategy, int aig_size, int aig_depth, int mig_size, int mig_depth){
+    switch(strategy){
+      default:
+      case 0:
+        return (aig_size * aig_depth) <= (mig_size * mig_depth);
+      case 1:
+        return aig_size <= mig_size;
+      case 2:
+        return aig_depth <= mig_depth;
+    }
+  }
+
+  /* Runs one optimization script on a partition and returns the result as an
+   * MIG, along with the size and depth the script reached. With a cache, the
+   * result is looked up first and stored once it had to be computed.
+   */
+  template<typename Ntk>
+  std::shared_ptr<const optimization_cache::entry> run_script(partition_view<Ntk> const& part,
+    optimization_cache::script script, optimization_cache* cache){
+
+    optimization_cache::key key;
+    if(cache){
+      key = optimization_cache::key_of(part, script);
+      if(auto hit = cache->find(key))
+        return hit;
+    }
+
+    optimization_cache::entry result;
+    if(script == optimization_cache::script::aig){
+      auto opt_part = *part_to_mig(part, 1);
+      auto opt = *mig_to_aig(opt_part);
+
+      oracle::aig_script aigopt;
+      opt = aigopt.run(opt);
+      mockturtle::depth_view opt_depth{opt};
+      result.size = opt.num_gates();
+      result.depth = opt_depth.depth();
+      result.opt = *aig_to_mig(opt, 0);
+    }
+    else{
+      auto opt = *part_to_mig(part, 0);
+
+      oracle::mig_script migopt;
+      opt = migopt.run(opt);
+      mockturtle::depth_view opt_depth{opt};
+      result.size = opt.num_gates();
+      result.depth = opt_depth.depth();
+      result.opt = opt;
+    }
+
+    if(cache)
+      return cache->insert(std::move(key), std::move(result));
+    return std::make_shared<const optimization_cache::entry>(std::move(result));
+  }
+
+  template<typename Ntk>
+  mig_names optimize_part_aig(partition_view<Ntk>& part, optimization_cache* cache = nullptr){
+    return run_script(part, optimization_cache::script::aig, cache)->opt;
+  }
+
+  template<typename Ntk>
+  mig_names optimize_part_mig(partition_view<Ntk>& part, optimization_cache* cache = nullptr){
+    return run_script(part, optimization_cache::script::mig, cache)->opt;
+  }
+
+  /* Runs both the AIG and the MIG script on a partition and keeps the one
+   * selected by strategy. With concurrent set, the AIG script runs on a thread
+   * of its own while the MIG script runs on the calling thread. The winner is
+   * only handed out when it is going to be synchronized right away (i.e. when
+   * not combining); both results stay in the cache either way.
+   */
+  template<typename Ntk>
+  trial_result optimize_part_trial(partition_view<Ntk>& part, unsigned strategy, bool combine,
+    optimization_cache* cache = nullptr, bool concurrent = false){
+
+    std::shared_ptr<const optimization_cache::entry> aig_result;
+    std::shared_ptr<const optimization_cache::entry> mig_result;
+    if(concurrent){
+      auto aig_trial = std::async(std::launch::async, [&](){
+        return run_script(part, optimization_cache::script::aig, cache);
+      });
+      mig_result = run_script(part, optimization_cache::script::mig, cache);
+      aig_result = aig_trial.get();
+    }
+    else{
+      aig_result = run_script(part, optimization_cache::script::aig, cache);
+      mig_result = run_script(part, optimization_cache::script::mig, cache);
+    }
+
+    trial_result result;
+    result.use_aig = aig_wins(strategy, aig_result->size, aig_result->depth, mig_result->size, mig_result->depth);
+    if(!combine)
+      result.opt = result.use_aig ? aig_result->opt : mig_result->opt;
+    return result;
+  }
+
+  /* Optimizes the partitions listed in parts and hands every result to sync,
+   * always in the order given by parts.
+   *
+   * Partition views are created and results are synchronized on the calling
+   * thread only, as both may touch the storage shared with ntk. Only optimize,
+   * which reads the parent network through the view and builds its own
+   * networks, runs on the workers. Partitions are processed in waves so that
+   * at most a few views per thread are alive at a time; with a single thread
+   * a wave is one partition and this is exactly the serial flow.
+   */
+  template<typename Ntk, typename Optimize, typename Sync>
+  void optimize_partitions(partition_manager<Ntk>& partitions, Ntk& ntk, std::vector<int> const& parts,
+    unsigned num_threads, Optimize&& optimize, Sync&& sync){
+
+    using result_t = std::invoke_result_t<Optimize&, partition_view<Ntk>&>;
+    const int num_parts = parts.size();
+    const int wave_size = num_threads <= 1 ? 1 : 4 * num_threads;
+
+    for(int first = 0; first < num_parts; first += wave_size){
+      int last = std::min(num_parts, first + wave_size);
+
+      std::vector<partition_view<Ntk>> views;
+      views.reserve(last - first);
+      for(int i = first; i < last; i++){
+        views.push_back(partitions.create_part(ntk, parts.at(i)));
+      }
+
+      std::vector<std::optional<result_t>> results(last - first);
+      parallel_for(num_threads, 0, last - first, [&](int i){
+        results[i].emplace(optimize(views[i]));
+      });
+
+      for(int i = first; i < last; i++){
+        sync(parts.at(i), views[i - first], *results[i - first]);
+      }
+    }
+  }
+
+  /* With in_place set, the partitions are optimized on views of ntk_aig and
+   * the result is assembled from the optimized partitions (see
+   * partition_assembly) instead of being cloned into an MIG copy of the whole
+   * network. ntk_aig is never modified, so the result does not depend on
+   * num_threads, and neither replaced logic nor a copy of the network is kept.
+   * The partitions are those ntk_aig had before partitions are combined, as
+   * in the default flow.
+   *
+   * Script results are taken from and added to cache when one is given, so
+   * partitions already optimized by an earlier run (including both scripts
+   * tried in high effort mode) are not optimized again.
+   */
+  mig_names optimization_test(aig_names& ntk_aig, part_man_aig& partitions_aig, unsigned strategy,std::string nn_model, 
+    bool high, bool aig, bool mig, bool combine, unsigned num_threads = 1, bool in_place = false,
+    optimization_cache* cache = nullptr){
 
     mockturtle::direct_resynthesis<mockturtle::mig_network> resyn_mig;
     mockturtle::direct_resynthesis<mockturtle::aig_network> resyn_aig;
@@ -39,10 +198,32 @@ namespace oracle{
     std::vector<int> comb_mig_parts;
     int num_parts = partitions_aig.get_part_num();
 
-    auto ntk_mig = *aig_to_mig(ntk_aig, 1);
-    oracle::partition_manager<mig_names> partitions_mig(ntk_mig, partitions_aig.get_all_part_connections(), 
-            partitions_aig.get_all_partition_inputs(), partitions_aig.get_all_partition_outputs(),
-            partitions_aig.get_all_partition_regs(), partitions_aig.get_all_partition_regin(), partitions_aig.get_part_num());
+    std::optional<mig_names> ntk_mig;
+    std::optional<part_man_mig> partitions_mig;
+    std::optional<part_man_aig> uncombined_aig;
+    std::optional<partition_assembly<aig_names>> assembly;
+    if(in_place){
+      if(combine)
+        uncombined_aig.emplace(partitions_aig);
+      assembly.emplace(ntk_aig);
+    }
+    else{
+      ntk_mig.emplace(*aig_to_mig(ntk_aig, 1));
+      partitions_mig.emplace(*ntk_mig, partitions_aig);
+    }
+
+    auto optimize_all = [&](std::vector<int> const& parts, auto&& optimize, auto&& sync){
+      if(in_place)
+        optimize_partitions(uncombined_aig ? *uncombined_aig : partitions_aig, ntk_aig, parts, num_threads, optimize, sync);
+      else
+        optimize_partitions(*partitions_mig, *ntk_mig, parts, num_threads, optimize, sync);
+    };
+    auto sync = [&](auto& part, auto& opt){
+      if constexpr(std::is_same_v<std::decay_t<decltype(part)>, partition_view<aig_names>>)
+        assembly->add(part, opt);
+      else
+        partitions_mig->synchronize_part(part, opt, *ntk_mig);
+    };
 
     if(aig){
       for(int i = 0; i < num_parts; i++){
@@ -56,87 +237,27 @@ namespace oracle{
     }
     else if(!nn_model.empty()){
       std::cout << "Performing Classification using Neural Network\n";
-      partitions_aig.run_classification(ntk_aig, nn_model);
+      partitions_aig.run_classification(ntk_aig, nn_model, num_threads);
       aig_parts = partitions_aig.get_aig_parts();
       mig_parts = partitions_aig.get_mig_parts();
     }
     else{
       std::cout << "Performing High Effort Classification and Optimization\n";
-      for(int i = 0; i < num_parts; i++){
-        oracle::partition_view<mig_names> part = partitions_mig.create_part(ntk_mig, i);
-
-        auto opt_part_aig = *part_to_mig(part, 1);
-        auto opt_aig = *mig_to_aig(opt_part_aig);
-
-        oracle::aig_script aigopt;
-        opt_aig = aigopt.run(opt_aig);
-        mockturtle::depth_view part_aig_opt_depth{opt_aig};
-        int aig_opt_size = opt_aig.num_gates();
-        int aig_opt_depth = part_aig_opt_depth.depth();
-
-        auto opt_mig = *part_to_mig(part, 0);
-        oracle::mig_script migopt;
-        opt_mig = migopt.run(opt_mig);
-        mockturtle::depth_view part_mig_opt_depth{opt_mig};
-        int mig_opt_size = opt_mig.num_gates();
-        int mig_opt_depth = part_mig_opt_depth.depth();
-
-        switch(strategy){
-          default:
-          case 0:
-          {
-            if((aig_opt_size * aig_opt_depth) <= (mig_opt_size * mig_opt_depth)){
-              aig_parts.push_back(i);
-              if(!combine){
-                auto opt_aig_mig = *aig_to_mig(opt_aig, 0);
-                partitions_mig.synchronize_part(part, opt_aig_mig, ntk_mig);
-              }
-            }
-            else{
-              mig_parts.push_back(i);
-              if(!combine){
-                partitions_mig.synchronize_part(part, opt_mig, ntk_mig);
-              }
-            }
-          }
-          break;
-          case 1:
-          {
-            if((aig_opt_size) <= (mig_opt_size)){
-              aig_parts.push_back(i);
-              if(!combine){
-                auto opt_aig_mig = *aig_to_mig(opt_aig, 0);
-                partitions_mig.synchronize_part(part, opt_aig_mig, ntk_mig);
-              }
-            }
-            else{
-              mig_parts.push_back(i);
-              if(!combine){
-                partitions_mig.synchronize_part(part, opt_mig, ntk_mig);
-              }
-            }
-          }
-          break;
-          case 2:
-          {
-            if((aig_opt_depth) <= (mig_opt_depth)){
-              aig_parts.push_back(i);
-              if(!combine){
-                auto opt_aig_mig = *aig_to_mig(opt_aig, 0);
-                partitions_mig.synchronize_part(part, opt_aig_mig, ntk_mig);
-              }
-            }
-            else{
-              mig_parts.push_back(i);
-              if(!combine){
-                partitions_mig.synchronize_part(part, opt_mig, ntk_mig);
-              }
-            }
-          }
-          break;
-        }
-        
-      }
+      std::vector<int> all_parts(num_parts);
+      std::iota(all_parts.begin(), all_parts.end(), 0);
+
+      optimize_all(all_parts,
+        [&](auto& part){
+          return optimize_part_trial(part, strategy, combine, cache, num_threads > 1);
+        },
+        [&](int i, auto& part, auto& result){
+          if(result.use_aig)
+            aig_parts.push_back(i);
+          else
+            mig_parts.push_back(i);
+          if(!combine)
+            sync(part, *result.opt);
+        });
     }
 
     std::cout << aig_parts.size() << " AIGs and " << mig_parts.size() << " MIGs\n";
@@ -256,46 +377,22 @@ namespace oracle{
     }
 
     if(!high){
-      for(int i = 0; i < aig_parts.size(); i++){
-      
-        oracle::partition_view<mig_names> part = partitions_mig.create_part(ntk_mig, aig_parts.at(i));
-        mockturtle::depth_view part_depth{part};
+      optimize_all(aig_parts,
+        [&](auto& part){ return optimize_part_aig(part, cache); },
+        [&](int, auto& part, auto& opt){ sync(part, opt); });
 
-        auto opt_part = *part_to_mig(part, 1);
-        auto opt = *mig_to_aig(opt_part);
-
-        mockturtle::depth_view opt_part_depth{opt};
-
-        oracle::aig_script aigopt;
-        opt = aigopt.run(opt);
-
-        auto opt_mig = *aig_to_mig(opt, 0);
-
-        partitions_mig.synchronize_part(part, opt_mig, ntk_mig);
-      }
-      
-      for(int i = 0; i < mig_parts.size(); i++){
-        
-        oracle::partition_view<mig_names> part = partitions_mig.create_part(ntk_mig, mig_parts.at(i));
-        mockturtle::depth_view part_depth{part};
-
-        auto opt = *part_to_mig(part, 0);
-
-        mockturtle::depth_view opt_part_depth{opt};
-        
-        oracle::mig_script migopt;
-        opt = migopt.run(opt);
-        
-        mockturtle::depth_view part_opt_depth{opt};
-
-        partitions_mig.synchronize_part(part, opt, ntk_mig);
-      }
+      optimize_all(mig_parts,
+        [&](auto& part){ return optimize_part_mig(part, cache); },
+        [&](int, auto& part, auto& opt){ sync(part, opt); });
     }
     
-    partitions_mig.connect_outputs(ntk_mig);
+    if(in_place)
+      return assembly->assemble();
+
+    partitions_mig->connect_outputs(*ntk_mig);
     
-    ntk_mig = mockturtle::cleanup_dangling( ntk_mig );
+    *ntk_mig = mockturtle::cleanup_dangling( *ntk_mig );
 
-    return ntk_mig;
+    return *ntk_mig;
   }
 }
\ No newline at end of file
@@ -0,0 +1,311 @@
+/*!
+  \file partition_assembly.hpp
+  \brief Builds the optimized network directly from optimized partitions
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <mockturtle/networks/mig.hpp>
+#include <mockturtle/traits.hpp>
+#include <mockturtle/views/names_view.hpp>
+#include <mockturtle/views/topo_view.hpp>
+
+#include "../partitioning/partition_view.hpp"
+
+namespace oracle
+{
+
+  /*! \brief Assembles the optimized version of a network from its optimized partitions
+   *
+   * Instead of cloning every optimized partition into a copy of the network
+   * and substituting the original outputs, the result is built from scratch,
+   * starting at the outputs of the network: a partition output is built from
+   * the optimized network of its partition, whose inputs are built the same
+   * way. The original network is only read, and the result never holds any
+   * replaced logic, so partitions can be optimized in any order and on any
+   * number of threads, and peak memory is the original network, the result,
+   * and the optimized partitions not fully used yet.
+   *
+   * A partition output is only taken from the optimized network if the
+   * optimized logic uses no partition input that the original cone of the
+   * output does not use. Otherwise, and for gates that are not an output of
+   * an added partition, the original gate is copied. Every node built thus
+   * only depends on nodes in its original transitive fanin, which keeps the
+   * result acyclic. The optimized network of a partition is released as soon
+   * as all of its outputs are built.
+   */
+  template<typename Ntk>
+  class partition_assembly
+  {
+  public:
+    using mig_names = mockturtle::names_view<mockturtle::mig_network>;
+    using node = typename Ntk::node;
+    using signal = typename mig_names::signal;
+
+    explicit partition_assembly( Ntk const& ntk ) : ntk( ntk ) {}
+
+    /*! \brief Adds the optimized network of a partition
+     *
+     * The inputs and outputs of opt correspond, in order, to the inputs and
+     * outputs of part, as for partitions converted with part_to_mig. A node
+     * that is an output of several added partitions is taken from the first.
+     */
+    template<typename NtkPart>
+    void add( partition_view<NtkPart> const& part, mig_names const& opt )
+    {
+      optimized_part p;
+      part.foreach_pi( [&]( auto n ) {
+        p.leaves.push_back( n );
+      } );
+      const std::size_t words = ( p.leaves.size() + 63u ) / 64u;
+
+      /* partition inputs every node of the partition and of opt depends on */
+      std::vector<uint64_t> part_support( part.size() * words, 0u );
+      for ( std::size_t i = 0u; i < p.leaves.size(); i++ )
+        part_support[part.node_to_index( p.leaves[i] ) * words + i / 64u] |= uint64_t( 1u ) << ( i % 64u );
+      part.foreach_node( [&]( auto n ) {
+        if ( part.is_constant( n ) || part.is_pi( n ) || part.is_ci( n ) || part.is_ro( n ) )
+          return;
+        auto* support = &part_support[part.node_to_index( n ) * words];
+        part.foreach_fanin( n, [&]( auto const& f ) {
+          auto const* fanin = &part_support[part.node_to_index( part.get_node( f ) ) * words];
+          for ( std::size_t w = 0u; w < words; w++ )
+            support[w] |= fanin[w];
+        } );
+      } );
+
+      std::vector<uint64_t> opt_support( opt.size() * words, 0u );
+      mockturtle::topo_view opt_topo{opt};
+      opt_topo.foreach_node( [&]( auto n ) {
+        auto* support = &opt_support[opt.node_to_index( n ) * words];
+        if ( opt.is_pi( n ) || opt.is_ro( n ) )
+        {
+          const auto i = opt.node_to_index( n ) - 1u;
+          support[i / 64u] |= uint64_t( 1u ) << ( i % 64u );
+          return;
+        }
+        opt.foreach_fanin( n, [&]( auto const& f ) {
+          auto const* fanin = &opt_support[opt.node_to_index( opt.get_node( f ) ) * words];
+          for ( std::size_t w = 0u; w < words; w++ )
+            support[w] |= fanin[w];
+        } );
+      } );
+
+      const auto slot = static_cast<uint32_t>( parts.size() );
+      opt.foreach_po( [&]( auto const& f, auto k ) {
+        p.outputs.push_back( f );
+        p.use_opt.push_back( false );
+        p.supports.emplace_back();
+
+        /* outputs that are constants or inputs of the partition are never looked up */
+        const auto root = part.get_node( part._roots.at( k ) );
+        if ( ntk.is_constant( root ) || ntk.is_ci( root ) || part.is_pi( root ) || part.is_ro( root ) || roots.count( root ) )
+          return;
+        roots.emplace( root, std::make_pair( slot, static_cast<uint32_t>( k ) ) );
+        p.pending++;
+
+        auto const* from_opt = &opt_support[opt.node_to_index( opt.get_node( f ) ) * words];
+        auto const* from_part = &part_support[part.node_to_index( root ) * words];
+        for ( std::size_t w = 0u; w < words; w++ )
+        {
+          if ( from_opt[w] & ~from_part[w] )
+            return;
+        }
+        for ( std::size_t i = 0u; i < p.leaves.size(); i++ )
+        {
+          if ( ( from_opt[i / 64u] >> ( i % 64u ) ) & 1u )
+            p.supports.back().push_back( static_cast<uint32_t>( i ) );
+        }
+        p.use_opt.back() = true;
+      } );
+
+      if ( p.pending == 0u )
+        return;
+      p.opt.emplace( opt );
+      parts.push_back( std::move( p ) );
+    }
+
+    /*! \brief Builds the network with the interface of the original one from the added partitions */
+    mig_names assemble()
+    {
+      mockturtle::mig_network mig;
+      mig_names result( mig );
+      if constexpr ( mockturtle::has_get_name_v<Ntk> )
+        result.share_name_pool( ntk );
+
+      resolved.clear();
+      resolved[ntk.get_node( ntk.get_constant( false ) )] = result.get_constant( false );
+      if ( ntk.get_node( ntk.get_constant( true ) ) != ntk.get_node( ntk.get_constant( false ) ) )
+        resolved[ntk.get_node( ntk.get_constant( true ) )] = result.get_constant( true );
+
+      ntk.foreach_pi( [&]( auto n ) {
+        if ( ntk.is_ro( n ) )
+          result._storage->data.latches.emplace_back( 0 );
+        resolved[n] = result.create_pi();
+        if constexpr ( mockturtle::has_has_name_v<Ntk> && mockturtle::has_get_name_v<Ntk> )
+          result.copy_name( resolved[n], ntk, ntk.make_signal( n ) );
+      } );
+
+      ntk.foreach_po( [&]( auto const& f, auto index ) {
+        const auto s = resolve( result, ntk.get_node( f ) );
+        result.create_po( ntk.is_complemented( f ) ? result.create_not( s ) : s );
+        if constexpr ( mockturtle::has_has_output_name_v<Ntk> && mockturtle::has_get_output_name_v<Ntk> )
+          result.copy_output_name( index, ntk, index );
+      } );
+
+      resolved.clear();
+      return result;
+    }
+
+  private:
+    struct optimized_part
+    {
+      std::vector<node> leaves;
+      std::optional<mig_names> opt;
+      std::vector<typename mig_names::signal> outputs;
+      /* outputs taken from opt, and the partition inputs they depend on */
+      std::vector<bool> use_opt;
+      std::vector<std::vector<uint32_t>> supports;
+      /* nodes of opt already built, allocated on first use */
+      std::vector<std::optional<signal>> built;
+      uint32_t pending = 0u;
+    };
+
+    struct frame
+    {
+      node n;
+      std::vector<node> inputs;
+      std::size_t next = 0u;
+    };
+
+    /* builds n after all nodes it depends on, using an explicit stack */
+    signal resolve( mig_names& result, node n )
+    {
+      std::vector<frame> stack;
+      push( stack, n );
+      while ( !stack.empty() )
+      {
+        auto& top = stack.back();
+        if ( top.next < top.inputs.size() )
+        {
+          const auto input = top.inputs[top.next++];
+          if ( !resolved.count( input ) )
+            push( stack, input );
+          continue;
+        }
+        build( result, top.n );
+        stack.pop_back();
+      }
+      return resolved.at( n );
+    }
+
+    void push( std::vector<frame>& stack, node n )
+    {
+      if ( resolved.count( n ) )
+        return;
+      frame f;
+      f.n = n;
+      if ( const auto it = roots.find( n ); it != roots.end() && parts[it->second.first].use_opt[it->second.second] )
+      {
+        auto const& p = parts[it->second.first];
+        for ( auto i : p.supports[it->second.second] )
+          f.inputs.push_back( p.leaves[i] );
+      }
+      else
+      {
+        ntk.foreach_fanin( n, [&]( auto const& c ) {
+          f.inputs.push_back( ntk.get_node( c ) );
+        } );
+      }
+      stack.push_back( std::move( f ) );
+    }
+
+    void build( mig_names& result, node n )
+    {
+      if ( resolved.count( n ) )
+        return;
+      const auto it = roots.find( n );
+      if ( it != roots.end() && parts[it->second.first].use_opt[it->second.second] )
+      {
+        resolved[n] = build_output( result, parts[it->second.first], it->second.second );
+      }
+      else
+      {
+        std::vector<signal> children;
+        ntk.foreach_fanin( n, [&]( auto const& c ) {
+          const auto s = resolved.at( ntk.get_node( c ) );
+          children.push_back( ntk.is_complemented( c ) ? result.create_not( s ) : s );
+        } );
+        resolved[n] = children.size() == 2u ? result.create_and( children[0], children[1] ) : result.create_maj( children[0], children[1], children[2] );
+      }
+
+      if ( it != roots.end() )
+      {
+        auto& p = parts[it->second.first];
+        if ( --p.pending == 0u )
+        {
+          p.opt.reset();
+          std::vector<std::optional<signal>>().swap( p.built );
+        }
+      }
+    }
+
+    /* clones the cone of output k of an optimized partition into result */
+    signal build_output( mig_names& result, optimized_part& p, uint32_t k )
+    {
+      auto const& opt = *p.opt;
+      if ( p.built.empty() )
+        p.built.resize( opt.size() );
+
+      std::vector<std::pair<typename mig_names::node, bool>> stack{{opt.get_node( p.outputs[k] ), false}};
+      while ( !stack.empty() )
+      {
+        auto [n, expanded] = stack.back();
+        stack.pop_back();
+        const auto index = opt.node_to_index( n );
+        if ( p.built[index] )
+          continue;
+        if ( opt.is_constant( n ) )
+        {
+          p.built[index] = result.get_constant( false );
+          continue;
+        }
+        if ( opt.is_pi( n ) || opt.is_ro( n ) )
+        {
+          p.built[index] = resolved.at( p.leaves.at( index - 1u ) );
+          continue;
+        }
+        if ( !expanded )
+        {
+          stack.emplace_back( n, true );
+          opt.foreach_fanin( n, [&]( auto const& c ) {
+            if ( !p.built[opt.node_to_index( opt.get_node( c ) )] )
+              stack.emplace_back( opt.get_node( c ), false );
+          } );
+          continue;
+        }
+        std::vector<signal> children;
+        opt.foreach_fanin( n, [&]( auto const& c ) {
+          const auto s = *p.built[opt.node_to_index( opt.get_node( c ) )];
+          children.push_back( opt.is_complemented( c ) ? result.create_not( s ) : s );
+        } );
+        p.built[index] = result.clone_node( opt, n, children );
+      }
+
+      const auto s = *p.built[opt.node_to_index( opt.get_node( p.outputs[k] ) )];
+      return opt.is_complemented( p.outputs[k] ) ? result.create_not( s ) : s;
+    }
+
+    Ntk const& ntk;
+    std::vector<optimized_part> parts;
+    std::unordered_map<node, std::pair<uint32_t, uint32_t>> roots;
+    std::unordered_map<node, signal> resolved;
+  };
+
+} /* namespace oracle */
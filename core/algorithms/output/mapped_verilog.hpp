@@ -44,6 +44,11 @@ endmodule
 #include <iostream>
 #include <string>
 #include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <regex>
+#include <unordered_map>
+#include <vector>
 
 #include <fmt/format.h>
 #include <mockturtle/algorithms/cleanup.hpp>
@@ -57,39 +62,145 @@ namespace oracle
 {
 
 
+namespace detail
+{
+
+/* Collects the netlist text in a large buffer that is handed to the stream in chunks */
+class verilog_chunk_writer
+{
+public:
+    explicit verilog_chunk_writer( std::ostream& os, std::size_t chunk_size = 1u << 20 )
+        : os( os ), chunk_size( chunk_size )
+    {
+        buffer.reserve( chunk_size + 256u );
+    }
+
+    ~verilog_chunk_writer()
+    {
+        flush();
+    }
+
+    verilog_chunk_writer& operator<<( std::string const& s )
+    {
+        buffer.append( s );
+        return spill();
+    }
+
+    verilog_chunk_writer& operator<<( char const* s )
+    {
+        buffer.append( s );
+        return spill();
+    }
+
+    verilog_chunk_writer& operator<<( uint64_t value )
+    {
+        char digits[20];
+        const auto end = std::to_chars( digits, digits + sizeof( digits ), value ).ptr;
+        buffer.append( digits, end - digits );
+        return spill();
+    }
+
+    void flush()
+    {
+        os.write( buffer.data(), buffer.size() );
+        buffer.clear();
+    }
+
+private:
+    verilog_chunk_writer& spill()
+    {
+        if ( buffer.size() >= chunk_size )
+            flush();
+        return *this;
+    }
+
+    std::ostream& os;
+    std::size_t chunk_size;
+    std::string buffer;
+};
+
+/* Input port names of a standard cell, in fanin order */
+inline std::vector<std::string> cell_port_names( std::string const& cell )
+{
+    std::vector <std::string> port_names;
+    if(regex_match(cell, std::regex("[AOIx123]{6}.+"))){
+        std::string working_name = cell;
+        working_name.erase(std::remove_if(working_name.begin(), working_name.end(), [](char c) { return !std::isdigit(c);}), working_name.end());
+        if (working_name.at(0) == '2'){
+            port_names.push_back("A1");
+            port_names.push_back("A2");
+        } else if (working_name.at(0) == '3'){
+            port_names.push_back("A1");
+            port_names.push_back("A2");
+            port_names.push_back("A3");
+        }
+        if (working_name.at(1)  == '1'){
+            port_names.push_back("B");
+        } else if (working_name.at(1) == '2'){
+            port_names.push_back("B1");
+            port_names.push_back("B2");
+        } else if (working_name.at(1)  == '3'){
+            port_names.push_back("B1");
+            port_names.push_back("B2");
+            port_names.push_back("B3");
+        }
+        if (working_name.at(2)  == '1'){
+            port_names.push_back("C");
+        }
+    } else {
+        port_names.push_back("A");
+        port_names.push_back("B");
+        port_names.push_back("C");
+        port_names.push_back("D");
+    }
+    return port_names;
+}
+
+} /* namespace detail */
+
+/* Writes the netlist in chunks through a large buffer. The port names of
+ * every cell type are worked out once, on its first instance. */
 template<class Ntk>
-void write_techmapped_verilog( Ntk const& ntk, std::ostream& os, std::unordered_map<int, std::string> cell_names, std::string top_name )
+void write_techmapped_verilog( Ntk const& ntk, std::ostream& os, std::unordered_map<int, std::string> const& cell_names, std::string const& top_name )
 {
-    int netlistcount;
-    std::string input_list;
-    std::string output_list;
-    std::string wire_list;
-    std::string po_assignments;
-    auto first = true; 
-    ntk.foreach_pi( [&]( auto const& n ) {
-            if (first)
-                first = false;
-            else
-                input_list += ", ";
-            input_list += fmt::format("n{}", ntk.node_to_index( n ) );
+    detail::verilog_chunk_writer out( os );
+    std::unordered_map<std::string, std::vector<std::string>> port_templates;
 
-    });
+    auto write_inputs = [&](){
+        auto first = true;
+        ntk.foreach_pi( [&]( auto const& n ) {
+                if (first)
+                    first = false;
+                else
+                    out << ", ";
+                out << "n" << static_cast<uint64_t>( ntk.node_to_index( n ) );
+        });
+    };
+    auto write_outputs = [&](){
+        auto first = true;
+        ntk.foreach_po( [&]( auto const&, auto i ) {
+                if (first)
+                    first = false;
+                else
+                    out << ", ";
+                out << "po" << static_cast<uint64_t>( i );
+        });
+    };
 
-    first = true;
-    ntk.foreach_po( [&]( auto const& n, auto i ) {
-            if (first)
-                first = false;
-            else
-                output_list += ", ";
-            output_list += fmt::format("po{}", i);
-            if ( ntk.is_constant( ntk.get_node( n ) ) ){
-                po_assignments += fmt::format( "\tassign po{} = {};\n", i, ntk.is_complemented( n ) ? "1'b1" : "1'b0" );
-            } else {
-                po_assignments += fmt::format("\tassign po{} = n{};\n", i, n);
-            }
-    });
-    
-    first = true;
+    out << "module " << top_name << "(";
+    write_inputs();
+    out << ", ";
+    write_outputs();
+    out << ");\n";
+    out << "\tinput ";
+    write_inputs();
+    out << ";\n";
+    out << "\toutput ";
+    write_outputs();
+    out << ";\n";
+
+    out << "\twire ";
+    auto first = true;
     ntk.foreach_node ( [&](auto const& n){
         if (ntk.is_pi(n) || ntk.is_constant( n)){
             return;
@@ -98,93 +209,58 @@ void write_techmapped_verilog( Ntk const& ntk, std::ostream& os, std::unordered_
             if (first)
                 first = false;
             else
-                wire_list += ", ";
-            wire_list += fmt::format("n{}", n);
+                out << ", ";
+            out << "n" << static_cast<uint64_t>( n );
         }
     });
-
-    os << "module " << top_name <<"("<<input_list <<", " << output_list<< ");\n";
-    os << "\tinput " << input_list<< ";\n";
-    os << "\toutput " << output_list << ";\n";
-    os << "\twire "<< wire_list << ";\n\n";
+    out << ";\n\n";
 //body
 
     ntk.foreach_node( [&]( auto const& n ) {
-                int flag = 0;
-
-        if (cell_names.find(n) != cell_names.end()){
-            std::vector <std::string> children;
-            std::vector <std::string> port_names;
-            if(regex_match(cell_names.at(n), std::regex("[AOIx123]{6}.+"))){
-                std::string working_name = cell_names.at(n);
-                working_name.erase(std::remove_if(working_name.begin(), working_name.end(), [](char c) { return !std::isdigit(c);}), working_name.end());
-                if (working_name.at(0) == '2'){
-                    port_names.push_back("A1");
-                    port_names.push_back("A2");
-                } else if (working_name.at(0) == '3'){
-                    port_names.push_back("A1");
-                    port_names.push_back("A2");
-                    port_names.push_back("A3");
-                }
-                if (working_name.at(1)  == '1'){
-                    port_names.push_back("B");
-                } else if (working_name.at(1) == '2'){
-                    port_names.push_back("B1");
-                    port_names.push_back("B2");
-                } else if (working_name.at(1)  == '3'){
-                    port_names.push_back("B1");
-                    port_names.push_back("B2");
-                    port_names.push_back("B3");
-                }
-                if (working_name.at(2)  == '1'){
-                    port_names.push_back("C");
-                }
+        const auto cell = cell_names.find(n);
+        if (cell == cell_names.end()){
+            return;
+        }
+        auto port_names = port_templates.find(cell->second);
+        if (port_names == port_templates.end()){
+            port_names = port_templates.emplace(cell->second, detail::cell_port_names(cell->second)).first;
+        }
+
+        out << "\t" << cell->second << " ";
+        uint32_t i = 0;
+        ntk.foreach_fanin( n, [&]( auto fanin ) {
+            if (i == 0){
+                out << "g" << static_cast<uint64_t>( n ) << "(.";
             } else {
-                port_names.push_back("A");
-                port_names.push_back("B");
-                port_names.push_back("C");
-                port_names.push_back("D");
+                out << ", .";
             }
-            // populate children, which will be function inputs
-            ntk.foreach_fanin( n, [&]( auto fanin ) {
-                //handle constants in fanin
-                if (fanin == 0){
-                    children.push_back("1'b0");
-                } else if (fanin == 1){
-                    children.push_back("1'b1");
-                } else {
-                    children.push_back(fmt::format( "n{}",fanin ));
-                }
-            } );
-            os << "\t" << cell_names.at(n) << " "; 
-                if(children.size() > 0){       
-                    os << fmt::format("g{}", n) << "(." << port_names.at(0) << "(" << children.at(0) << ")";
-                }
-                if (children.size() > 1){
-                    os << ", ." <<port_names.at(1)<<"(" << children.at(1) << ")";
-                }
-                if (children.size() > 2){
-                    os << ", ."<<port_names.at(2)<<"(" << children.at(2) << ")";
-                }
-                if (children.size() > 3){
-                    os << ", ."<<port_names.at(3)<<"(" << children.at(3) << ")";
-                }
-                if (children.size() > 4){
-                    os << ", ."<<port_names.at(4)<<"(" << children.at(4) << ")";
-                }
-                if (children.size() > 5){
-                    os << ", ."<<port_names.at(5)<<"(" << children.at(5) << ")";
-                }
-                os << ", .Y(" << fmt::format("n{}",n) << ") );\n";
-     }
+            out << port_names->second.at(i++) << "(";
+            //handle constants in fanin
+            if (fanin == 0){
+                out << "1'b0";
+            } else if (fanin == 1){
+                out << "1'b1";
+            } else {
+                out << "n" << static_cast<uint64_t>( fanin );
+            }
+            out << ")";
+        } );
+        out << ", .Y(n" << static_cast<uint64_t>( n ) << ") );\n";
     } );
-    os << po_assignments;
-    os << "endmodule\n";
+
+    ntk.foreach_po( [&]( auto const& n, auto i ) {
+            if ( ntk.is_constant( ntk.get_node( n ) ) ){
+                out << "\tassign po" << static_cast<uint64_t>( i ) << " = " << ( ntk.is_complemented( n ) ? "1'b1" : "1'b0" ) << ";\n";
+            } else {
+                out << "\tassign po" << static_cast<uint64_t>( i ) << " = n" << static_cast<uint64_t>( n ) << ";\n";
+            }
+    });
+    out << "endmodule\n";
 }
 
 //file version
 template<class Ntk>
-void write_techmapped_verilog( Ntk const& ntk, std::string const& filename, std::unordered_map<int, std::string> cell_names, std::string top_name )
+void write_techmapped_verilog( Ntk const& ntk, std::string const& filename, std::unordered_map<int, std::string> const& cell_names, std::string const& top_name )
 {
       std::ofstream os( filename.c_str(), std::ofstream::out );
       write_techmapped_verilog( ntk, os, cell_names, top_name );
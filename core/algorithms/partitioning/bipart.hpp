@@ -0,0 +1,664 @@
+/*!
+  \file bipart.hpp
+  \brief Deterministic parallel multilevel hypergraph partitioner after BiPart
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace oracle
+{
+
+  struct bipart_params
+  {
+    /*! \brief Number of threads, the partition does not depend on it */
+    unsigned num_threads = std::thread::hardware_concurrency();
+    /*! \brief Allowed excess of a partition over its share of the nodes, as in KaHyPar */
+    double imbalance = 0.5;
+    /*! \brief Coarsening of a bisection stops at this many nodes */
+    uint32_t coarsen_to = 32u;
+    /*! \brief Maximum number of coarsening levels of a bisection */
+    uint32_t max_levels = 25u;
+    /*! \brief Refinement passes after every uncoarsening step */
+    uint32_t refine_iterations = 2u;
+  };
+
+  namespace detail
+  {
+    /* Number of blocks a loop over size items is split into */
+    inline unsigned bipart_blocks( std::size_t size, unsigned num_threads )
+    {
+      constexpr std::size_t min_block = 2048u;
+      return static_cast<unsigned>( std::max<std::size_t>( 1u, std::min<std::size_t>( std::max( num_threads, 1u ), ( size + min_block - 1u ) / min_block ) ) );
+    }
+
+    /* Calls fn( block, begin, end ) for every block of [0, size), one thread per block */
+    template<typename Fn>
+    void bipart_for_blocks( std::size_t size, unsigned num_threads, Fn&& fn )
+    {
+      const unsigned blocks = bipart_blocks( size, num_threads );
+      if ( blocks == 1u )
+      {
+        fn( 0u, std::size_t( 0u ), size );
+        return;
+      }
+      std::vector<std::thread> threads;
+      for ( unsigned b = 1u; b < blocks; b++ )
+        threads.emplace_back( [&, b]() { fn( b, size * b / blocks, size * ( b + 1u ) / blocks ); } );
+      fn( 0u, std::size_t( 0u ), size / blocks );
+      for ( auto& thread : threads )
+        thread.join();
+    }
+
+    template<typename Fn>
+    void bipart_for( std::size_t size, unsigned num_threads, Fn&& fn )
+    {
+      bipart_for_blocks( size, num_threads, [&]( unsigned, std::size_t begin, std::size_t end ) {
+        for ( std::size_t i = begin; i < end; i++ )
+          fn( i );
+      } );
+    }
+
+    inline uint32_t bipart_hash( uint32_t value )
+    {
+      value = ( ( value >> 16 ) ^ value ) * 0x45d9f3bu;
+      value = ( ( value >> 16 ) ^ value ) * 0x45d9f3bu;
+      return ( value >> 16 ) ^ value;
+    }
+
+    /* Hypergraph of one level: hyperedges have at least two distinct pins
+     * and no two hyperedges have the same pins */
+    struct bipart_graph
+    {
+      std::vector<uint32_t> weights;
+      std::vector<std::size_t> offsets{0u};
+      std::vector<uint32_t> pins;
+      std::vector<uint32_t> edge_weights;
+      /* incident hyperedges of every node, built by incidence() */
+      std::vector<std::size_t> node_offsets;
+      std::vector<uint32_t> node_edges;
+
+      uint32_t num_nodes() const
+      {
+        return static_cast<uint32_t>( weights.size() );
+      }
+
+      uint32_t num_edges() const
+      {
+        return static_cast<uint32_t>( offsets.size() - 1u );
+      }
+
+      void incidence()
+      {
+        node_offsets.assign( num_nodes() + 1u, 0u );
+        for ( auto pin : pins )
+          ++node_offsets[pin + 1u];
+        std::partial_sum( node_offsets.begin(), node_offsets.end(), node_offsets.begin() );
+        node_edges.resize( pins.size() );
+        std::vector<std::size_t> cursor( node_offsets.begin(), node_offsets.end() - 1 );
+        for ( uint32_t e = 0u; e < num_edges(); e++ )
+        {
+          for ( auto i = offsets[e]; i < offsets[e + 1u]; i++ )
+            node_edges[cursor[pins[i]]++] = e;
+        }
+      }
+    };
+
+    /* Builds the hypergraph of the nodes mapped by map (-1 drops a node):
+     * pins are renamed, duplicates removed and edges with fewer than two
+     * pins left out. Edges with the same pins are merged into the first of
+     * them, adding up their weights (1 each if edge_weights is empty). Edges
+     * keep their order whatever the number of threads. */
+    template<typename Offsets, typename Pins>
+    bipart_graph bipart_contract( Offsets const& offsets, Pins const& pins, std::size_t num_edges, std::vector<uint32_t> const& edge_weights,
+                                  std::vector<uint32_t> const& map, std::vector<uint32_t> weights, unsigned num_threads )
+    {
+      const unsigned blocks = bipart_blocks( num_edges, num_threads );
+      std::vector<std::vector<std::size_t>> block_sizes( blocks );
+      std::vector<std::vector<uint32_t>> block_pins( blocks ), block_weights( blocks );
+      bipart_for_blocks( num_edges, num_threads, [&]( unsigned b, std::size_t begin, std::size_t end ) {
+        std::vector<uint32_t> edge;
+        for ( std::size_t e = begin; e < end; e++ )
+        {
+          edge.clear();
+          for ( auto i = offsets[e]; i < offsets[e + 1u]; i++ )
+          {
+            const uint32_t pin = map[pins[i]];
+            if ( pin != UINT32_MAX )
+              edge.push_back( pin );
+          }
+          std::sort( edge.begin(), edge.end() );
+          edge.erase( std::unique( edge.begin(), edge.end() ), edge.end() );
+          if ( edge.size() < 2u )
+            continue;
+          block_sizes[b].push_back( edge.size() );
+          block_pins[b].insert( block_pins[b].end(), edge.begin(), edge.end() );
+          block_weights[b].push_back( edge_weights.empty() ? 1u : edge_weights[e] );
+        }
+      } );
+
+      bipart_graph edges;
+      for ( unsigned b = 0u; b < blocks; b++ )
+      {
+        for ( auto size : block_sizes[b] )
+          edges.offsets.push_back( edges.offsets.back() + size );
+        edges.pins.insert( edges.pins.end(), block_pins[b].begin(), block_pins[b].end() );
+        edges.edge_weights.insert( edges.edge_weights.end(), block_weights[b].begin(), block_weights[b].end() );
+      }
+
+      /* edges with the same pins are next to each other when sorted by hash */
+      const uint32_t count = edges.num_edges();
+      std::vector<std::pair<uint64_t, uint32_t>> keys( count );
+      bipart_for( count, num_threads, [&]( std::size_t e ) {
+        uint64_t hash = edges.offsets[e + 1u] - edges.offsets[e];
+        for ( auto i = edges.offsets[e]; i < edges.offsets[e + 1u]; i++ )
+          hash = ( hash ^ edges.pins[i] ) * 0x100000001b3ull;
+        keys[e] = {hash, static_cast<uint32_t>( e )};
+      } );
+      std::sort( keys.begin(), keys.end() );
+      auto same_pins = [&]( uint32_t a, uint32_t b ) {
+        return std::equal( edges.pins.begin() + edges.offsets[a], edges.pins.begin() + edges.offsets[a + 1u],
+                           edges.pins.begin() + edges.offsets[b], edges.pins.begin() + edges.offsets[b + 1u] );
+      };
+      std::vector<uint32_t> merged_into( count );
+      for ( uint32_t i = 0u, first = 0u; i < count; i++ )
+      {
+        if ( i == 0u || keys[i].first != keys[first].first )
+          first = i;
+        const uint32_t e = keys[i].second;
+        merged_into[e] = same_pins( keys[first].second, e ) ? keys[first].second : e;
+        if ( merged_into[e] != e )
+          edges.edge_weights[merged_into[e]] += edges.edge_weights[e];
+      }
+
+      bipart_graph result;
+      result.weights = std::move( weights );
+      for ( uint32_t e = 0u; e < count; e++ )
+      {
+        if ( merged_into[e] != e )
+          continue;
+        result.pins.insert( result.pins.end(), edges.pins.begin() + edges.offsets[e], edges.pins.begin() + edges.offsets[e + 1u] );
+        result.offsets.push_back( result.pins.size() );
+        result.edge_weights.push_back( edges.edge_weights[e] );
+      }
+      result.incidence();
+      return result;
+    }
+
+    /* Multilevel bisection of a hypergraph, see bipart() */
+    class bipart_bisection
+    {
+    public:
+      bipart_bisection( bipart_params const& ps ) : ps( ps ) {}
+
+      /* side of every node, side 0 gets about target0 of the node weight */
+      std::vector<uint8_t> run( bipart_graph const& graph, uint64_t target0, uint64_t max0, uint64_t max1 )
+      {
+        this->max0 = max0;
+        this->max1 = max1;
+
+        /* coarsening */
+        std::vector<bipart_graph> levels;
+        std::vector<std::vector<uint32_t>> maps;
+        levels.reserve( ps.max_levels );
+        bipart_graph const* current = &graph;
+        const uint64_t total = std::accumulate( graph.weights.begin(), graph.weights.end(), uint64_t( 0u ) );
+        const uint32_t max_weight = static_cast<uint32_t>( std::max<uint64_t>( 1u, total / ( 2u * ps.coarsen_to ) ) );
+        while ( levels.size() < ps.max_levels && current->num_nodes() > ps.coarsen_to )
+        {
+          std::vector<uint32_t> map;
+          auto coarse = coarsen( *current, max_weight, map );
+          if ( uint64_t( coarse.num_nodes() ) * 20u > uint64_t( current->num_nodes() ) * 19u )
+            break;
+          maps.push_back( std::move( map ) );
+          levels.push_back( std::move( coarse ) );
+          current = &levels.back();
+        }
+
+        /* initial bisection, then projection and refinement level by level */
+        auto sides = initial( *current, target0 );
+        for ( auto level = levels.size(); level-- > 0u; )
+        {
+          bipart_graph const& fine = level == 0u ? graph : levels[level - 1u];
+          std::vector<uint8_t> fine_sides( fine.num_nodes() );
+          auto const& map = maps[level];
+          bipart_for( fine.num_nodes(), ps.num_threads, [&]( std::size_t v ) { fine_sides[v] = sides[map[v]]; } );
+          sides = std::move( fine_sides );
+          refine( fine, sides );
+        }
+        return sides;
+      }
+
+    private:
+      /* Every node picks its incident hyperedge of highest priority (fewest
+       * pins, then a hash of the edge id), and the nodes that picked the same
+       * hyperedge are merged in index order, up to max_weight per node.
+       * Nodes that end up alone join the cluster of another pin of their
+       * hyperedge, in index order. */
+      bipart_graph coarsen( bipart_graph const& graph, uint32_t max_weight, std::vector<uint32_t>& map )
+      {
+        const uint32_t n = graph.num_nodes();
+        auto priority = [&]( uint32_t e ) {
+          return std::make_tuple( graph.offsets[e + 1u] - graph.offsets[e], bipart_hash( e ), e );
+        };
+        std::vector<uint32_t> choice( n, UINT32_MAX );
+        bipart_for( n, ps.num_threads, [&]( std::size_t v ) {
+          for ( auto i = graph.node_offsets[v]; i < graph.node_offsets[v + 1u]; i++ )
+          {
+            const uint32_t e = graph.node_edges[i];
+            if ( choice[v] == UINT32_MAX || priority( e ) < priority( choice[v] ) )
+              choice[v] = e;
+          }
+        } );
+
+        /* nodes grouped by choice, in index order within every group */
+        std::vector<std::size_t> group_offsets( graph.num_edges() + 2u, 0u );
+        for ( uint32_t v = 0u; v < n; v++ )
+          ++group_offsets[( choice[v] == UINT32_MAX ? graph.num_edges() : choice[v] ) + 1u];
+        std::partial_sum( group_offsets.begin(), group_offsets.end(), group_offsets.begin() );
+        std::vector<uint32_t> groups( n );
+        {
+          std::vector<std::size_t> cursor( group_offsets.begin(), group_offsets.end() - 1 );
+          for ( uint32_t v = 0u; v < n; v++ )
+            groups[cursor[choice[v] == UINT32_MAX ? graph.num_edges() : choice[v]]++] = v;
+        }
+
+        /* representative of every node: the first node of its cluster */
+        std::vector<uint32_t> leader( n );
+        bipart_for( graph.num_edges() + 1u, ps.num_threads, [&]( std::size_t g ) {
+          uint64_t weight = 0u;
+          uint32_t first = UINT32_MAX;
+          for ( auto i = group_offsets[g]; i < group_offsets[g + 1u]; i++ )
+          {
+            const uint32_t v = groups[i];
+            if ( first == UINT32_MAX || weight + graph.weights[v] > max_weight )
+            {
+              first = v;
+              weight = 0u;
+            }
+            weight += graph.weights[v];
+            leader[v] = first;
+          }
+        } );
+
+        /* nodes left alone join the cluster of a pin of their hyperedge */
+        std::vector<uint64_t> cluster_weights( n, 0u );
+        for ( uint32_t v = 0u; v < n; v++ )
+          cluster_weights[leader[v]] += graph.weights[v];
+        auto alone = [&]( uint32_t v ) {
+          return choice[v] != UINT32_MAX && leader[v] == v && cluster_weights[v] == graph.weights[v];
+        };
+        for ( uint32_t v = 0u; v < n; v++ )
+        {
+          if ( !alone( v ) )
+            continue;
+          for ( auto i = graph.offsets[choice[v]]; i < graph.offsets[choice[v] + 1u]; i++ )
+          {
+            const uint32_t u = graph.pins[i];
+            if ( u != v && !alone( u ) && cluster_weights[leader[u]] + graph.weights[v] <= max_weight )
+            {
+              leader[v] = leader[u];
+              cluster_weights[leader[u]] += graph.weights[v];
+              cluster_weights[v] = 0u;
+              break;
+            }
+          }
+        }
+
+        map.assign( n, UINT32_MAX );
+        std::vector<uint32_t> weights;
+        for ( uint32_t v = 0u; v < n; v++ )
+        {
+          if ( map[leader[v]] == UINT32_MAX )
+          {
+            map[leader[v]] = static_cast<uint32_t>( weights.size() );
+            weights.push_back( 0u );
+          }
+          map[v] = map[leader[v]];
+          weights[map[v]] += graph.weights[v];
+        }
+        return bipart_contract( graph.offsets, graph.pins, graph.num_edges(), graph.edge_weights, map, std::move( weights ), ps.num_threads );
+      }
+
+      /* pins of every hyperedge on side 1 */
+      void count_pins( bipart_graph const& graph, std::vector<uint8_t> const& sides )
+      {
+        ones.resize( graph.num_edges() );
+        bipart_for( graph.num_edges(), ps.num_threads, [&]( std::size_t e ) {
+          uint32_t count = 0u;
+          for ( auto i = graph.offsets[e]; i < graph.offsets[e + 1u]; i++ )
+            count += sides[graph.pins[i]];
+          ones[e] = count;
+        } );
+      }
+
+      /* reduction of the cut when node v changes side, from count_pins() */
+      int64_t gain( bipart_graph const& graph, std::vector<uint8_t> const& sides, uint32_t v ) const
+      {
+        int64_t result = 0;
+        for ( auto i = graph.node_offsets[v]; i < graph.node_offsets[v + 1u]; i++ )
+        {
+          const uint32_t e = graph.node_edges[i];
+          const std::size_t size = graph.offsets[e + 1u] - graph.offsets[e];
+          const std::size_t same = sides[v] ? ones[e] : size - ones[e];
+          if ( same == size )
+            result -= graph.edge_weights[e];
+          else if ( same == 1u )
+            result += graph.edge_weights[e];
+        }
+        return result;
+      }
+
+      void compute_gains( bipart_graph const& graph, std::vector<uint8_t> const& sides )
+      {
+        count_pins( graph, sides );
+        gains.resize( graph.num_nodes() );
+        bipart_for( graph.num_nodes(), ps.num_threads, [&]( std::size_t v ) { gains[v] = gain( graph, sides, static_cast<uint32_t>( v ) ); } );
+      }
+
+      /* nodes of one side, best gain first and by index on ties */
+      std::vector<uint32_t> candidates( bipart_graph const& graph, std::vector<uint8_t> const& sides, uint8_t side, bool positive ) const
+      {
+        std::vector<uint32_t> result;
+        for ( uint32_t v = 0u; v < graph.num_nodes(); v++ )
+        {
+          if ( sides[v] == side && ( !positive || gains[v] > 0 ) )
+            result.push_back( v );
+        }
+        std::sort( result.begin(), result.end(), [&]( uint32_t a, uint32_t b ) {
+          return gains[a] != gains[b] ? gains[a] > gains[b] : a < b;
+        } );
+        return result;
+      }
+
+      /* Bisection of the coarsest hypergraph. Small ones are grown from a
+       * few seed nodes spread over the indices, one node at a time, and the
+       * growth with the smallest cut after refinement is kept. */
+      std::vector<uint8_t> initial( bipart_graph const& graph, uint64_t target0 )
+      {
+        const uint32_t n = graph.num_nodes();
+        if ( n > initial_growth_limit )
+        {
+          const std::size_t batch = std::max<std::size_t>( static_cast<std::size_t>( std::sqrt( n ) ), n / 100u );
+          auto sides = grow( graph, target0, UINT32_MAX, batch );
+          refine( graph, sides );
+          return sides;
+        }
+
+        std::vector<uint8_t> best;
+        uint64_t best_cut = UINT64_MAX;
+        const uint32_t trials = std::min( n, initial_trials );
+        for ( uint32_t trial = 0u; trial < trials; trial++ )
+        {
+          auto sides = grow( graph, target0, static_cast<uint32_t>( uint64_t( trial ) * n / trials ), 1u );
+          refine( graph, sides );
+          const uint64_t trial_cut = cut( graph, sides );
+          if ( trial_cut < best_cut )
+          {
+            best_cut = trial_cut;
+            best = std::move( sides );
+          }
+        }
+        return best;
+      }
+
+      /* Everything but the seed starts on side 1; the nodes of highest gain
+       * are moved to side 0 in batches, with gains recomputed after every
+       * batch, until side 0 has its share of the weight. */
+      std::vector<uint8_t> grow( bipart_graph const& graph, uint64_t target0, uint32_t seed, std::size_t batch )
+      {
+        std::vector<uint8_t> sides( graph.num_nodes(), 1u );
+        uint64_t weight0 = 0u;
+        if ( seed != UINT32_MAX && graph.weights[seed] <= max0 )
+        {
+          sides[seed] = 0u;
+          weight0 += graph.weights[seed];
+        }
+        if ( batch == 1u )
+        {
+          /* one node at a time, with the gains around every move updated */
+          compute_gains( graph, sides );
+          while ( weight0 < target0 )
+          {
+            uint32_t best = UINT32_MAX;
+            for ( uint32_t v = 0u; v < graph.num_nodes(); v++ )
+            {
+              if ( sides[v] == 1u && weight0 + graph.weights[v] <= max0 && ( best == UINT32_MAX || gains[v] > gains[best] ) )
+                best = v;
+            }
+            if ( best == UINT32_MAX )
+              break;
+            sides[best] = 0u;
+            weight0 += graph.weights[best];
+            for ( auto i = graph.node_offsets[best]; i < graph.node_offsets[best + 1u]; i++ )
+              --ones[graph.node_edges[i]];
+            for ( auto i = graph.node_offsets[best]; i < graph.node_offsets[best + 1u]; i++ )
+            {
+              const uint32_t e = graph.node_edges[i];
+              for ( auto j = graph.offsets[e]; j < graph.offsets[e + 1u]; j++ )
+                gains[graph.pins[j]] = gain( graph, sides, graph.pins[j] );
+            }
+          }
+          return sides;
+        }
+
+        while ( weight0 < target0 )
+        {
+          compute_gains( graph, sides );
+          std::size_t moved = 0u;
+          for ( auto v : candidates( graph, sides, 1u, false ) )
+          {
+            if ( moved == batch || weight0 >= target0 )
+              break;
+            if ( weight0 + graph.weights[v] > max0 )
+              continue;
+            sides[v] = 0u;
+            weight0 += graph.weights[v];
+            ++moved;
+          }
+          if ( moved == 0u )
+            break;
+        }
+        return sides;
+      }
+
+      uint64_t cut( bipart_graph const& graph, std::vector<uint8_t> const& sides )
+      {
+        count_pins( graph, sides );
+        uint64_t result = 0u;
+        for ( uint32_t e = 0u; e < graph.num_edges(); e++ )
+          result += ones[e] != 0u && ones[e] != graph.offsets[e + 1u] - graph.offsets[e] ? graph.edge_weights[e] : 0u;
+        return result;
+      }
+
+      /* Gains are computed for all nodes in parallel and the nodes of
+       * positive gain are then moved best first. A move is only made if its
+       * gain, updated by the moves before it, is still positive and the other
+       * side stays within its bound, so every pass reduces the cut. The
+       * heavier side is then brought back within its bound. */
+      void refine( bipart_graph const& graph, std::vector<uint8_t>& sides )
+      {
+        uint64_t weight[2] = {0u, 0u};
+        for ( uint32_t v = 0u; v < graph.num_nodes(); v++ )
+          weight[sides[v]] += graph.weights[v];
+        const uint64_t bound[2] = {max0, max1};
+
+        for ( uint32_t iteration = 0u; iteration < ps.refine_iterations; iteration++ )
+        {
+          compute_gains( graph, sides );
+          auto moves = candidates( graph, sides, 0u, true );
+          const auto from1 = candidates( graph, sides, 1u, true );
+          const auto middle = moves.size();
+          moves.insert( moves.end(), from1.begin(), from1.end() );
+          std::inplace_merge( moves.begin(), moves.begin() + middle, moves.end(), [&]( uint32_t a, uint32_t b ) {
+            return gains[a] != gains[b] ? gains[a] > gains[b] : a < b;
+          } );
+
+          std::size_t moved = 0u;
+          for ( auto v : moves )
+          {
+            const uint8_t side = sides[v];
+            if ( weight[!side] + graph.weights[v] > bound[!side] || gain( graph, sides, v ) <= 0 )
+              continue;
+            for ( auto i = graph.node_offsets[v]; i < graph.node_offsets[v + 1u]; i++ )
+              side ? --ones[graph.node_edges[i]] : ++ones[graph.node_edges[i]];
+            sides[v] = !side;
+            weight[side] -= graph.weights[v];
+            weight[!side] += graph.weights[v];
+            ++moved;
+          }
+          if ( moved == 0u )
+            break;
+        }
+        rebalance( graph, sides );
+      }
+
+      void rebalance( bipart_graph const& graph, std::vector<uint8_t>& sides )
+      {
+        uint64_t weight[2] = {0u, 0u};
+        for ( uint32_t v = 0u; v < graph.num_nodes(); v++ )
+          weight[sides[v]] += graph.weights[v];
+        const uint64_t bound[2] = {max0, max1};
+        for ( uint8_t side = 0u; side < 2u; side++ )
+        {
+          if ( weight[side] <= bound[side] )
+            continue;
+          compute_gains( graph, sides );
+          for ( auto v : candidates( graph, sides, side, false ) )
+          {
+            if ( weight[side] <= bound[side] )
+              break;
+            if ( weight[!side] + graph.weights[v] > bound[!side] )
+              continue;
+            sides[v] = !side;
+            weight[side] -= graph.weights[v];
+            weight[!side] += graph.weights[v];
+          }
+        }
+      }
+
+      static constexpr uint32_t initial_growth_limit = 1024u;
+      static constexpr uint32_t initial_trials = 8u;
+
+      bipart_params const& ps;
+      uint64_t max0 = 0u, max1 = 0u;
+      std::vector<uint32_t> ones;
+      std::vector<int64_t> gains;
+    };
+
+    /* Splits the nodes in ids (numbered as in graph) into num_parts parts
+     * starting at first_part, by bisection into halves of the parts */
+    inline void bipart_recursive( bipart_graph const& graph, std::vector<uint32_t> const& ids, uint32_t num_parts, uint32_t first_part,
+                                  double epsilon, bipart_params const& ps, std::vector<uint32_t>& partition )
+    {
+      if ( num_parts == 1u || graph.num_nodes() == 0u )
+      {
+        for ( auto id : ids )
+          partition[id] = first_part;
+        return;
+      }
+
+      const uint32_t parts0 = num_parts / 2u;
+      const uint64_t total = std::accumulate( graph.weights.begin(), graph.weights.end(), uint64_t( 0u ) );
+      const uint64_t target0 = total * parts0 / num_parts;
+      const uint64_t max0 = static_cast<uint64_t>( std::ceil( target0 * ( 1.0 + epsilon ) ) );
+      const uint64_t max1 = static_cast<uint64_t>( std::ceil( ( total - target0 ) * ( 1.0 + epsilon ) ) );
+      const auto sides = bipart_bisection( ps ).run( graph, target0, max0, max1 );
+
+      for ( uint8_t side = 0u; side < 2u; side++ )
+      {
+        std::vector<uint32_t> map( graph.num_nodes(), UINT32_MAX );
+        std::vector<uint32_t> sub_ids, weights;
+        for ( uint32_t v = 0u; v < graph.num_nodes(); v++ )
+        {
+          if ( sides[v] != side )
+            continue;
+          map[v] = static_cast<uint32_t>( sub_ids.size() );
+          sub_ids.push_back( ids[v] );
+          weights.push_back( graph.weights[v] );
+        }
+        const auto sub = bipart_contract( graph.offsets, graph.pins, graph.num_edges(), graph.edge_weights, map, std::move( weights ), ps.num_threads );
+        bipart_recursive( sub, sub_ids, side ? num_parts - parts0 : parts0, side ? first_part + parts0 : first_part, epsilon, ps, partition );
+      }
+    }
+  } /* namespace detail */
+
+  /*! \brief Partitions a hypergraph into num_parts parts of about equal size
+   *
+   * The hypergraph is given in compressed sparse row form: the pins of
+   * hyperedge i are pins[offsets[i]] ... pins[offsets[i + 1] - 1], as built by
+   * oracle::hypergraph. The result holds the part of every vertex.
+   *
+   * Follows BiPart (Maleki et al., IPDPS 2021): parts are split by recursive
+   * bisection, and every bisection is multilevel. Coarsening merges the nodes
+   * that choose the same hyperedge. Refinement moves the nodes of positive
+   * gain one at a time, best first, as long as their gain is still positive
+   * and the other side stays within its bound, and then moves nodes off a
+   * side that is still too heavy. All parallel steps compute one value per
+   * node or hyperedge and every tie is broken by index, so the partition is
+   * the same for any number of threads.
+   */
+  inline std::vector<uint32_t> bipart( uint32_t num_vertices, std::vector<std::size_t> const& offsets, std::vector<uint32_t> const& pins,
+                                       uint32_t num_parts, bipart_params const& ps = {} )
+  {
+    std::vector<uint32_t> partition( num_vertices, 0u );
+    if ( num_parts <= 1u || num_vertices == 0u )
+      return partition;
+
+    std::vector<uint32_t> ids( num_vertices );
+    std::iota( ids.begin(), ids.end(), 0u );
+    const std::size_t num_edges = offsets.empty() ? 0u : offsets.size() - 1u;
+    const auto graph = detail::bipart_contract( offsets, pins, num_edges, {}, ids, std::vector<uint32_t>( num_vertices, 1u ), ps.num_threads );
+
+    /* the imbalance is spread over the levels of bisection */
+    const double levels = std::ceil( std::log2( num_parts ) );
+    const double epsilon = std::pow( 1.0 + ps.imbalance, 1.0 / levels ) - 1.0;
+    detail::bipart_recursive( graph, ids, num_parts, 0u, epsilon, ps, partition );
+    return partition;
+  }
+
+  /*! \brief Connectivity of a partition: the sum over all hyperedges of the number of parts they span minus one */
+  inline uint64_t hypergraph_km1( std::vector<std::size_t> const& offsets, std::vector<uint32_t> const& pins, std::vector<uint32_t> const& partition )
+  {
+    uint64_t result = 0u;
+    std::vector<uint32_t> parts;
+    for ( std::size_t e = 0u; e + 1u < offsets.size(); e++ )
+    {
+      parts.clear();
+      for ( auto i = offsets[e]; i < offsets[e + 1u]; i++ )
+        parts.push_back( partition[pins[i]] );
+      if ( parts.empty() )
+        continue;
+      std::sort( parts.begin(), parts.end() );
+      result += std::unique( parts.begin(), parts.end() ) - parts.begin() - 1u;
+    }
+    return result;
+  }
+
+  /*! \brief Number of hyperedges with pins in more than one part */
+  inline uint64_t hypergraph_cut( std::vector<std::size_t> const& offsets, std::vector<uint32_t> const& pins, std::vector<uint32_t> const& partition )
+  {
+    uint64_t result = 0u;
+    for ( std::size_t e = 0u; e + 1u < offsets.size(); e++ )
+    {
+      for ( auto i = offsets[e] + 1u; i < offsets[e + 1u]; i++ )
+      {
+        if ( partition[pins[i]] != partition[pins[offsets[e]]] )
+        {
+          ++result;
+          break;
+        }
+      }
+    }
+    return result;
+  }
+
+} /* namespace oracle */
@@ -37,6 +37,7 @@
 #include <vector>
 #include <set>
 #include <cassert>
+#include <memory>
 
 #include <mockturtle/traits.hpp>
 #include "partition_view.hpp"
@@ -48,8 +49,77 @@
 namespace oracle
 {
 
+  /*! \brief Fanouts of every node of a network
+   *
+   * Computed once in a single pass over the gates and shared by all clusters
+   * grown on the same network. Like mockturtle::fanout_view, every gate is
+   * listed once among the fanouts of each of its fanins.
+   */
   template<typename Ntk>
-  class cluster : public Ntk
+  class fanout_index
+  {
+  public:
+    using node = typename Ntk::node;
+
+  public:
+    explicit fanout_index( Ntk const& ntk ) : ntk( ntk )
+    {
+      offsets.assign( ntk.size() + 1, 0u );
+      ntk.foreach_gate( [&]( auto n ){
+        foreach_unique_fanin( n, [&]( node fanin ){
+          offsets[ntk.node_to_index( fanin ) + 1]++;
+        });
+      });
+      for( uint32_t i = 0; i < ntk.size(); i++ ){
+        offsets[i + 1] += offsets[i];
+      }
+      fanouts.resize( offsets.back() );
+      std::vector<uint32_t> cursor( offsets.begin(), offsets.end() - 1 );
+      ntk.foreach_gate( [&]( auto n ){
+        foreach_unique_fanin( n, [&]( node fanin ){
+          fanouts[cursor[ntk.node_to_index( fanin )]++] = n;
+        });
+      });
+    }
+
+    template<typename Fn>
+    void foreach_fanout( node n, Fn&& fn ) const
+    {
+      const auto index = ntk.node_to_index( n );
+      for( auto i = offsets[index]; i < offsets[index + 1]; i++ ){
+        fn( fanouts[i] );
+      }
+    }
+
+    /*! \brief Calls fn once for every distinct fanin node of n */
+    template<typename Fn>
+    void foreach_unique_fanin( node n, Fn&& fn ) const
+    {
+      std::vector<node> seen;
+      ntk.foreach_fanin( n, [&]( auto const& f ){
+        const node fanin = ntk.get_node( f );
+        if( std::find( seen.begin(), seen.end(), fanin ) == seen.end() ){
+          seen.push_back( fanin );
+          fn( fanin );
+        }
+      });
+    }
+
+  private:
+    Ntk const& ntk;
+    std::vector<uint32_t> offsets;
+    std::vector<node> fanouts;
+  };
+
+  /*! \brief A set of nodes grown one node at a time
+   *
+   * The outputs (fanouts outside the cluster), inputs (fanins outside the
+   * cluster) and the number of connections between every node and the
+   * cluster are kept up to date as nodes are added, so adding a node only
+   * costs time proportional to its number of fanins and fanouts.
+   */
+  template<typename Ntk>
+  class cluster
   {
   public:
     using storage = typename Ntk::storage;
@@ -57,174 +127,121 @@ namespace oracle
     using signal = typename Ntk::signal;
 
   public:
-    cluster(){}
+    explicit cluster( Ntk const& ntk ) : cluster( std::make_shared<const fanout_index<Ntk>>( ntk ) ){}
 
-    cluster( Ntk const& ntk ) : Ntk( ntk ){}
+    explicit cluster( std::shared_ptr<const fanout_index<Ntk>> fanouts ) : fanouts( fanouts ){}
 
-    int size(){
+    int size() const {
       return nodes.size();
     }
 
-    int num_int_nodes(){
+    int num_int_nodes() const {
       return nodes.size() - inputs.size();
     }
 
-    int num_pis(){
+    int num_pis() const {
       return inputs.size();
     }
 
-    int num_pos(){
+    int num_pos() const {
       return outputs.size();
     }
 
-    std::set<node> get_cluster(){
+    std::set<node> const& get_cluster() const {
       return nodes;
     }
 
-    std::set<node> get_inputs(){
+    std::set<node> const& get_inputs() const {
       return inputs;
     }
 
-    std::set<node> get_outputs(){
+    std::set<node> const& get_outputs() const {
       return outputs;
     }
 
-    void add_to_cluster( Ntk const& ntk, std::vector<node> nodes2add ){
-
-      for(int i = 0; i < nodes2add.size(); i++){
-        node node2add = nodes2add.at(i);
-        nodes.insert(node2add);
-      
-        auto start = std::chrono::high_resolution_clock::now();
-        if(outputs.find(node2add) != outputs.end()){
-          outputs.erase(node2add);
-        }
-        if(inputs.find(node2add) != inputs.end()){
-          inputs.erase(node2add);
-        }
-        mockturtle::fanout_view fanout{ntk};
-        fanout.foreach_fanout(node2add, [&](const auto& p){
-          if(nodes.find(p) == nodes.end() && outputs.find(p) == outputs.end()){
-            outputs.insert(p);
-          }
-        });
-        ntk.foreach_fanin(node2add, [&](auto conn, auto i){
-          node fanin = ntk.get_node(conn);
-          if(nodes.find(fanin) == nodes.end() && inputs.find(fanin) == inputs.end()){
-            inputs.insert(fanin);
-          }
-        });
-        auto stop = std::chrono::high_resolution_clock::now();
-        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(stop - start);
-        // std::cout << "Updating IO: " << duration.count() << "us\n";
-      }
-      
+    bool contains( node n ) const {
+      return nodes.find( n ) != nodes.end();
     }
 
-    int num_intersec( Ntk const& ntk, node node2add ){
-      int num_intersec_nets = 0;
-      mockturtle::fanout_view fanout{ntk};
-      fanout.foreach_fanout(node2add, [&](const auto& p){
-        if(nodes.find(p) != nodes.end()){
-          num_intersec_nets++;
-        }
+    void add_to_cluster( Ntk const& ntk, node node2add ){
+      if( !nodes.insert( node2add ).second )
+        return;
+      outputs.erase( node2add );
+      inputs.erase( node2add );
+
+      fanouts->foreach_fanout( node2add, [&]( node p ){
+        ntk.foreach_fanin( p, [&]( auto const& f ){
+          if( ntk.get_node( f ) == node2add )
+            intersec[p]++;
+        });
+        if( !contains( p ) )
+          outputs.insert( p );
       });
-      ntk.foreach_fanin(node2add, [&](auto conn, auto i){
-        node fanin = ntk.get_node(conn);
-        if(nodes.find(fanin) != nodes.end()){
-          num_intersec_nets++;
-        }
+      fanouts->foreach_unique_fanin( node2add, [&]( node fanin ){
+        intersec[fanin]++;
+        if( !contains( fanin ) )
+          inputs.insert( fanin );
       });
+    }
 
-      return num_intersec_nets;
+    void add_to_cluster( Ntk const& ntk, std::vector<node> const& nodes2add ){
+      for( node node2add : nodes2add ){
+        add_to_cluster( ntk, node2add );
+      }
     }
 
-    int num_intersec( Ntk const& ntk, node output, std::vector<node> inputs ){
+    /*! \brief Number of fanouts and fanin connections of node2add inside the cluster */
+    int num_intersec( node node2add ) const {
+      const auto it = intersec.find( node2add );
+      return it == intersec.end() ? 0 : it->second;
+    }
+
+    int num_intersec( Ntk const& ntk, node output, std::vector<node> const& inputs ) const {
       int num_intersec_nets = 0;
-      mockturtle::fanout_view fanout{ntk};
-      fanout.foreach_fanout(output, [&](const auto& p){
-        if(nodes.find(p) != nodes.end()){
+      fanouts->foreach_fanout( output, [&]( node p ){
+        if( contains( p ) ){
           num_intersec_nets++;
         }
       });
-      for(int i = 0; i < inputs.size(); i++){
-        node curr_input = inputs.at(i);
-        ntk.foreach_fanin(curr_input, [&](auto conn, auto ){
-          node fanin = ntk.get_node(conn);
-          if(nodes.find(fanin) != nodes.end()){
+      for( node curr_input : inputs ){
+        ntk.foreach_fanin( curr_input, [&]( auto conn, auto ){
+          if( contains( ntk.get_node( conn ) ) ){
             num_intersec_nets++;
           }
         });
       }
-      
       return num_intersec_nets;
     }
 
-    std::set<node> get_conn_nodes( Ntk const& ntk, std::set<node> nodes2part ){
+    /*! \brief Inputs and outputs of the cluster that are in nodes2part */
+    std::set<node> get_conn_nodes( Ntk const& ntk, std::set<node> const& nodes2part ) const {
       std::set<node> connected_nodes;
-      mockturtle::fanout_view fanout{ntk};
       for( node curr_output : outputs ){
-        // std::cout << "fanout = " << curr_output << "\n";
-        if(nodes.find(curr_output) == nodes.end() && nodes2part.find(curr_output) != nodes2part.end()){
-          connected_nodes.insert(curr_output);
+        if( nodes2part.find( curr_output ) != nodes2part.end() ){
+          connected_nodes.insert( curr_output );
         }
-        // fanout.foreach_fanout( curr_output, [&](const auto& p){
-        //   std::cout << "fanout = " << p << "\n";
-        //   if(nodes.find(p) == nodes.end() && nodes2part.find(p) != nodes2part.end())
-        //     connected_nodes.insert(p);
-        // });
       }
-
       for( node curr_input : inputs ){
-        // std::cout << "fanin = " << curr_input << "\n";
-        if(nodes.find(curr_input) == nodes.end() && nodes2part.find(curr_input) != nodes2part.end()){
-          connected_nodes.insert(curr_input);
+        if( nodes2part.find( curr_input ) != nodes2part.end() ){
+          connected_nodes.insert( curr_input );
         }
       }
-
       return connected_nodes;
     }
-    
+
+    /*! \brief Calls fn for every node whose connections to the cluster change when n is added */
+    template<typename Fn>
+    void foreach_neighbor( node n, Fn&& fn ) const {
+      fanouts->foreach_fanout( n, fn );
+      fanouts->foreach_unique_fanin( n, fn );
+    }
+
   private:
-    
+    std::shared_ptr<const fanout_index<Ntk>> fanouts;
+
     std::set<node> nodes{};
     std::set<node> inputs{};
     std::set<node> outputs{};
-
-    void update_io( Ntk const& ntk ){
-      inputs.clear();
-      outputs.clear();
-      for( node curr_node : nodes ){
-        if(ntk.is_pi(curr_node) && inputs.find(curr_node) == inputs.end()){
-          inputs.insert(curr_node);
-        }
-        if(ntk.is_po(curr_node) && outputs.find(curr_node) == outputs.end()){
-          outputs.insert(curr_node);
-        }
-        mockturtle::fanout_view fanout{ntk};
-        fanout.foreach_fanout(curr_node, [&](const auto& p){
-          if(nodes.find(p) == nodes.end() && outputs.find(p) == outputs.end()){
-            outputs.insert(curr_node);
-          }
-        });
-        ntk.foreach_fanin(curr_node, [&](auto conn, auto i){
-          node fanin = ntk.get_node(conn);
-          if(nodes.find(fanin) == nodes.end() && inputs.find(fanin) == inputs.end()){
-            inputs.insert(fanin);
-          }
-        });
-      }
-      // std::cout << "inputs = {";
-      // for( node curr_input : inputs ){
-      //   std::cout << curr_input << " ";
-      // }
-      // std::cout << "}\n";
-      // std::cout << "output = {";
-      // for( node curr_output : outputs ){
-      //   std::cout << curr_output << " ";
-      // }
-      // std::cout << "}\n";
-    }
-
+    std::unordered_map<node, int> intersec;
   };
 } /* namespace oracle */
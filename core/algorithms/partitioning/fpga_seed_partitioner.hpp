@@ -38,12 +38,17 @@
 #include <set>
 #include <cassert>
 #include <limits>
+#include <map>
+#include <memory>
 
 #include <mockturtle/traits.hpp>
 #include <mockturtle/networks/detail/foreach.hpp>
 #include <mockturtle/views/fanout_view.hpp>
 #include <libkahypar.h>
 
+#include "cluster.hpp"
+#include "timing_engine.hpp"
+
 namespace oracle
 {
 
@@ -62,7 +67,8 @@ namespace oracle
     fpga_seed_partitioner(){}
 
 
-    fpga_seed_partitioner( Ntk const& ntk, double nd, double mn, int pi_const, int node_count_const ) : Ntk( ntk ), _arr( ntk ), _req_arr( ntk )
+    /*! \brief Partitions ntk, listing the nodes of every partition when verbose is set */
+    fpga_seed_partitioner( Ntk const& ntk, double nd, double mn, int pi_const, int node_count_const, bool verbose = false ) : Ntk( ntk ), timing( ntk )
     {
 
       static_assert( mockturtle::is_network_type_v<Ntk>, "Ntk is not a network type" );
@@ -76,27 +82,7 @@ namespace oracle
       net_delay = nd;
       max_net = mn;
 
-      mockturtle::topo_view top_view{ntk};
-      std::vector<node> top_nodes = top_view.get_node_vec();
-      /*************
-      Determine Dmax for each PO
-      *************/
-      mockturtle::depth_view ntk_depth{ntk};
-      ntk.foreach_node([&](auto node){
-        _arr[node] = ntk_depth.level(node);
-        if(ntk.is_po(node)){
-          if(_arr[node] > dmax){
-            dmax = _arr[node];
-            rmax = _arr[node];
-          } 
-        }
-      });
-
-      get_required_arrival(ntk);
-
-      ntk.foreach_po([&](auto po){
-        _req_arr[ntk.get_node(po)] = rmax;
-      });
+      fanouts = std::make_shared<const fanout_index<Ntk>>(ntk);
       /*************
       Determine slack fro each node
       store max slack value
@@ -104,7 +90,6 @@ namespace oracle
       *************/
       ntk.foreach_node([&](auto node){
         int curr_slack = slack(node);
-        std::cout << "Node = " << node << " with slack = " << curr_slack << "\n";
         if(curr_slack > max_slack)
           max_slack = curr_slack;
         if(!ntk.is_constant(node) && !ntk.is_pi(node))
@@ -114,119 +99,56 @@ namespace oracle
       /*************
       Determine seed
       *************/
-      mockturtle::fanout_view fanout{ntk};
+      ntk.foreach_gate([&](auto curr_node){
+        if(nodes2part.find(curr_node) != nodes2part.end())
+          seeds.emplace(-connection_crit(curr_node), curr_node);
+      });
+
       while(true){
 
         if(nodes2part.size() == 0)
           break; 
 
-        cluster<Ntk> curr_cluster(ntk);
-
-        auto start = std::chrono::high_resolution_clock::now();
-
-        node seed = find_seed(ntk);
+        cluster<Ntk> curr_cluster(fanouts);
 
-        auto stop = std::chrono::high_resolution_clock::now();
-        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(stop - start);
+        node seed = find_seed();
 
-        std::cout << "Finding seed: " << duration.count() << "us\n";
-        // std::cout << "first seed = " << seed << "\n";
-        curr_cluster.add_to_cluster(ntk, seed);
-        // std::cout << "erasing " << seed << "\n";
-        nodes2part.erase(seed);
+        /* nodes connected to the cluster that are still to be partitioned,
+         * bucketed by their number of connections to the cluster */
+        gain_buckets candidates;
+        add_to_cluster(ntk, curr_cluster, candidates, seed);
         while(true){
 
           if((curr_cluster.num_pis() >= pi_const && curr_cluster.size() >= node_count_const) || nodes2part.size() == 0)
             break;
-          
-          start = std::chrono::high_resolution_clock::now();
-          std::set<node> connected_nodes = curr_cluster.get_conn_nodes(ntk, nodes2part);
-          stop = std::chrono::high_resolution_clock::now();
-          duration = std::chrono::duration_cast<std::chrono::microseconds>(stop - start);
-          std::cout << "Finding all connected nodes: " << duration.count() << "us\n";
-
-          // std::cout << "cluster size = " << curr_cluster.size() << "\n";
-          // std::cout << "number of cluster internal nodes = " << curr_cluster.num_int_nodes() << "\n";
-          // std::cout << "number of cluster inputs = " << curr_cluster.num_pis() << "\n";
-          // std::cout << "number of connected nodes = " << connected_nodes.size() << "\n";
-          // std::cout << "number of nodes to part = " << nodes2part.size() << "\n";
-          if(connected_nodes.size() == 0)
+          if(candidates.empty())
             break;
-          node best_node;
-          double best_attr = -1.0;
-          auto start1 = std::chrono::high_resolution_clock::now();
-          for( node curr_node : connected_nodes ){
-            start = std::chrono::high_resolution_clock::now();
-            double curr_attr = attraction(ntk, curr_node, curr_cluster);
-            stop = std::chrono::high_resolution_clock::now();
-            duration = std::chrono::duration_cast<std::chrono::microseconds>(stop - start);
-            // std::cout << "Determining attraction: " << duration.count() << "us\n";
-            // std::cout << "curr_node = " << curr_node << " with attraction = " << curr_attr << "\n";
-            if( curr_attr > best_attr ){
-              best_attr = curr_attr;
-              best_node = curr_node;
-            }
-            
-          }
-          // mapped_part[best_node] = num_partitions;
-          curr_cluster.add_to_cluster(ntk, best_node);
-          // std::cout << "erasing " << best_node << "\n";
-          nodes2part.erase(best_node);
-          auto stop1 = std::chrono::high_resolution_clock::now();
-          auto duration1 = std::chrono::duration_cast<std::chrono::microseconds>(stop1 - start1);
-          std::cout << "Finding best node to add: " << duration1.count() << "us\n";
-          // std::cout << "done connected nodes\n";
+
+          add_to_cluster(ntk, curr_cluster, candidates, candidates.best(*this));
         }
-        std::set<node> curr_cluster_nodes = curr_cluster.get_cluster();
-        // std::set<node> curr_cluster_outputs = curr_cluster.get_outputs();
-        std::set<node> curr_cluster_inputs = curr_cluster.get_inputs();
-        std::cout << "Partition " << num_partitions << " = {";
+        std::set<node> const& curr_cluster_nodes = curr_cluster.get_cluster();
+        std::set<node> const& curr_cluster_inputs = curr_cluster.get_inputs();
+        if(verbose)
+          std::cout << "Partition " << num_partitions << " = {";
         for(node curr_node : curr_cluster_nodes ){
-          std::cout << curr_node << " ";
+          if(verbose)
+            std::cout << curr_node << " ";
           mapped_part[curr_node] = num_partitions;
         }
-        std::cout << "}\n";
-        // std::cout << "Inputs = {";
+        if(verbose)
+          std::cout << "}\n";
         for(node curr_input : curr_cluster_inputs){
-          // std::cout << curr_input << " ";
           if(ntk.is_pi(curr_input))
             mapped_part[curr_input] = num_partitions;
         } 
-        // std::cout << "}\n";
-        // std::cout << "Outputs = {";
-        // for(node curr_output : curr_cluster_outputs){
-        //   std::cout << curr_output << " ";
-        //   // mapped_part[curr_output] = num_partitions;
-        // } 
-        // std::cout << "}\n";
         num_partitions++;
       }
       std::cout << "Number of partitions = " << num_partitions << "\n";
 
     }
 
-    void get_required_arrival( Ntk const& ntk ){
-
-      std::map<node, int> level;
-      ntk.foreach_node([&](auto node){
-        level[node] = 0;
-      });
-      mockturtle::topo_view top_view{ntk};
-      mockturtle::fanout_view fanout{ntk};
-      std::vector<node> top_nodes = top_view.get_node_vec();
-      std::reverse(top_nodes.begin(), top_nodes.end());
-      for(int i = 0; i < top_nodes.size(); i++){
-        node curr_node = top_nodes.at(i);
-        fanout.foreach_fanout(curr_node, [&](const auto& p){
-          if(level[curr_node] < level[p] + 1)
-            level[curr_node] = level[p] + 1;
-        });
-        _req_arr[curr_node] = dmax - level[curr_node];
-      }
-    }
-
     int slack( node curr_node ){
-      return _req_arr[curr_node] - _arr[curr_node];
+      return timing.slack(curr_node);
     }
 
     double connection_crit( node curr_node ){
@@ -234,27 +156,23 @@ namespace oracle
       return 1.0 - (double(curr_slack) / double(max_slack));
     }
 
-    double attraction( Ntk const& ntk, node curr_node, cluster<Ntk> curr_cluster ){
+    double attraction( node curr_node, cluster<Ntk> const& curr_cluster ){
+
+      int net_intersec = curr_cluster.num_intersec(curr_node);
 
-      int net_intersec = curr_cluster.num_intersec(ntk, curr_node);
+      return attraction(curr_node, net_intersec);
+    }
 
+    double attraction( node curr_node, int net_intersec ){
       return net_delay * connection_crit(curr_node) + (1 - net_delay) * net_intersec / max_net;
     }
 
-    node find_seed(Ntk const& ntk){
-      double max_crit = 0.0;
-      node seed;
-      ntk.foreach_gate([&]( auto curr_node ){
-        if(nodes2part.find(curr_node) != nodes2part.end()){
-          double conn_crit = connection_crit(curr_node);
-          std::cout << "Node = " << curr_node << " with conn crit = " << conn_crit << "\n";
-          if(conn_crit > max_crit){
-            max_crit = conn_crit;
-            seed = curr_node;
-          }
-        }
-      });
-      return seed;
+    /* The most critical gate that is still to be partitioned, lowest index first */
+    node find_seed(){
+      while(!seeds.empty() && nodes2part.find(seeds.begin()->second) == nodes2part.end()){
+        seeds.erase(seeds.begin());
+      }
+      return seeds.empty() ? *nodes2part.begin() : seeds.begin()->second;
     }
 
     partition_manager<Ntk> create_part_man(Ntk const& ntk){
@@ -264,18 +182,75 @@ namespace oracle
 
   private:
 
+    /* Candidate nodes of a cluster grouped by their number of connections to
+     * it. Within a bucket the nodes are ordered by decreasing delay term of
+     * their attraction and then by index, so only the first node of every
+     * bucket has to be scored to find the most attractive candidate. */
+    class gain_buckets{
+    public:
+      bool empty() const {
+        return buckets.empty();
+      }
+
+      void update(node n, int gain, double delay_term){
+        erase(n);
+        gains[n] = gain;
+        buckets[gain].emplace(-delay_term, n);
+        delay_terms[n] = delay_term;
+      }
+
+      void erase(node n){
+        const auto it = gains.find(n);
+        if(it == gains.end())
+          return;
+        auto bucket = buckets.find(it->second);
+        bucket->second.erase({-delay_terms[n], n});
+        if(bucket->second.empty())
+          buckets.erase(bucket);
+        gains.erase(it);
+      }
+
+      node best(fpga_seed_partitioner& partitioner) const {
+        node best_node = buckets.begin()->second.begin()->second;
+        double best_attr = -1.0;
+        for(auto const& [gain, bucket] : buckets){
+          const node curr_node = bucket.begin()->second;
+          const double curr_attr = partitioner.attraction(curr_node, gain);
+          if(curr_attr > best_attr || (curr_attr == best_attr && curr_node < best_node)){
+            best_attr = curr_attr;
+            best_node = curr_node;
+          }
+        }
+        return best_node;
+      }
+
+    private:
+      std::map<int, std::set<std::pair<double, node>>> buckets;
+      std::unordered_map<node, int> gains;
+      std::unordered_map<node, double> delay_terms;
+    };
+
+    void add_to_cluster(Ntk const& ntk, cluster<Ntk>& curr_cluster, gain_buckets& candidates, node node2add){
+      curr_cluster.add_to_cluster(ntk, node2add);
+      nodes2part.erase(node2add);
+      candidates.erase(node2add);
+      curr_cluster.foreach_neighbor(node2add, [&](node n){
+        if(!curr_cluster.contains(n) && nodes2part.find(n) != nodes2part.end())
+          candidates.update(n, curr_cluster.num_intersec(n), net_delay * connection_crit(n));
+      });
+    }
+
     int num_partitions = 0;
     std::map<node, int> mapped_part;
     double max_net = 0.0;
     double net_delay = 0.0;
 
-    mockturtle::node_map<uint32_t, Ntk> _req_arr;
-    mockturtle::node_map<uint32_t, Ntk> _arr;
-    int dmax = 0;
-    int rmax = std::numeric_limits<int>::max();
+    timing_engine<Ntk> timing;
     int max_slack = 0;
 
     std::set<node> nodes2part;
+    std::set<std::pair<double, node>> seeds;
+    std::shared_ptr<const fanout_index<Ntk>> fanouts;
 
   };
 } /* namespace oracle */
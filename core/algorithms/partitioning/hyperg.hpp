@@ -5,17 +5,31 @@
 
 #pragma once
 #include <stdio.h>
+#include <algorithm>
+#include <charconv>
+#include <fstream>
+#include <future>
+#include <limits>
+#include <string>
+#include <vector>
 #include <mockturtle/traits.hpp>
 
 namespace oracle {
 
+  /*! \brief Hypergraph of a network in compressed sparse row form
+   *
+   * Every node with connections becomes one hyperedge made of the node
+   * itself followed by its fanouts (or by its fanins when the node is a
+   * primary output). The pins of hyperedge i are
+   * pins[offsets[i]] ... pins[offsets[i + 1] - 1], which is the layout
+   * KaHyPar and hMETIS expect, so both arrays can be handed to them as is.
+   */
   template<class Ntk>
   class hypergraph {
 
     Ntk const& ntk;
-    std::vector<std::vector<uint32_t>> hyperEdges;
-    std::set<typename Ntk::node> nodes;
-    std::vector<uint32_t> connections;
+    std::vector<size_t> offsets;
+    std::vector<uint32_t> pins;
 
   public:
     hypergraph(Ntk const& ntk) : ntk(ntk) {};
@@ -26,113 +40,169 @@ namespace oracle {
       static_assert(mockturtle::has_foreach_fanin_v<Ntk>, "Ntk does not implement the foreach_fanin method");
       static_assert(mockturtle::has_size_v<Ntk>, "Ntk does not implement the size method");
 
-      //fanout view to iterate over fanouts and generate hyper edges
-      mockturtle::fanout_view fanout{ntk};
+      const uint32_t no_fanouts = std::numeric_limits<uint32_t>::max();
+      offsets.clear();
+      pins.clear();
+
+      //Counting pass: number of distinct gate fanouts of every node, as a fanout_view would list them
+      std::vector<uint32_t> cursor(ntk.size(), 0u);
+      size_t num_fanouts = 0;
+      ntk.foreach_gate([&](auto node) {
+        foreach_distinct_fanin(node, [&](uint32_t child) {
+          cursor[child]++;
+          num_fanouts++;
+        });
+      });
 
-      //Remove all children indeces from nodes so that the only connections remaining are outputs
+      //Layout pass: place every hyperedge and reserve room for the fanouts of non-PO nodes
+      pins.reserve(ntk.size() + num_fanouts);
+      offsets.push_back(0);
       ntk.foreach_node([&](auto node) {
-        nodes.clear();
-
-        //clear vector connections here
-        connections.clear();
-
-        int nodeNdx = ntk.node_to_index(node);
+        uint32_t nodeNdx = ntk.node_to_index(node);
+        uint32_t node_fanouts = cursor[nodeNdx];
+        cursor[nodeNdx] = no_fanouts;
 
         if(!ntk.is_po(node)) {
-          fanout.foreach_fanout(node, [&](const auto &p) {
-            nodes.insert(p);
-          });
-
-          for (auto it : nodes) {
-            connections.push_back(ntk.node_to_index(it));
+          if(node_fanouts > 0) {
+            pins.push_back(nodeNdx);
+            cursor[nodeNdx] = pins.size();
+            pins.resize(pins.size() + node_fanouts);
+            offsets.push_back(pins.size());
           }
         }
 
-        else if (ntk.is_po(node) && !ntk.is_ro(node)) {
+        else if (!ntk.is_ro(node)) {
+          size_t root = pins.size();
+          pins.push_back(nodeNdx);
           ntk.foreach_fanin(node, [&](auto const &conn, auto i) {
-            connections.push_back(ntk._storage->nodes[node].children[i].index);
+            pins.push_back(ntk._storage->nodes[node].children[i].index);
           });
+          if(pins.size() > root + 1)
+            offsets.push_back(pins.size());
+          else
+            pins.pop_back();
         }
+      });
 
-        if (connections.size() > 0) {
-          std::vector<uint32_t> connection_to_add = connections;
-          //Add root node to the hyper edge
-          connection_to_add.insert(connection_to_add.begin(), nodeNdx);
-          hyperEdges.push_back(connection_to_add);
-        }
+      //Fill pass: gates are visited in index order, so every fanout list comes out sorted
+      ntk.foreach_gate([&](auto node) {
+        uint32_t nodeNdx = ntk.node_to_index(node);
+        foreach_distinct_fanin(node, [&](uint32_t child) {
+          if(cursor[child] != no_fanouts)
+            pins[cursor[child]++] = nodeNdx;
+        });
       });
     }
 
-    void dump( std::string filename = "hypergraph.txt" ) {
-      std::ofstream myfile;
-      myfile.open (filename);
-      myfile << hyperEdges.size() << " " << ntk.size()-1 << "\n";
-      for (int i = 0; i < hyperEdges.size(); i++) {
-        for (int j = 0; j < hyperEdges.at(i).size(); j++) {
-          connections.push_back(hyperEdges.at(i).at(j) );
-          myfile << hyperEdges.at(i).at(j) << " ";
+    /*! \brief Writes the hypergraph to filename in hMETIS format
+     *
+     * The text is formatted into a large buffer that is written out in
+     * blocks, instead of going through one stream insertion per pin.
+     * Returns false if the file could not be written.
+     */
+    bool dump( std::string filename = "hypergraph.txt" ) const {
+      std::ofstream myfile(filename, std::ios::out | std::ios::trunc);
+      if(!myfile.is_open())
+        return false;
+
+      std::vector<char> buffer(dump_buffer_size);
+      size_t used = 0;
+      auto flush = [&]() {
+        myfile.write(buffer.data(), used);
+        used = 0;
+      };
+      auto put_number = [&](uint64_t value, char separator) {
+        if(used + 24 > buffer.size())
+          flush();
+        used = std::to_chars(buffer.data() + used, buffer.data() + buffer.size(), value).ptr - buffer.data();
+        buffer[used++] = separator;
+      };
+
+      put_number(get_num_edges(), ' ');
+      put_number(ntk.size() - 1, '\n');
+      for (size_t i = 0; i + 1 < offsets.size(); i++) {
+        for (size_t j = offsets[i]; j < offsets[i + 1]; j++) {
+          put_number(pins[j], ' ');
         }
-        myfile << "\n";
+        if(used == buffer.size())
+          flush();
+        buffer[used++] = '\n';
       }
+      flush();
+      myfile.close();
+      return !myfile.fail();
+    }
+
+    /*! \brief Writes the hypergraph on a background thread
+     *
+     * The hypergraph is only read while it is written, so it can be handed
+     * to a partitioner at the same time. It must stay alive until the
+     * returned future is ready.
+     */
+    std::future<bool> dump_async( std::string filename ) const {
+      return std::async(std::launch::async, [this, filename]() {
+        return dump(filename);
+      });
     }
 
     void return_hyperedges(std::vector<uint32_t> &connections) {
-      for (int i = 0; i < hyperEdges.size(); i++) {
-        for (int j = 0; j < hyperEdges.at(i).size(); j++) {
-          connections.push_back(hyperEdges.at(i).at(j) );
-        }
-      }
+      connections.insert(connections.end(), pins.begin(), pins.end());
     }
 
-    // void return_hyperedges_set(std::unordered_set<std::unordered_set<uint32_t>> &connections) {
-    //   for (int i = 0; i < hyperEdges.size(); i++) {
-    //     std::unordered_set<uint32_t> temp_edge;
-    //     for (int j = 0; j < hyperEdges.at(i).size(); j++) {
-    //       temp_edge.insert(hyperEdges.at(i).at(j) );
-    //     }
-    //     connections.insert(temp_edge);
-    //   }
-    // }
-
-    int get_num_edges() {
-      return hyperEdges.size();
+    int get_num_edges() const {
+      return offsets.empty() ? 0 : offsets.size() - 1;
     }
 
-    int get_num_vertices() {
+    int get_num_vertices() const {
       return ntk.size();
     }
 
-    uint32_t get_num_indeces() {
-      uint32_t count = 0;
-
-      for (int i = 0; i < hyperEdges.size(); i++) {
-        //sum up the number of elements of each vector of vector -1 (the index of the given vector in the vector)
-        count += hyperEdges.at(i).size();
-      }
-      return count;
+    uint32_t get_num_indeces() const {
+      return pins.size();
     }
 
-    uint64_t get_num_sets() {
-      return hyperEdges.size();
+    uint64_t get_num_sets() const {
+      return get_num_edges();
     }
 
     std::vector<std::vector<uint32_t>> get_hyperedges() {
+      std::vector<std::vector<uint32_t>> hyperEdges;
+      for (size_t i = 0; i + 1 < offsets.size(); i++) {
+        hyperEdges.emplace_back(pins.begin() + offsets[i], pins.begin() + offsets[i + 1]);
+      }
       return hyperEdges;
     }
 
     void get_indeces(std::vector<unsigned long> &indeces) {
-      unsigned long count = 0;
-      for (int i = 0; i < hyperEdges.size(); i++) {
-        if (i == 0) {
-          indeces.push_back((unsigned long) (0));
-        } else {
-          count += (hyperEdges.at(i - 1).size());
-          indeces.push_back(count);
+      indeces.insert(indeces.end(), offsets.begin(), offsets.end());
+    }
+
+    //Start of every hyperedge in get_pins(), followed by the total number of pins
+    std::vector<size_t> const& get_offsets() const {
+      return offsets;
+    }
+
+    std::vector<uint32_t> const& get_pins() const {
+      return pins;
+    }
+
+  private:
+
+    //Calls fn once for every distinct fanin node of a gate
+    template<typename Fn>
+    void foreach_distinct_fanin(typename Ntk::node const& node, Fn&& fn) {
+      fanins.clear();
+      ntk.foreach_fanin(node, [&](auto const &conn) {
+        uint32_t child = ntk.node_to_index(ntk.get_node(conn));
+        if(std::find(fanins.begin(), fanins.end(), child) == fanins.end()) {
+          fanins.push_back(child);
+          fn(child);
         }
-      }
-      int last_index = hyperEdges.size()-1;
-      count += (hyperEdges.at(last_index).size());
-      indeces.push_back(count);
+      });
     }
+
+    std::vector<uint32_t> fanins;
+
+    static constexpr size_t dump_buffer_size = 1u << 22;
   };
-} //end of namespace
\ No newline at end of file
+} //end of namespace
@@ -0,0 +1,178 @@
+/*!
+  \file partition_lists.hpp
+  \brief Dense per-partition node lists used by the partition manager
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace oracle
+{
+
+  /*! \brief Sorted node lists of all partitions in compressed sparse row form
+   *
+   * The nodes of list p are stored as node indices in
+   * nodes[offsets[p]] ... nodes[offsets[p + 1] - 1], sorted and without
+   * duplicates. Entries are collected with add() and laid out once by
+   * finalize(). Lists replaced afterwards with assign() or shortened by
+   * rename() (which only happens when partitions are combined) are kept on
+   * the side so that the dense arrays never have to move.
+   */
+  class partition_lists
+  {
+  public:
+    class range
+    {
+    public:
+      range() = default;
+      range( uint32_t const* first, uint32_t const* last ) : first( first ), last( last ) {}
+
+      uint32_t const* begin() const { return first; }
+      uint32_t const* end() const { return last; }
+      std::size_t size() const { return last - first; }
+      bool empty() const { return first == last; }
+
+    private:
+      uint32_t const* first = nullptr;
+      uint32_t const* last = nullptr;
+    };
+
+    partition_lists() = default;
+
+    explicit partition_lists( uint32_t num_lists ) : num_lists( num_lists ) {}
+
+    void add( uint32_t list, uint32_t index )
+    {
+      if ( list >= num_lists )
+        num_lists = list + 1;
+      entries.emplace_back( list, index );
+    }
+
+    /*! \brief Lays out all added entries, sorted and deduplicated per list */
+    void finalize()
+    {
+      offsets.assign( num_lists + 1, 0u );
+      for ( auto const& e : entries )
+        offsets[e.first + 1]++;
+      for ( uint32_t i = 0; i < num_lists; i++ )
+        offsets[i + 1] += offsets[i];
+
+      nodes.resize( entries.size() );
+      std::vector<uint64_t> cursor( offsets.begin(), offsets.end() - 1 );
+      for ( auto const& e : entries )
+        nodes[cursor[e.first]++] = e.second;
+      std::vector<std::pair<uint32_t, uint32_t>>().swap( entries );
+
+      /* sort every list and drop duplicates, compacting the array in place */
+      uint64_t out = 0;
+      for ( uint32_t i = 0; i < num_lists; i++ )
+      {
+        auto first = nodes.begin() + offsets[i];
+        auto last = nodes.begin() + offsets[i + 1];
+        std::sort( first, last );
+        last = std::unique( first, last );
+        offsets[i] = out;
+        out = std::move( first, last, nodes.begin() + out ) - nodes.begin();
+      }
+      offsets[num_lists] = out;
+      nodes.resize( out );
+      nodes.shrink_to_fit();
+    }
+
+    uint32_t size() const
+    {
+      return num_lists;
+    }
+
+    range get( uint32_t list ) const
+    {
+      if ( !replaced.empty() )
+      {
+        if ( const auto it = replaced.find( list ); it != replaced.end() )
+          return range( it->second.data(), it->second.data() + it->second.size() );
+      }
+      if ( list >= num_lists || offsets.empty() )
+        return range();
+      return range( nodes.data() + offsets[list], nodes.data() + offsets[list + 1] );
+    }
+
+    bool contains( uint32_t list, uint32_t index ) const
+    {
+      const auto r = get( list );
+      return std::binary_search( r.begin(), r.end(), index );
+    }
+
+    /*! \brief Replaces a whole list */
+    template<typename Nodes>
+    void assign( uint32_t list, Nodes const& new_nodes )
+    {
+      std::vector<uint32_t> sorted( new_nodes.begin(), new_nodes.end() );
+      std::sort( sorted.begin(), sorted.end() );
+      sorted.erase( std::unique( sorted.begin(), sorted.end() ), sorted.end() );
+      replaced[list] = std::move( sorted );
+    }
+
+    /*! \brief Renames from to to in a list, keeping it sorted and without duplicates
+     *
+     * Dense lists are renamed in place. A list that already contains to
+     * becomes shorter and is moved to the replaced lists instead.
+     */
+    void rename( uint32_t list, uint32_t from, uint32_t to )
+    {
+      if ( from == to )
+        return;
+      if ( const auto it = replaced.find( list ); it != replaced.end() )
+      {
+        auto& v = it->second;
+        const auto pos = std::lower_bound( v.begin(), v.end(), from );
+        if ( pos == v.end() || *pos != from )
+          return;
+        if ( std::binary_search( v.begin(), v.end(), to ) )
+          v.erase( pos );
+        else
+        {
+          *pos = to;
+          std::sort( v.begin(), v.end() );
+        }
+        return;
+      }
+      if ( list >= num_lists || offsets.empty() )
+        return;
+      auto first = nodes.begin() + offsets[list];
+      auto last = nodes.begin() + offsets[list + 1];
+      const auto pos = std::lower_bound( first, last, from );
+      if ( pos == last || *pos != from )
+        return;
+      if ( std::binary_search( first, last, to ) )
+      {
+        std::vector<uint32_t> renamed( first, pos );
+        renamed.insert( renamed.end(), pos + 1, last );
+        replaced[list] = std::move( renamed );
+        return;
+      }
+      *pos = to;
+      std::sort( first, last );
+    }
+
+    template<typename Node>
+    std::set<Node> to_set( uint32_t list ) const
+    {
+      const auto r = get( list );
+      return std::set<Node>( r.begin(), r.end() );
+    }
+
+  private:
+    uint32_t num_lists = 0;
+    std::vector<uint64_t> offsets;
+    std::vector<uint32_t> nodes;
+    std::vector<std::pair<uint32_t, uint32_t>> entries;
+    std::unordered_map<uint32_t, std::vector<uint32_t>> replaced;
+  };
+
+} /* namespace oracle */
@@ -38,10 +38,15 @@
 #include <set>
 #include <cassert>
 #include <queue>
+#include <future>
+#include <string>
+#include <thread>
 
 #include <mockturtle/traits.hpp>
 #include "partition_view.hpp"
 #include "hyperg.hpp"
+#include "bipart.hpp"
+#include "partition_lists.hpp"
 #include <mockturtle/networks/detail/foreach.hpp>
 #include <mockturtle/views/fanout_view.hpp>
 #include <libkahypar.h>
@@ -49,8 +54,57 @@
 namespace oracle
 {
 
+  /*! \brief Hypergraph partitioner used by partition_manager */
+  enum class partition_engine
+  {
+    kahypar, /* KaHyPar with a configuration file, single threaded */
+    bipart   /* oracle::bipart, parallel and deterministic */
+  };
+
+  /*! \brief Reads "kahypar" or "bipart"; returns false for any other name */
+  inline bool parse_partition_engine( std::string const& name, partition_engine& engine )
+  {
+    if ( name == "kahypar" )
+      engine = partition_engine::kahypar;
+    else if ( name == "bipart" )
+      engine = partition_engine::bipart;
+    else
+      return false;
+    return true;
+  }
+
+  /*! \brief Partitions a hypergraph in CSR form (see hypergraph) with KaHyPar
+   *
+   * All hyperedges weigh the same and parts may exceed their share of the
+   * vertices by imbalance. The arrays are handed to KaHyPar without copying.
+   */
+  inline std::vector<uint32_t> partition_kahypar( uint32_t num_vertices, std::vector<size_t> const& offsets, std::vector<uint32_t> const& pins,
+                                                  uint32_t num_parts, std::string const& config_direc, double imbalance = 0.5 )
+  {
+    kahypar_context_t* context = kahypar_context_new();
+    kahypar_configure_context_from_file(context, config_direc.c_str());
+
+    static_assert(std::is_same_v<kahypar_hyperedge_id_t, uint32_t>, "hypergraph pins do not match kahypar ids");
+    const kahypar_hyperedge_id_t num_hyperedges = offsets.empty() ? 0u : offsets.size() - 1u;
+    std::vector<kahypar_hyperedge_weight_t> hyperedge_weights(num_hyperedges, 2);
+    kahypar_hyperedge_weight_t objective = 0;
+    std::vector<kahypar_partition_id_t> partition(num_vertices, -1);
+
+    kahypar_partition(num_vertices, num_hyperedges,
+                      imbalance, num_parts, nullptr, hyperedge_weights.data(),
+                      offsets.data(), pins.data(),
+                      &objective, context, partition.data());
+
+    kahypar_context_free(context);
+    return std::vector<uint32_t>(partition.begin(), partition.end());
+  }
+
   /*! \brief Partitions circuit using multi-level hypergraph partitioner
    *
+   * Partition membership is kept in dense, index-based form: a vector mapping
+   * every node to its partition, and sorted per-partition node lists (see
+   * partition_lists) for the scope, inputs, outputs and registers of each
+   * partition.
    */
   template<typename Ntk>
   class partition_manager : public Ntk
@@ -59,70 +113,103 @@ namespace oracle
     using storage = typename Ntk::storage;
     using node = typename Ntk::node;
     using signal = typename Ntk::signal;
+    using node_range = partition_lists::range;
+
+    template<typename> friend class partition_manager;
 
   public:
     partition_manager(){}
 
-    partition_manager(Ntk& ntk, std::map<node, int> partition, int part_num){
+    partition_manager(Ntk const& ntk, std::map<node, int> const& partition, int part_num)
+      : partition_manager(ntk, dense_partition(ntk, partition), part_num) {}
+
+    /*! \brief Builds the partitions from a node index to partition map */
+    partition_manager(Ntk const& ntk, std::vector<uint32_t> const& partition, int part_num){
       num_partitions = part_num;
-      for(int i = 0; i < part_num; ++i)
-        _part_scope.push_back(std::set<node>());
+      _node_partition.assign(ntk.size(), 0u);
+      std::copy_n(partition.begin(), std::min<std::size_t>(partition.size(), ntk.size()), _node_partition.begin());
+
+      const std::vector<bool> po_nodes = primary_output_nodes(ntk);
+      partition_lists scope(part_num), inputs(part_num), outputs(part_num);
 
       ntk.foreach_node( [&](auto curr_node){
+        const uint32_t nodeIdx = ntk.node_to_index(curr_node);
+        const uint32_t curr_part = _node_partition[nodeIdx];
+
         //get rid of circuit PIs
         if (ntk.is_pi(curr_node) ) {
-          _part_scope[partition[curr_node]].insert(curr_node);
-          _part_pis.insert(std::pair<int, node>(partition[curr_node], curr_node));
+          scope.add(curr_part, nodeIdx);
+          inputs.add(curr_part, nodeIdx);
         }
 
         if (ntk.is_ro(curr_node) && !ntk.is_constant(curr_node)) {
-          _part_scope[partition[curr_node]].insert(curr_node);
-          _part_pis.insert(std::pair<int, node>(partition[curr_node], curr_node));
-          if(ntk.is_po(curr_node) && !ntk.is_constant(curr_node)){
-            _part_pos.insert(std::pair<int, node>(partition[curr_node], curr_node));
+          scope.add(curr_part, nodeIdx);
+          inputs.add(curr_part, nodeIdx);
+          if(po_nodes[nodeIdx]){
+            outputs.add(curr_part, nodeIdx);
           }
         }
         //get rid of circuit POs
-        else if (ntk.is_po(curr_node) && !ntk.is_constant(curr_node)) {
-          _part_scope[partition[curr_node]].insert(curr_node);
-          _part_pos.insert(std::pair<int, node>(partition[curr_node], curr_node));
+        else if (po_nodes[nodeIdx] && !ntk.is_constant(curr_node)) {
+          scope.add(curr_part, nodeIdx);
+          outputs.add(curr_part, nodeIdx);
         }
         else if (!ntk.is_constant(curr_node)) {
-          _part_scope[partition[curr_node]].insert(curr_node);
+          scope.add(curr_part, nodeIdx);
         }
 
         //look to partition inputs (those that are not circuit PIs)
         if (!ntk.is_pi(curr_node) && !ntk.is_ro(curr_node)){
           ntk.foreach_fanin(curr_node, [&](auto const &conn, auto j) {
-            if (partition[ntk.index_to_node(conn.index)] != partition[curr_node] && !ntk.is_constant(ntk.index_to_node(conn.index))) {
-              _part_scope[partition[curr_node]].insert(curr_node);
-              _part_pis.insert(std::pair<int, node>(partition[curr_node], ntk.index_to_node(conn.index)));
-              _part_pos.insert(std::pair<int, node>(partition[ntk.index_to_node(conn.index)],ntk.index_to_node(conn.index)));
-              
+            const uint32_t childIdx = conn.index;
+            if (_node_partition[childIdx] != curr_part && !ntk.is_constant(ntk.index_to_node(childIdx))) {
+              scope.add(curr_part, nodeIdx);
+              inputs.add(curr_part, childIdx);
+              outputs.add(_node_partition[childIdx], childIdx);
             }
           });
         }
       });
-      for(int i = 0; i < part_num; i++){
-        partitionInputs[i] = create_part_inputs(i);
-        typename std::set<node>::iterator it;
-        partitionOutputs[i] = create_part_outputs(i);
-        update_io(i);
-      }
+
+      scope.finalize();
+      inputs.finalize();
+      outputs.finalize();
+      _part_scope = std::move(scope);
+      partitionInputs = std::move(inputs);
+      partitionOutputs = std::move(outputs);
+      update_io();
     }
 
-    partition_manager(Ntk& ntk, std::vector<std::set<node>> scope, std::unordered_map<int, std::set<node>> inputs, 
-      std::unordered_map<int, std::set<node>> outputs, std::unordered_map<int, std::set<node>> regs, std::unordered_map<int, std::set<node>> regs_in, int part_num){
+    partition_manager(Ntk& ntk, std::vector<std::set<node>> const& scope, std::unordered_map<int, std::set<node>> const& inputs, 
+      std::unordered_map<int, std::set<node>> const& outputs, std::unordered_map<int, std::set<node>> const& regs, std::unordered_map<int, std::set<node>> const& regs_in, int part_num){
 
       num_partitions = part_num;
-      _part_scope = scope;
-      partitionInputs = inputs;
-      partitionOutputs = outputs;
-      partitionReg = regs;
-      partitionRegIn = regs_in;
+      for(uint32_t i = 0; i < scope.size(); i++){
+        for(auto const& n : scope[i]){
+          const uint32_t nodeIdx = ntk.node_to_index(n);
+          if(nodeIdx >= _node_partition.size())
+            _node_partition.resize(nodeIdx + 1, 0u);
+          _node_partition[nodeIdx] = i;
+          _part_scope.add(i, nodeIdx);
+        }
+      }
+      _part_scope.finalize();
+      partitionInputs = to_lists(inputs);
+      partitionOutputs = to_lists(outputs);
+      partitionReg = to_lists(regs);
+      partitionRegIn = to_lists(regs_in);
     }
 
-    partition_manager( Ntk& ntk, int part_num, std::string config_direc="../../core/test.ini" ) : Ntk( ntk )
+    /*! \brief Takes over the partitions of a manager built on another network with the same node indices */
+    template<typename OtherNtk>
+    partition_manager([[maybe_unused]] Ntk& ntk, partition_manager<OtherNtk> const& other)
+      : num_partitions(other.num_partitions), _node_partition(other._node_partition), _part_scope(other._part_scope),
+        partitionOutputs(other.partitionOutputs), partitionInputs(other.partitionInputs),
+        partitionReg(other.partitionReg), partitionRegIn(other.partitionRegIn) {}
+
+    /*! \brief Partitions ntk into part_num parts with KaHyPar (using config_direc) or BiPart (using num_threads) */
+    partition_manager( Ntk& ntk, int part_num, std::string config_direc="../../core/test.ini", std::string hypergraph_file="",
+                       partition_engine engine = partition_engine::kahypar, unsigned num_threads = std::thread::hardware_concurrency() ) : Ntk( ntk )
     {
       static_assert( mockturtle::is_network_type_v<Ntk>, "Ntk is not a network type" );
       static_assert( mockturtle::has_set_visited_v<Ntk>, "Ntk does not implement the set_visited method" );
@@ -134,149 +221,163 @@ namespace oracle
 
       num_partitions = part_num;
 
-      for(int i = 0; i<part_num; ++i)
-        _part_scope.push_back(std::set<node>());
+      partition_lists scope(part_num), inputs(part_num), outputs(part_num), regs(part_num), regs_in(part_num);
       
       if(part_num == 1){
+        _node_partition.assign(ntk.size(), 0u);
         ntk.foreach_pi( [&](auto pi){
-          _part_scope[0].insert(ntk.index_to_node(pi));
-          _part_pis.insert(std::pair<int, node>(0, ntk.index_to_node(pi)));
+          scope.add(0, ntk.node_to_index(pi));
+          inputs.add(0, ntk.node_to_index(pi));
         });
         ntk.foreach_po( [&](auto po){
-          _part_scope[0].insert(ntk.index_to_node(po.index));
-          _part_pos.insert(std::pair<int, node>(0, ntk.index_to_node(po.index)));
-
+          scope.add(0, po.index);
+          outputs.add(0, po.index);
         });
         ntk.foreach_gate( [&](auto curr_node){
-          _part_scope[0].insert(curr_node);
-          _part_nodes[curr_node] = 0;
+          scope.add(0, ntk.node_to_index(curr_node));
         });
-
-        for(int i = 0; i < part_num; i++){
-          partitionInputs[i] = create_part_inputs(i);
-          partitionOutputs[i] = create_part_outputs(i);
-          partitionReg[i] = create_part_latches(i);
-          partitionRegIn[i] = create_part_latches_in(i);
-        }
       }
 
       else{
-        uint32_t kahyp_num_hyperedges = 0;
-        uint32_t kahyp_num_vertices = 0;
-        uint32_t kahyp_num_indeces_hyper = 0;
-        unsigned long kahyp_num_sets = 0;
-        std::vector<uint32_t> kahypar_connections;
-        std::vector<unsigned long> kahyp_set_indeces;
-
         /******************
         Generate HyperGraph
         ******************/
 
         hypergraph<Ntk> t(ntk);
         t.get_hypergraph(ntk);
-        t.return_hyperedges(kahypar_connections);
-        kahyp_num_hyperedges = t.get_num_edges();
-        kahyp_num_vertices = t.get_num_vertices();
-        kahyp_num_indeces_hyper = t.get_num_indeces();
-        kahyp_num_sets = t.get_num_sets();
-        t.get_indeces(kahyp_set_indeces);
-        t.dump();
+
+        //the hypergraph is only written out on request, overlapped with partitioning
+        std::future<bool> hypergraph_dump;
+        if(!hypergraph_file.empty())
+          hypergraph_dump = t.dump_async(hypergraph_file);
 
         /******************
-        Partition with kahypar
+        Partition with kahypar or bipart
         ******************/
-        //configures kahypar
-        kahypar_context_t* context = kahypar_context_new();
-        kahypar_configure_context_from_file(context, config_direc.c_str());
-
-        //set number of hyperedges and vertices. These variables are defined by the hyperG command
-        const kahypar_hyperedge_id_t num_hyperedges = kahyp_num_hyperedges;
-        const kahypar_hypernode_id_t num_vertices = kahyp_num_vertices;
-
-        //set all edges to have the same weight
-        std::unique_ptr<kahypar_hyperedge_weight_t[]> hyperedge_weights = std::make_unique<kahypar_hyperedge_weight_t[]>(kahyp_num_vertices);
-
-        for( int i = 0; i < kahyp_num_vertices; i++ )
-          hyperedge_weights[i] = 2;
-
-        //vector with indeces where each set starts
-        std::unique_ptr<size_t[]> hyperedge_indices = std::make_unique<size_t[]>(kahyp_num_sets+1);
-
-        for ( int j = 0; j < kahyp_num_sets+1; j++){
-          hyperedge_indices[j] = kahyp_set_indeces[j];
+        std::vector<uint32_t> partition;
+        if(engine == partition_engine::bipart){
+          bipart_params ps;
+          ps.num_threads = num_threads;
+          partition = bipart(t.get_num_vertices(), t.get_offsets(), t.get_pins(), part_num, ps);
         }
-
-        std::unique_ptr<kahypar_hyperedge_id_t[]> hyperedges = std::make_unique<kahypar_hyperedge_id_t[]>(kahyp_num_indeces_hyper);
-
-        for ( int i = 0; i < kahyp_num_indeces_hyper; i++){
-          hyperedges[i] = kahypar_connections[i];
+        else{
+          partition = partition_kahypar(t.get_num_vertices(), t.get_offsets(), t.get_pins(), part_num, config_direc);
         }
 
-        const double imbalance = 0.5;
-        const kahypar_partition_id_t k = part_num;
-
-        kahypar_hyperedge_weight_t objective = 0;
-
-        std::vector<kahypar_partition_id_t> partition(num_vertices, -1);
+        if(hypergraph_dump.valid()){
+          if(hypergraph_dump.get())
+            std::cout << "Hypergraph written to " << hypergraph_file << "\n";
+          else
+            std::cout << "Unable to write hypergraph to " << hypergraph_file << "\n";
+        }
 
-        kahypar_partition(num_vertices, num_hyperedges,
-                          imbalance, k, nullptr, hyperedge_weights.get(),
-                          hyperedge_indices.get(), hyperedges.get(),
-                          &objective, context, partition.data());
+        _node_partition = partition;
 
-        for(auto i=1; i <= ntk.num_pis(); i++){
-          if(i<=ntk.num_pis()-ntk.num_latches()){
-            _part_pis.insert(std::pair<int, node>(partition[i], ntk.index_to_node(i)));
-          }
-          else {
-            _part_pis.insert(std::pair<int, node>(partition[i], ntk.index_to_node(i)));
-            _part_ros.insert(std::pair<int, node>(partition[i], ntk.index_to_node(i)));
+        for(uint32_t i=1; i <= ntk.num_pis(); i++){
+          inputs.add(partition[i], i);
+          if(i>ntk.num_pis()-ntk.num_latches()){
+            regs.add(partition[i], i);
           }
         }
         
         ntk.foreach_node( [&](auto curr_node){
+          const uint32_t nodeIdx = ntk.node_to_index(curr_node);
           if (!ntk.is_constant(curr_node)) {
-            _part_scope[partition[ntk.node_to_index(curr_node)]].insert(curr_node);
+            scope.add(partition[nodeIdx], nodeIdx);
           }
 
           //look to partition inputs (those that are not circuit PIs)
           if (!ntk.is_pi(curr_node) && !ntk.is_ro(curr_node)){
             ntk.foreach_fanin(curr_node, [&](auto const &conn, auto j) {
-              if (partition[conn.index] != partition[ntk.node_to_index(curr_node)] && !ntk.is_constant(ntk.index_to_node(conn.index))) {
-                _part_scope[partition[ntk.node_to_index(curr_node)]].insert(curr_node);
-                _part_pis.insert(std::pair<int, node>(partition[ntk.node_to_index(curr_node)], ntk.index_to_node(conn.index)));
-                _part_pos.insert(std::pair<int, node>(partition[conn.index],ntk.index_to_node(conn.index)));
-                
+              if (partition[conn.index] != partition[nodeIdx] && !ntk.is_constant(ntk.index_to_node(conn.index))) {
+                scope.add(partition[nodeIdx], nodeIdx);
+                inputs.add(partition[nodeIdx], conn.index);
+                outputs.add(partition[conn.index], conn.index);
               }
             });
           }
         });
 
-        for(auto i=0; i < ntk.num_pos(); i++){
-          if(i<ntk.num_pos()-ntk.num_latches() && !ntk.is_constant(ntk.index_to_node(ntk._storage->outputs[i].index))){
-            _part_pos.insert(std::pair<int, node>(partition[ntk._storage->outputs[i].index], ntk.index_to_node(ntk._storage->outputs[i].index)));
+        for(uint32_t i=0; i < ntk.num_pos(); i++){
+          const uint32_t outIdx = ntk._storage->outputs[i].index;
+          if(i<ntk.num_pos()-ntk.num_latches() && !ntk.is_constant(ntk.index_to_node(outIdx))){
+            outputs.add(partition[outIdx], outIdx);
+          }
+          else if(!ntk.is_constant(ntk.index_to_node(outIdx))){
+            regs_in.add(partition[outIdx], outIdx);
           }
-          else {
-      			if(!ntk.is_constant(ntk.index_to_node(ntk._storage->outputs[i].index))){
-              _part_ris.insert(std::pair<int, node>(partition[ntk._storage->outputs[i].index], ntk.index_to_node(ntk._storage->outputs[i].index)));
-            }
-    		  }
         }
+      }
+
+      scope.finalize();
+      inputs.finalize();
+      outputs.finalize();
+      regs.finalize();
+      regs_in.finalize();
+      _part_scope = std::move(scope);
+      partitionInputs = std::move(inputs);
+      partitionOutputs = std::move(outputs);
+      partitionReg = std::move(regs);
+      partitionRegIn = std::move(regs_in);
+      if(part_num != 1)
+        update_io();
+    }
 
-        for(int i = 0; i < part_num; i++){
-          partitionInputs[i] = create_part_inputs(i);
-          partitionReg[i] = create_part_latches(i);
-          typename std::set<node>::iterator it;
-          partitionRegIn[i] = create_part_latches_in(i);
-          partitionOutputs[i] = create_part_outputs(i);
-          update_io(i);
+  private:
+
+    static std::vector<uint32_t> dense_partition(Ntk const& ntk, std::map<node, int> const& partition){
+      std::vector<uint32_t> dense(ntk.size(), 0u);
+      for(auto const& [n, part] : partition){
+        const uint32_t nodeIdx = ntk.node_to_index(n);
+        if(nodeIdx < dense.size())
+          dense[nodeIdx] = part;
+      }
+      return dense;
+    }
+
+    //Marks every node driving a primary output or register input, instead of scanning the outputs for each node
+    static std::vector<bool> primary_output_nodes(Ntk const& ntk){
+      std::vector<bool> po_nodes(ntk.size(), false);
+      ntk.foreach_po( [&](auto const& po){
+        po_nodes[ntk.node_to_index(ntk.get_node(po))] = true;
+      });
+      return po_nodes;
+    }
+
+    partition_lists to_lists(std::unordered_map<int, std::set<node>> const& part_nodes) const{
+      partition_lists lists(num_partitions);
+      for(auto const& [part, nodes] : part_nodes){
+        for(auto const& n : nodes){
+          lists.add(part, n);
         }
-        kahypar_context_free(context);
       }
-      
+      lists.finalize();
+      return lists;
     }
 
-  private:
+    /* Karnaugh map position of every assignment of width inputs, where input 0
+     * is the most significant bit of the Gray code */
+    static std::vector<uint8_t> const& km_gray_cells(uint32_t width){
+      static const std::vector<std::vector<uint8_t>> cells = [](){
+        std::vector<std::vector<uint8_t>> cells(9);
+        for(uint32_t w = 0; w < cells.size(); w++){
+          cells[w].resize(1u << w);
+          for(uint32_t v = 0; v < cells[w].size(); v++){
+            uint32_t gray = 0;
+            for(uint32_t b = 0; b < w; b++){
+              gray |= ((v >> b) & 1) << (w - 1 - b);
+            }
+            uint32_t binary = gray;
+            for(uint32_t shift = gray >> 1; shift; shift >>= 1){
+              binary ^= shift;
+            }
+            cells[w][v] = binary;
+          }
+        }
+        return cells;
+      }();
+      return cells[width];
+    }
 
     //Simple BFS Traversal to optain the depth of an output's logic cone before the truth table is built
     void BFS_traversal(Ntk& ntk, node output, int partition){
@@ -299,7 +400,7 @@ namespace oracle
         auto node = ntk.index_to_node(curr_node);
 
         //Make sure that the BFS traversal does not go past the inputs of the partition
-        if(partitionInputs[partition].find(curr_node) == partitionInputs[partition].end()){
+        if(!partitionInputs.contains(partition, curr_node)){
 
           for(int i = 0; i < ntk._storage->nodes[node].children.size(); i++){
 
@@ -331,7 +432,7 @@ namespace oracle
 
     void tt_build(Ntk& ntk, int partition, node curr_node, node root){
       int nodeIdx = ntk.node_to_index(curr_node);
-      if(logic_cone_inputs[root].find(nodeIdx) != logic_cone_inputs[root].end() || _part_scope[partition].find(curr_node) == _part_scope[partition].end()){
+      if(logic_cone_inputs[root].find(nodeIdx) != logic_cone_inputs[root].end() || !_part_scope.contains(partition, nodeIdx)){
         
         if(logic_cone_inputs[root].find(root) != logic_cone_inputs[root].end()){
           auto output = ntk._storage->outputs.at(get_output_index(ntk,root));
@@ -392,15 +493,11 @@ namespace oracle
       }
     }
 
-  public:
-    partition_view<Ntk> create_part( Ntk& ntk, int part ){ 
-      partition_view<Ntk> partition(ntk, partitionInputs[part], partitionOutputs[part], partitionReg[part], partitionRegIn[part], false);
-      return partition;
-    }
-
+  private:
+    /* Clones the gates of opt into ntk, with the inputs of opt connected to the
+       inputs of part, and returns the signal replacing every partition output */
     template<class NtkPart, class NtkOpt>
-    void synchronize_part(partition_view<NtkPart> part, NtkOpt& opt, Ntk &ntk){
-      int orig_ntk_size = ntk.size();
+    std::vector<std::pair<node, signal>> clone_part(partition_view<NtkPart> const& part, NtkOpt& opt, Ntk &ntk){
       mockturtle::node_map<signal, NtkOpt> old_to_new( opt );
       std::vector<signal> pis;
 
@@ -408,14 +505,8 @@ namespace oracle
         pis.push_back(part.make_signal(node));
       });
 
-      mockturtle::topo_view part_top{part};
       mockturtle::topo_view opt_top{opt};
-
-      int pi_idx = 0;
-      std::set<signal> visited_pis;
       opt_top.foreach_node( [&]( auto node ) {
-        if(opt_top.is_po(node)){
-        }
         if ( opt.is_constant( node ) || opt.is_pi( node ) || opt.is_ro( node ))
           return;
         /* collect children */
@@ -438,27 +529,43 @@ namespace oracle
         old_to_new[node] = ntk.clone_node( opt, node, children );
       });
 
+      std::vector<std::pair<node, signal>> outputs;
       for(int i = 0; i < opt._storage->outputs.size(); i++){
         auto opt_node = opt.get_node(opt._storage->outputs.at(i));
         auto opt_out = old_to_new[opt._storage->outputs.at(i)];
         auto part_out = part._roots.at(i);
         if(opt.is_complemented(opt._storage->outputs[i])){
-          opt_out.data += 1;
-
+          opt_out = ntk.create_not(opt_out);
         }
 
         if(!opt.is_constant(opt_node) && !opt.is_pi(opt_node) && !opt.is_ro(opt_node)){
-          output_substitutions[ntk.get_node(part_out)] = opt_out;
+          outputs.emplace_back(ntk.get_node(part_out), opt_out);
         }
       }
+      return outputs;
+    }
+
+  public:
+    partition_view<Ntk> create_part( Ntk& ntk, int part ){ 
+      partition_view<Ntk> partition(ntk, partitionInputs.get(part), partitionOutputs.get(part), partitionReg.get(part), partitionRegIn.get(part));
+      return partition;
+    }
+
+    /*! \brief Clones an optimized partition into ntk
+     *
+     * The outputs of the partition are replaced by the optimized logic when
+     * connect_outputs is called, after all partitions have been synchronized.
+     */
+    template<class NtkPart, class NtkOpt>
+    void synchronize_part(partition_view<NtkPart> const& part, NtkOpt& opt, Ntk &ntk){
+      for(auto const& [old_node, new_signal] : clone_part(part, opt, ntk))
+        output_substitutions[old_node] = new_signal;
     }
 
     void generate_truth_tables(Ntk& ntk){
       
       for(int i = 0; i < num_partitions; i++){                 
-        typename std::set<node>::iterator it;
-        for(it = partitionOutputs[i].begin(); it != partitionOutputs[i].end(); ++it){
-          auto curr_output = *it;  
+        for(node curr_output : partitionOutputs.get(i)){
           BFS_traversal(ntk, curr_output, i); 
           if(ntk.is_constant(curr_output)){
             std::cout << "CONSTANT\n";
@@ -477,10 +584,6 @@ namespace oracle
 
             tt_build(ntk, i, curr_output, curr_output);
             output_tt[curr_output] = tt_map[curr_output];
-            ntk.foreach_node( [&]( auto node ) {
-              int index = ntk.node_to_index(node);
-              ntk._storage->nodes[index].data[1].h1 = 0;
-            });        
           }
           else{
             std::cout << "Logic Cone too big at " << logic_cone_inputs[curr_output].size() << " inputs\n";
@@ -489,117 +592,71 @@ namespace oracle
       }
     }
 
-    std::vector<float> get_km_image( Ntk& ntk, int partition, node output ){
-
-      std::vector<float> default_image;
-      BFS_traversal(ntk, output, partition);
-      int num_inputs = logic_cone_inputs[output].size();
-      ntk.foreach_node( [&]( auto node ) {
-        int index = ntk.node_to_index(node);
-        ntk._storage->nodes[index].data[1].h1 = 0;
-      });
-
-      std::string tt = kitty::to_binary(output_tt[output]);
-      char* tt_binary = (char*)malloc(sizeof(char) * (tt.length() + 1));
-      strcpy(tt_binary, tt.c_str());
-
-      std::vector<std::string> onset_indeces;
-      int indx = 0;
-      for(int k = tt.length() - 1; k >= 0; k--){
-        int bit = (int)tt_binary[k] - 48;
-        if(bit == 1){
-          onset_indeces.push_back(oracle::to_binary(indx));
-        }
-        indx++;
+    /* Writes the 256x256 Karnaugh map image of output into image (row-major,
+     * indexed [x + 256 * y]) and returns false if the cone of output has fewer
+     * than 2 or more than 16 inputs. The low half of the cone inputs (rounded up)
+     * selects x and the high half selects y, both in Gray code order.
+     * Onset cells are 2, offset cells 0 and the padding around maps of fewer than
+     * 16 inputs is 1. Cells are set directly from the bits of the truth table. */
+    template<typename T>
+    bool fill_km_image( node output, std::vector<T>& image ){
+      constexpr uint32_t image_size = 256;
+      const uint32_t num_inputs = logic_cone_inputs[output].size();
+      if(num_inputs < 2 || num_inputs > 16){
+        return false;
       }
-      for(int k = 0; k < onset_indeces.size(); k++){
-        while(onset_indeces.at(k).length() != logic_cone_inputs[output].size()){
-          onset_indeces.at(k).insert(0, "0");
-        }
-        std::reverse(onset_indeces.at(k).begin(), onset_indeces.at(k).end());
+      const uint32_t rows = num_inputs - num_inputs / 2;
+      const uint32_t columns = num_inputs / 2;
+      const uint32_t row_num = 1u << rows;
+      const uint32_t col_num = 1u << columns;
+      const uint32_t row_offset = (image_size - row_num) / 2;
+      const uint32_t col_offset = (image_size - col_num) / 2;
+      auto const& row_cells = km_gray_cells(rows);
+      auto const& col_cells = km_gray_cells(columns);
+
+      image.assign(image_size * image_size, T(num_inputs < 16 ? 1 : 0));
+      for(uint32_t y = 0; y < col_num; y++){
+        std::fill_n(image.begin() + (y + col_offset) * image_size + row_offset, row_num, T(0));
       }
-      int columns = num_inputs / 2;
-      int rows;
-      if(num_inputs <= 16 && num_inputs >= 2){
-        if(num_inputs % 2 != 0){
-          rows = columns + 1;
-        }
-        else{
-          rows = columns;
-        }
 
-        int row_num = pow(2, rows);
-        int col_num = pow(2, columns);
-        char **k_map = (char**)malloc(sizeof(char *) * col_num);
-        for(int y = 0; y < col_num; y++)
-          k_map[y] = (char*)malloc(sizeof(char) * row_num);
-
-        for(int y = 0; y < col_num; y++){
-          for(int x = 0; x < row_num; x++){
-            k_map[y][x] = 0;
-          }
+      auto const& tt = output_tt[output];
+      const uint64_t num_bits = std::min<uint64_t>(tt.num_bits(), uint64_t(1) << num_inputs);
+      uint64_t base = 0;
+      for(auto word = tt.cbegin(); word != tt.cend() && base < num_bits; ++word, base += 64){
+        uint64_t bits = *word;
+        if(num_bits - base < 64){
+          bits &= (uint64_t(1) << (num_bits - base)) - 1;
+        }
+        while(bits){
+          const uint64_t minterm = base + __builtin_ctzll(bits);
+          bits &= bits - 1;
+          const uint32_t x = row_cells[minterm & (row_num - 1)] + row_offset;
+          const uint32_t y = col_cells[minterm >> rows] + col_offset;
+          image[x + y * image_size] = T(2);
         }
-        for(int k = 0; k < onset_indeces.size(); k++){
+      }
+      return true;
+    }
 
-          std::string row_index_gray = onset_indeces.at(k).substr(0, rows);
-          std::string col_index_gray = onset_indeces.at(k).substr(rows, onset_indeces.at(k).size() - 1);
-          std::string row_index_bin = graytoBinary(row_index_gray);
-          std::string col_index_bin = graytoBinary(col_index_gray);
-          int row_index = std::stoi(row_index_bin,nullptr,2);
-          int col_index = std::stoi(col_index_bin,nullptr,2);
-          k_map[col_index][row_index] = 2;
+    /* Level of every node of a partition, counted from the partition inputs */
+    std::unordered_map<node, int> partition_levels( Ntk const& ntk, int partition ) const {
+      return compute_levels(ntk, partitionOutputs.get(partition), partitionInputs.to_set<node>(partition));
+    }
 
-        }
-        if(num_inputs < 16){
-          int padded_row = 256;
-          int padded_col = 256;
-          char **k_map_pad = (char**)malloc(sizeof(char *) * padded_col);
-          for(int k = 0; k < padded_col; k++){
-            k_map_pad[k] = (char*)malloc(sizeof(char) * padded_row);
-          }
+    std::vector<float> get_km_image( Ntk& ntk, int partition, node output ){
 
-          for(int y = 0; y < padded_col; y++){
-            for(int x = 0; x < padded_row; x++){
-              k_map_pad[y][x] = 1;
-            }
-          }
-          int row_offset = (padded_row - row_num);
-          if(row_offset % 2 != 0){
-            row_offset++;
-          }
-          int col_offset = (padded_col - col_num);
-          if(col_offset % 2 != 0){
-            col_offset++;
-          }
-          row_offset /= 2;
-          col_offset /= 2;
-          for(int y = 0; y < col_num; y++){
-            for(int x = 0; x < row_num; x++){
-              k_map_pad[y + col_offset][x + row_offset] = k_map[y][x];
-            }
-          }
-          std::vector<float> data_1d(padded_row * padded_col);
-          for(int y = 0; y < padded_col; y++){
-            for(int x = 0; x < padded_row; x++){
-              data_1d[x + y*padded_col] = (float)k_map_pad[y][x];
-            }
-          }
-          return data_1d;
-        }
-        else{
-          std::vector<float> data_1d(row_num * col_num);
-          for(int y = 0; y < col_num; y++){
-            for(int x = 0; x < row_num; x++){
-              data_1d[x + y*col_num] = (float)k_map[y][x];
-            }
-          }
-          return data_1d;
-        }
-      }
-      return default_image;
+      std::vector<float> image;
+      BFS_traversal(ntk, output, partition);
+      fill_km_image(output, image);
+      return image;
     }
 
-    void run_classification( Ntk& ntk, std::string model_file ){
+    /* Classifies every partition as better suited for AIG or MIG optimization.
+     * The Karnaugh map images of all outputs of a partition are collected first
+     * and evaluated together, distributed over up to num_threads threads.
+     * Network depth is computed once, and the levels of a partition are computed
+     * in one pass and used for both the partition average and the output scores. */
+    void run_classification( Ntk& ntk, std::string model_file, unsigned num_threads = 1 ){
 
       int row_num = 256;
       int col_num = 256;
@@ -611,6 +668,13 @@ namespace oracle
         generate_truth_tables(ntk);
       }
 
+      mockturtle::depth_view ntk_depth{ntk};
+      const uint32_t network_depth = ntk_depth.depth();
+
+      auto predict = [&](fdeep::tensor5s const& input){
+        return model.predict_class(input);
+      };
+
       for(int i = 0; i < num_partitions; i++){
         int aig_score = 0;
         int mig_score = 0;
@@ -623,37 +687,54 @@ namespace oracle
         auto average_nodes = 0;
         auto average_depth = 0;
 
-        mockturtle::depth_view ntk_depth{ntk};
+        const auto levels = partition_levels(ntk, partition);
+
+        /* image is the index of the output's Karnaugh map in images, or -1 if
+         * its logic cone is too big to build one */
+        struct output_info{
+          int depth;
+          int image;
+        };
+        std::vector<output_info> outputs;
+        std::vector<fdeep::tensor5s> images;
+
+        _num_nodes_cone = 0;
+        for(node output : partitionOutputs.get(i)){
+          std::vector<float> image = get_km_image(ntk, partition, output);
+          int depth = levels.at(output);
+          if(!ntk.is_constant(output)){
+            total_depth += depth;
+            total_outputs++;
+          }
 
-        typename std::set<node>::iterator it;
-        for(it = partitionOutputs[i].begin(); it != partitionOutputs[i].end(); ++it){
-          auto output = *it;
-		      if(ntk.is_constant(output)) 
-            continue;  	
-        	total_depth += computeLevel(ntk, output, partitionInputs[partition]);
-        	total_outputs++;
+          if(image.size() > 0){
+            const fdeep::shared_float_vec sv(fplus::make_shared_ref<fdeep::float_vec>(std::move(image)));
+            images.push_back({fdeep::tensor5(fdeep::shape5(1, 1, row_num, col_num, chann_num), sv)});
+            outputs.push_back({depth, int(images.size()) - 1});
+          }
+          else{
+            outputs.push_back({depth, -1});
+          }
         }
         if(total_outputs>0) {
            average_nodes = _num_nodes_cone / total_outputs;
            average_depth = total_depth / total_outputs;
         }
 
-        for(it = partitionOutputs[i].begin(); it != partitionOutputs[i].end(); ++it){
-          auto output = *it;
-          _num_nodes_cone = 0;
-          std::vector<float> image = get_km_image(ntk, partition, output);
-          if(image.size() > 0){
-            const fdeep::shared_float_vec sv(fplus::make_shared_ref<fdeep::float_vec>(std::move(image)));
-            fdeep::tensor5 input(fdeep::shape5(1, 1, row_num, col_num, chann_num), sv);
-            const auto result = model.predict_class({input});
+        const std::vector<std::size_t> results = num_threads > 1 && images.size() > 1 ?
+          fplus::transform_parallelly_n_threads(num_threads, predict, images) :
+          fplus::transform(predict, images);
+        images.clear();
+
+        for(auto const& out : outputs){
+          int depth = out.depth;
+          if(out.image >= 0){
+            const auto result = results[out.image];
 
             weight = 1;
             weight_nodes = 1;
 
             if(result == 0){
-              int num_inputs = logic_cone_inputs[output].size();
-
-              int depth = computeLevel(ntk, output, partitionInputs[partition]);
               if(depth > average_depth && average_depth > 0 ){
                 if(depth > average_depth + 1)
                   weight = 2;
@@ -671,10 +752,6 @@ namespace oracle
             }
 
             else{
-              int num_inputs = logic_cone_inputs[output].size();
-
-              int depth = computeLevel(ntk, output, partitionInputs[partition]);
-
               if(depth > average_depth && average_depth > 0 ){
                 if(depth > average_depth + 1 && average_depth > 0  )
                   weight = 2;
@@ -691,12 +768,10 @@ namespace oracle
             }
           }
           else{
-            _num_nodes_cone = 0;
-            int big_depth = computeLevel(ntk, output, partitionInputs[partition]);
-            if (big_depth > 0.4 * ntk_depth.depth())
-              mig_score += ( (weight_nodes*_num_nodes_cone)+(3*big_depth));
+            if (depth > 0.4 * network_depth)
+              mig_score += ( (weight_nodes*_num_nodes_cone)+(3*depth));
             else
-              aig_score += ( (weight_nodes*_num_nodes_cone)+(3*big_depth));
+              aig_score += ( (weight_nodes*_num_nodes_cone)+(3*depth));
           }
         }
         if(aig_score > mig_score){
@@ -715,125 +790,22 @@ namespace oracle
       }
 
       mkdir(directory.c_str(), 0777);
+      std::vector<char> k_map;
       for(int i = 0; i < num_partitions; i++){
         int partition = i;
-        typename std::set<node>::iterator it;
-        for(it = partitionOutputs[i].begin(); it != partitionOutputs[i].end(); ++it){
-          auto output = *it;
+        const auto levels = partition_levels(ntk, partition);
+        for(node output : partitionOutputs.get(i)){
           BFS_traversal(ntk, output, partition);
           int num_inputs = logic_cone_inputs[output].size();
-          ntk.foreach_node( [&]( auto node ) {
-            int index = ntk.node_to_index(node);
-            ntk._storage->nodes[index].data[1].h1 = 0;
-          });
-          int logic_depth = computeLevel(ntk, output, partitionInputs[partition]);
+          int logic_depth = levels.at(output);
 
           std::string file_out = "top_kar_part_" + std::to_string(partition) + "_out_" +
                                  std::to_string(output) + "_in_" + std::to_string(num_inputs) + "_lev_" + std::to_string(logic_depth) + ".txt";
 
 
-          std::string tt = kitty::to_binary(output_tt[output]);
-          char* tt_binary = (char*)malloc(sizeof(char) * (tt.length() + 1));
-          strcpy(tt_binary, tt.c_str());
-
-          std::vector<std::string> onset_indeces;
-
-          int indx = 0;
-          for(int k = tt.length() - 1; k >= 0; k--){
-            int bit = (int)tt_binary[k] - 48;
-            if(bit == 1){
-              onset_indeces.push_back(oracle::to_binary(indx));
-            }
-            indx++;
-          }
-          for(int k = 0; k < onset_indeces.size(); k++){
-            while(onset_indeces.at(k).length() != logic_cone_inputs[output].size()){
-              onset_indeces.at(k).insert(0, "0");
-            }
-            std::reverse(onset_indeces.at(k).begin(), onset_indeces.at(k).end());
-          }
-          
-          int columns = num_inputs / 2;
-          int rows;
-          if(num_inputs <= 16 && num_inputs >= 2){
+          if(fill_km_image(output, k_map)){
             std::ofstream output_file(directory + file_out, std::ios::out | std::ios::binary | std::ios::trunc);
-            if(num_inputs % 2 != 0){
-              rows = columns + 1;
-            }
-            else{
-              rows = columns;
-            }
-
-            int row_num = pow(2, rows);
-            int col_num = pow(2, columns);
-            char **k_map = (char**)malloc(sizeof(char *) * col_num);
-            for(int y = 0; y < col_num; y++)
-              k_map[y] = (char*)malloc(sizeof(char) * row_num);
-
-            for(int y = 0; y < col_num; y++){
-              for(int x = 0; x < row_num; x++){
-                k_map[y][x] = 0;
-              }
-            }
-
-            for(int k = 0; k < onset_indeces.size(); k++){
-
-              std::string row_index_gray = onset_indeces.at(k).substr(0, rows);
-              std::string col_index_gray = onset_indeces.at(k).substr(rows, onset_indeces.at(k).size() - 1);
-              std::string row_index_bin = graytoBinary(row_index_gray);
-              std::string col_index_bin = graytoBinary(col_index_gray);
-              int row_index = std::stoi(row_index_bin,nullptr,2);
-              int col_index = std::stoi(col_index_bin,nullptr,2);
-              k_map[col_index][row_index] = 2;
-
-            }
-
-            if(num_inputs < 16){
-              int padded_row = 256;
-              int padded_col = 256;
-              char **k_map_pad = (char**)malloc(sizeof(char *) * padded_col);
-              for(int k = 0; k < padded_col; k++){
-                k_map_pad[k] = (char*)malloc(sizeof(char) * padded_row);
-              }
-
-              for(int y = 0; y < padded_col; y++){
-                for(int x = 0; x < padded_row; x++){
-                  k_map_pad[y][x] = 1;
-                }
-              }
-              int row_offset = (padded_row - row_num);
-              if(row_offset % 2 != 0){
-                row_offset++;
-              }
-              int col_offset = (padded_col - col_num);
-              if(col_offset % 2 != 0){
-                col_offset++;
-              }
-              row_offset /= 2;
-              col_offset /= 2;
-              for(int y = 0; y < col_num; y++){
-                for(int x = 0; x < row_num; x++){
-                  k_map_pad[y + col_offset][x + row_offset] = k_map[y][x];
-                }
-              }
-              std::vector<char> data_1d(padded_row * padded_col);
-              for(int y = 0; y < padded_col; y++){
-                for(int x = 0; x < padded_row; x++){
-                  data_1d[x + y*padded_col] = k_map_pad[y][x];
-                }
-              }
-
-              output_file.write(data_1d.data(), data_1d.size()*sizeof(char));
-            }
-            else{
-              std::vector<char> data_1d(row_num * col_num);
-              for(int y = 0; y < col_num; y++){
-                for(int x = 0; x < row_num; x++){
-                  data_1d[x + y*col_num] = k_map[y][x];
-                }
-              }
-              output_file.write(data_1d.data(), data_1d.size()*sizeof(char));
-            }
+            output_file.write(k_map.data(), k_map.size()*sizeof(char));
             output_file.close();
           }
 
@@ -841,7 +813,7 @@ namespace oracle
       }
     }
 
-    void connect_outputs(Ntk ntk){
+    void connect_outputs(Ntk& ntk){
       // std::cout << "Number of output substitutions = " << output_substitutions.size() << "\n";
       for(auto it = output_substitutions.begin(); it != output_substitutions.end(); ++it){
         // std::cout << "substituting " << it->first << " with " << it->second.index << "\n";
@@ -849,84 +821,35 @@ namespace oracle
       }
     }
 
-    std::set<node> create_part_outputs(int part_index){
-      std::set<node> outputs;
-      auto range = _part_pos.equal_range(part_index);
-      for(auto i = range.first; i!=range.second;++i){
-        if (std::find(outputs.begin(), outputs.end(), i->second) == outputs.end()) {
-          outputs.insert(i->second);
-        }
-      }
-      return outputs;
-    }
-
-    std::set<node> create_part_latches(int part_index){
-        std::set<node> latches;
-        auto range = _part_ros.equal_range(part_index);
-        for(auto i = range.first; i!=range.second;++i){
-          if (std::find(latches.begin(), latches.end(), i->second) == latches.end()) {
-            latches.insert(i->second);
-          }
-        }
-        return latches;
-      }
-
-     std::set<node> create_part_latches_in(int part_index){
-      std::set<node> latches_in;
-      auto range = _part_ris.equal_range(part_index);
-      for(auto i = range.first; i!=range.second;++i){
-        if (std::find(latches_in.begin(), latches_in.end(), i->second) == latches_in.end()) {
-          latches_in.insert(i->second);
-        }
-      }
-      return latches_in;
-    }
-
-    std::set<node> create_part_inputs(int part_index){
-      std::set<node> inputs;
-      auto range = _part_pis.equal_range(part_index);
-      for(auto i = range.first; i!=range.second;++i){
-        if (std::find(inputs.begin(), inputs.end(), i->second) == inputs.end()) {
-          inputs.insert(i->second);
-        }
-      }
-      return inputs;
-    }
-
-    void update_io(int part_index){
-      typename std::set<node>::iterator it;
-      for(it = partitionInputs[part_index].begin(); it != partitionInputs[part_index].end(); ++it){
-        input_partition[*it].push_back(part_index);
-      }
-      for(it = partitionOutputs[part_index].begin(); it != partitionOutputs[part_index].end(); ++it){
-        output_partition[*it].push_back(part_index);
+    //Indexes, for every node, the partitions it is an input or an output of
+    void update_io(){
+      partition_lists node_inputs, node_outputs;
+      for(int i = 0; i < num_partitions; i++){
+        for(uint32_t nodeIdx : partitionInputs.get(i))
+          node_inputs.add(nodeIdx, i);
+        for(uint32_t nodeIdx : partitionOutputs.get(i))
+          node_outputs.add(nodeIdx, i);
       }
+      node_inputs.finalize();
+      node_outputs.finalize();
+      input_partition = std::move(node_inputs);
+      output_partition = std::move(node_outputs);
     }
 
     std::set<node> get_shared_io(int part_1, int part_2){
-      std::set<node> part_1_inputs = partitionInputs[part_1];
-      std::set<node> part_1_outputs = partitionOutputs[part_1];
+      const node_range part_1_inputs = partitionInputs.get(part_1);
+      const node_range part_1_outputs = partitionOutputs.get(part_1);
 
-      std::set<node> part_2_inputs = partitionInputs[part_2];
-      std::set<node> part_2_outputs = partitionOutputs[part_2];
+      const node_range part_2_inputs = partitionInputs.get(part_2);
+      const node_range part_2_outputs = partitionOutputs.get(part_2);
 
       std::set<node> shared_io;
-      typename std::set<node>::iterator it_i;
-      typename std::set<node>::iterator it_j;
-      for(it_i = part_1_inputs.begin(); it_i != part_1_inputs.end(); ++it_i){
-        for(it_j = part_2_outputs.begin(); it_j != part_2_outputs.end(); ++it_j){
-          if(*it_i == *it_j){
-            shared_io.insert(*it_i);
-          }
-        }
-      }
-      for(it_i = part_1_outputs.begin(); it_i != part_1_outputs.end(); ++it_i){
-        for(it_j = part_2_inputs.begin(); it_j != part_2_inputs.end(); ++it_j){
-          if(*it_i == *it_j){
-            shared_io.insert(*it_i);
-          }
-        }
-      }
+      std::set_intersection(part_1_inputs.begin(), part_1_inputs.end(),
+                            part_2_outputs.begin(), part_2_outputs.end(),
+                            std::inserter(shared_io, shared_io.end()));
+      std::set_intersection(part_1_outputs.begin(), part_1_outputs.end(),
+                            part_2_inputs.begin(), part_2_inputs.end(),
+                            std::inserter(shared_io, shared_io.end()));
       return shared_io;
     }
 
@@ -943,26 +866,26 @@ namespace oracle
       std::set<node> merged_outputs;
       std::vector<std::set<node>> result_io;
 
-      std::set_union(partitionInputs[part_1].begin(), partitionInputs[part_1].end(),
-                     partitionInputs[part_2].begin(), partitionInputs[part_2].end(),
+      const node_range part_1_inputs = partitionInputs.get(part_1);
+      const node_range part_2_inputs = partitionInputs.get(part_2);
+      const node_range part_1_outputs = partitionOutputs.get(part_1);
+      const node_range part_2_outputs = partitionOutputs.get(part_2);
+
+      std::set_union(part_1_inputs.begin(), part_1_inputs.end(),
+                     part_2_inputs.begin(), part_2_inputs.end(),
                      std::inserter(merged_inputs, merged_inputs.end()));
 
-      std::set_union(partitionOutputs[part_1].begin(), partitionOutputs[part_1].end(),
-                     partitionOutputs[part_2].begin(), partitionOutputs[part_2].end(),
+      std::set_union(part_1_outputs.begin(), part_1_outputs.end(),
+                     part_2_outputs.begin(), part_2_outputs.end(),
                      std::inserter(merged_outputs, merged_outputs.end()));
       
-      for(it = partitionInputs[part_2].begin(); it != partitionInputs[part_2].end(); ++it){
-        
-        for(int i = 0; i < input_partition[*it].size(); i++){
-          if(input_partition[*it].at(i) == part_2){
-            input_partition[*it].at(i) = part_1;
-          }
-        }
+      for(uint32_t nodeIdx : part_2_inputs){
+        input_partition.rename(nodeIdx, part_2, part_1);
       }
 
-      for(it = partitionOutputs[part_2].begin(); it != partitionOutputs[part_2].end(); ++it){
-        if(_part_nodes[*it] == part_2)
-          _part_nodes[*it] = part_1;
+      for(uint32_t nodeIdx : part_2_outputs){
+        if(nodeIdx < _node_partition.size() && _node_partition[nodeIdx] == static_cast<uint32_t>(part_2))
+          _node_partition[nodeIdx] = part_1;
       }
 
       merged_inputs.erase(ntk.index_to_node(0));
@@ -994,43 +917,71 @@ namespace oracle
     }
 
     std::set<node> get_part_outputs(int partition){
-      return partitionOutputs[partition];
+      return partitionOutputs.to_set<node>(partition);
     }
 
-    void set_part_outputs(int partition, std::set<node> new_outputs){
-      partitionOutputs[partition] = new_outputs;
+    void set_part_outputs(int partition, std::set<node> const& new_outputs){
+      partitionOutputs.assign(partition, new_outputs);
     }
 
     std::set<node> get_part_inputs(int partition){
-      return partitionInputs[partition];
+      return partitionInputs.to_set<node>(partition);
     }
 
-    void set_part_inputs(int partition, std::set<node> new_inputs){
-      partitionInputs[partition] = new_inputs;
+    void set_part_inputs(int partition, std::set<node> const& new_inputs){
+      partitionInputs.assign(partition, new_inputs);
+    }
+
+    //Sorted node indices of a partition, read in place without building a set
+    node_range part_inputs(int partition) const{
+      return partitionInputs.get(partition);
+    }
+
+    node_range part_outputs(int partition) const{
+      return partitionOutputs.get(partition);
+    }
+
+    node_range part_regs(int partition) const{
+      return partitionReg.get(partition);
+    }
+
+    node_range part_regs_in(int partition) const{
+      return partitionRegIn.get(partition);
+    }
+
+    node_range part_scope(int partition) const{
+      return _part_scope.get(partition);
+    }
+
+    int get_node_partition(node curr_node) const{
+      return _node_partition.at(curr_node);
     }
 
     std::vector<std::set<node>> get_all_part_connections (){
-      return _part_scope;
+      std::vector<std::set<node>> scope;
+      for(int i = 0; i < num_partitions; i++)
+        scope.push_back(_part_scope.to_set<node>(i));
+      return scope;
     }
 
     std::unordered_map<int, std::set<node>> get_all_partition_inputs(){
-      return partitionInputs;
+      return to_sets(partitionInputs);
     }
 
     std::unordered_map<int, std::set<node>> get_all_partition_outputs(){
-      return partitionOutputs;
+      return to_sets(partitionOutputs);
     }
 
     std::unordered_map<int, std::set<node>> get_all_partition_regs(){
-      return partitionReg;
+      return to_sets(partitionReg);
     }
 
     std::unordered_map<int, std::set<node>> get_all_partition_regin(){
-      return partitionRegIn;
+      return to_sets(partitionRegIn);
     }
 
     std::set<node> get_part_context (int partition_num){
-      return _part_scope[partition_num];
+      return _part_scope.to_set<node>(partition_num);
     }
 
     std::vector<int> get_aig_parts(){
@@ -1042,18 +993,17 @@ namespace oracle
 
     std::set<int> get_connected_parts( Ntk& ntk, int partition_num ){
       std::set<int> conn_parts;
-      typename std::set<node>::iterator it;
-      for(it = partitionInputs[partition_num].begin(); it != partitionInputs[partition_num].end(); ++it){
-        for(int i = 0; i < output_partition[*it].size(); i++){
-          if(output_partition[*it].at(i) != partition_num && !ntk.is_pi(*it)){
-            conn_parts.insert(output_partition[*it].at(i));
+      for(uint32_t nodeIdx : partitionInputs.get(partition_num)){
+        for(int part : output_partition.get(nodeIdx)){
+          if(part != partition_num && !ntk.is_pi(nodeIdx)){
+            conn_parts.insert(part);
           }
         }
       }
-      for(it = partitionOutputs[partition_num].begin(); it != partitionOutputs[partition_num].end(); ++it){
-        for(int i = 0; i < input_partition[*it].size(); i++){
-          if(input_partition[*it].at(i) != partition_num && !ntk.is_pi(*it)){
-            conn_parts.insert(input_partition[*it].at(i));
+      for(uint32_t nodeIdx : partitionOutputs.get(partition_num)){
+        for(int part : input_partition.get(nodeIdx)){
+          if(part != partition_num && !ntk.is_pi(nodeIdx)){
+            conn_parts.insert(part);
           }
         }
       }
@@ -1061,23 +1011,29 @@ namespace oracle
     }
 
     std::vector<int> get_input_part(node curr_node){
-      return input_partition[curr_node];
+      const node_range parts = input_partition.get(curr_node);
+      return std::vector<int>(parts.begin(), parts.end());
     }
     std::vector<int> get_output_part(node curr_node){
-      return output_partition[curr_node];
+      const node_range parts = output_partition.get(curr_node);
+      return std::vector<int>(parts.begin(), parts.end());
     }
 
   private:
+    std::unordered_map<int, std::set<node>> to_sets(partition_lists const& lists) const{
+      std::unordered_map<int, std::set<node>> sets;
+      for(int i = 0; i < num_partitions; i++)
+        sets[i] = lists.to_set<node>(i);
+      return sets;
+    }
+
     int num_partitions = 0;
 
-    std::unordered_map<node, int> _part_nodes;
-    std::multimap<int, node> _part_pis;
-    std::multimap<int, node> _part_pos;
-    std::multimap<int, node> _part_ros;
-    std::multimap<int, node> _part_ris;
+    //partition of every node, indexed by node index
+    std::vector<uint32_t> _node_partition;
 
-    std::vector<std::set<node>> _part_scope;
-    int _num_nodes_cone;
+    partition_lists _part_scope;
+    int _num_nodes_cone = 0;
 
     std::unordered_map<int, std::set<node>> combined_deleted_nodes;
 
@@ -1085,15 +1041,17 @@ namespace oracle
     std::vector<int> mig_parts;
 
     std::unordered_map<int, std::set<int>> conn_parts;
-    std::unordered_map<node, std::vector<int>> input_partition;
-    std::unordered_map<node, std::vector<int>> output_partition;
+    //partitions every node is an input (output) of, indexed by node index
+    partition_lists input_partition;
+    partition_lists output_partition;
 
-    std::unordered_map<int, std::set<node>> partitionOutputs;
-    std::unordered_map<int, std::set<node>> partitionInputs;
-    std::unordered_map<int, std::set<node>> partitionReg;
-    std::unordered_map<int, std::set<node>> partitionRegIn;
+    partition_lists partitionOutputs;
+    partition_lists partitionInputs;
+    partition_lists partitionReg;
+    partition_lists partitionRegIn;
 
     std::unordered_map<node, signal> output_substitutions;
+    //what every node substituted in place was replaced with
 
     std::map<int, int> output_cone_depth;
     std::unordered_map<node, std::set<int>> logic_cone_inputs;
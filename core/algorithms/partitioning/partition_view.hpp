@@ -38,16 +38,46 @@
 #include <set>
 #include <unordered_set>
 #include <cassert>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
 
 #include <mockturtle/traits.hpp>
 #include <mockturtle/networks/detail/foreach.hpp>
 #include <mockturtle/views/fanout_view.hpp>
+#include <mockturtle/views/names_view.hpp>
 
 namespace oracle
 {
 
+  namespace detail
+  {
+    /* network type a partition view is built on: views on a names_view only
+       share the structure of the network, not its signal and output names */
+    template<typename Ntk>
+    struct partition_base
+    {
+      using type = Ntk;
+    };
+
+    template<typename Ntk>
+    struct partition_base<mockturtle::names_view<Ntk>>
+    {
+      using type = Ntk;
+    };
+  } /* namespace detail */
+
 /*! \brief Implements an isolated view on a window in a network.
  *
+ * The view shares the storage of the parent network. Its nodes are listed
+ * in topological order in _nodes (constants, then registers, then leaves,
+ * then gates), so that the position of a node in _nodes is its index in the
+ * view and the kind of a node follows from its index. Nodes are found through
+ * an index local to the view, which also marks the nodes visited while the
+ * view is built, so construction takes time in the size of the partition and
+ * leaves the visited flags of the shared network untouched.
  */
 
   template<typename Ntk>
@@ -64,60 +94,60 @@ namespace oracle
       //   add_node(get_node(get_constant(false)));
       // }
 
-      explicit partition_view( Ntk& ntk, std::set<node>& leaves, std::set<node>& pivots, std::set<node>& latches, std::set<node>& latches_in, bool auto_extend = true )
-              : Ntk( ntk )
+      /* leaves, pivots, latches and latches_in can be any ranges of node indices in ascending order,
+         such as std::set<node> or the lists kept by partition_manager */
+      template<typename Nodes>
+      explicit partition_view( Ntk& ntk, Nodes const& leaves, Nodes const& pivots, Nodes const& latches, Nodes const& latches_in )
+              : Ntk( static_cast<typename detail::partition_base<Ntk>::type const&>( ntk ) ), _parent( &ntk )
       {
         static_assert( mockturtle::is_network_type_v<Ntk>, "Ntk is not a network type" );
-        static_assert( mockturtle::has_set_visited_v<Ntk>, "Ntk does not implement the set_visited method" );
-        static_assert( mockturtle::has_visited_v<Ntk>, "Ntk does not implement the visited method" );
         static_assert( mockturtle::has_get_node_v<Ntk>, "Ntk does not implement the get_node method" );
         static_assert( mockturtle::has_get_constant_v<Ntk>, "Ntk does not implement the get_constant method" );
         static_assert( mockturtle::has_is_constant_v<Ntk>, "Ntk does not implement the is_constant method" );
         static_assert( mockturtle::has_make_signal_v<Ntk>, "Ntk does not implement the make_signal method" );
 
-        this->clear_visited();
+        _nodes.reserve( 2u + std::size( latches ) + std::size( leaves ) + 4u * std::size( pivots ) );
+        resize_index( _nodes.capacity() );
+
         /* constants */
         add_node( this->get_node( this->get_constant( false ) ) );
-        this->set_visited( this->get_node( this->get_constant( false ) ), 1 );
         if ( this->get_node( this->get_constant( true ) ) != this->get_node( this->get_constant( false ) ) ) {
 
           add_node( this->get_node( this->get_constant( true ) ) );
-          this->set_visited( this->get_node( this->get_constant( true ) ), 1 );
           ++_num_constants;
         }
 
         /* latches */
-        for ( auto const& reg : latches ) {
-          if ( this->visited( reg ) == 1 )
+        for ( node const reg : latches ) {
+          if ( contains( reg ) )
             continue;
 
           _ris[reg] = ntk.ro_to_ri(ntk.make_signal(reg));
           add_node( reg );
-          _latches.insert(reg);
-          this->set_visited( reg, 1 );
           ++_num_regs;
         }
 
         /* primary inputs */
-        for ( auto const& leaf : leaves ) {
+        for ( node const leaf : leaves ) {
 
-          if ( this->visited( leaf ) == 1 )
+          if ( contains( leaf ) )
             continue;
 
           add_node( leaf );
-          this->set_visited( leaf, 1 );
           ++_num_leaves;
         }
 
-        for ( auto const& p : pivots ) {
-          traverse( p );
+        std::vector<std::pair<node, std::size_t>> stack;
+        std::vector<node> fanins;
+        for ( node const p : pivots ) {
+          traverse( p, stack, fanins );
         }
 
-        for (auto const& ri : latches_in){
-            traverse(ri);
+        for (node const ri : latches_in){
+            traverse( ri, stack, fanins );
         }
 
-        for (auto n : pivots){
+        for (node n : pivots){
 
           auto sig = this->make_signal(n);
           if(ntk.is_complemented(sig)) {
@@ -127,18 +157,13 @@ namespace oracle
         }
 
         //registers inputs (pseudo POs)
-        for (auto ri : latches_in){
+        for (node ri : latches_in){
           auto sig = this->make_signal(ri);
           if(ntk.is_complemented(sig)) {
             sig = ntk.create_not(sig);
           }
           _roots.push_back(sig);
         }
-
-        /* restore visited */
-        for ( auto const& n : _nodes ) {
-          this->set_visited( n, 0 );
-        }
       }
 
       inline auto size() const { return static_cast<uint32_t>( _nodes.size() ); }
@@ -151,33 +176,31 @@ namespace oracle
         return _nodes.size() - _num_leaves - _num_constants - _num_regs;
       }
 
-      inline auto node_to_index( const node& n ) const { return _node_to_index.at( n ); }
+      inline auto node_to_index( const node& n ) const
+      {
+        const auto index = find_index( n );
+        if ( index == no_index )
+          throw std::out_of_range( "node is not part of the partition view" );
+        return index;
+      }
       inline auto index_to_node( uint32_t index ) const { return _nodes[index]; }
 
       inline bool is_pi( node const& pi ) const 
       {
-        std::vector<signal> children;
-        this->foreach_fanin( pi, [&]( const auto& f ) {
-          children.push_back(f);
-        });
-        const auto beg = _nodes.begin() + _num_constants + _num_regs;
-        return std::find( beg, beg + _num_leaves, pi ) != beg + _num_leaves;// || children.size() == 0;
+        const auto index = find_index( pi ) - _num_constants - _num_regs;
+        return index < _num_leaves;
       }
 
       inline bool is_ro( node const& ro ) const
       {
-        const auto beg = _latches.begin();
-        return std::find( beg, _latches.end(), ro ) != _latches.end();
+        const auto index = find_index( ro ) - _num_constants;
+        return index < _num_regs;
       }
 
       inline bool is_ci( node const& pi ) const 
       {
-        std::vector<signal> children;
-        this->foreach_fanin( pi, [&]( const auto& f ) {
-          children.push_back(f);
-        });
-        const auto beg = _nodes.begin() + _num_constants;
-        return std::find( beg, beg + _num_leaves, pi ) != beg + _num_leaves;// || children.size() == 0;
+        const auto index = find_index( pi ) - _num_constants;
+        return index < _num_leaves;
       }
 
 
@@ -210,27 +233,50 @@ namespace oracle
           return _fanout_size.at( node_to_index(n) );
       }
 
-      std::vector<signal> get_children( int nodeIdx ) const
+      std::vector<node> get_node_list(){
+        return _nodes;
+      }
+
+      /* names are looked up in the parent network instead of being copied into
+         every view, so a view must not outlive the network it was created from */
+      template<typename N = Ntk, typename = std::enable_if_t<mockturtle::has_has_name_v<N>>>
+      bool has_name( signal const& s ) const
       {
-          return _children[nodeIdx];
+        return _parent->has_name( s );
       }
 
-      std::vector<node> get_node_list(){
-        return _nodes;
+      template<typename N = Ntk, typename = std::enable_if_t<mockturtle::has_get_name_v<N>>>
+      std::string get_name( signal const& s ) const
+      {
+        return _parent->get_name( s );
+      }
+
+      template<typename N = Ntk, typename = std::enable_if_t<mockturtle::has_has_output_name_v<N>>>
+      bool has_output_name( uint32_t index ) const
+      {
+        return _parent->has_output_name( index );
+      }
+
+      template<typename N = Ntk, typename = std::enable_if_t<mockturtle::has_get_output_name_v<N>>>
+      std::string get_output_name( uint32_t index ) const
+      {
+        return _parent->get_output_name( index );
       }
 
 
   private:
+    static constexpr uint32_t no_index = std::numeric_limits<uint32_t>::max();
 
     void add_node( node const& n )
     {
-      _node_to_index[n] = _nodes.size();
+      if ( 2u * ( _nodes.size() + 1u ) > _index.size() )
+        resize_index( 2u * _nodes.size() );
+      insert_index( n, _nodes.size() );
       _nodes.push_back( n );
-      _nodes_lut.insert(n);
 
       auto fanout_counter = 0;
       this->foreach_fanin( n, [&]( const auto& f ) {
-        if ( _nodes_lut.find(this->get_node( f ) ) != _nodes_lut.end() ) {
+        if ( find_index( this->get_node( f ) ) != no_index ) {
 
           fanout_counter++;
         }
@@ -238,55 +284,86 @@ namespace oracle
       _fanout_size.push_back( fanout_counter );
     }
 
-      void traverse( node const& n ) {
-        if ( this->visited( n ) == 1 )
+      /* adds the transitive fanin of n in post-order, using an explicit stack
+         of (node, number of pending fanins below it on the fanin stack) */
+      void traverse( node const& n, std::vector<std::pair<node, std::size_t>>& stack, std::vector<node>& fanins ) {
+        if ( contains( n ) )
           return;
 
-        this->foreach_fanin( n, [&]( const auto& f ) {
-          traverse( this->get_node( f ) );
-        } );
+        auto push = [&]( node const& m ) {
+          stack.emplace_back( m, fanins.size() );
+          this->foreach_fanin( m, [&]( const auto& f ) {
+            fanins.push_back( this->get_node( f ) );
+          } );
+          std::reverse( fanins.begin() + stack.back().second, fanins.end() );
+        };
+
+        push( n );
+        while ( !stack.empty() ) {
+          if ( fanins.size() > stack.back().second ) {
+            const node child = fanins.back();
+            fanins.pop_back();
+            if ( !contains( child ) )
+              push( child );
+            continue;
+          }
 
-        add_node( n );
-        this->set_visited( n, 1 );
+          add_node( stack.back().first );
+          stack.pop_back();
+        }
       }
 
-      void update_fanin( Ntk const& ntk ){
-
-        foreach_gate ([&]( auto node ){
-          std::vector<signal> children;
-          int nodeIdx = node_to_index(node);
-          for(auto const& child : ntk._storage->nodes[node].children){
-            auto orig_node = ntk.index_to_node(child.index);
-            auto part_node = node_to_index(orig_node);
-            auto sig = ntk.make_signal(part_node);
-            if(child.data & 1){
-              sig = ntk.create_not(sig);
-            }
-            children.push_back(sig);
-          }
-          auto s = signal(node, 0);
-          _children[nodeIdx] = children;
-        });
+      /* open addressing table mapping nodes to their index in the view,
+         slots hold the index + 1 and 0 marks an empty slot */
+      uint32_t find_index( node const& n ) const {
+        std::size_t slot = hash_slot( n );
+        while ( _index[slot] != 0 ) {
+          if ( _nodes[_index[slot] - 1] == n )
+            return _index[slot] - 1;
+          slot = ( slot + 1 ) & ( _index.size() - 1 );
+        }
+        return no_index;
       }
+
+      bool contains( node const& n ) const {
+        return find_index( n ) != no_index;
+      }
+
+      void insert_index( node const& n, uint32_t index ) {
+        std::size_t slot = hash_slot( n );
+        while ( _index[slot] != 0 )
+          slot = ( slot + 1 ) & ( _index.size() - 1 );
+        _index[slot] = index + 1;
+      }
+
+      void resize_index( std::size_t num_nodes ) {
+        _index_bits = 4u;
+        while ( ( std::size_t( 1 ) << _index_bits ) < 2u * num_nodes )
+          ++_index_bits;
+        _index.assign( std::size_t( 1 ) << _index_bits, 0u );
+        for ( uint32_t i = 0; i < _nodes.size(); i++ )
+          insert_index( _nodes[i], i );
+      }
+
+      std::size_t hash_slot( node const& n ) const {
+        return ( static_cast<uint64_t>( n ) * UINT64_C( 0x9E3779B97F4A7C15 ) ) >> ( 64u - _index_bits );
+      }
+
     public:
       unsigned _num_constants{1};
       unsigned _num_leaves{0};
       unsigned _num_regs{0};
 
-      std::unordered_set<node> _latches;
-
       std::vector<node> _nodes;
-      std::unordered_map<int, uint32_t> _visited;
-      std::unordered_map<int, std::vector<signal>> _children;
-      std::unordered_map<node, uint32_t> _node_to_index;
       std::unordered_map<node, signal> _ris;
 
-      std::vector<signal> _outputs;
       std::vector<signal> _roots;
       std::vector<unsigned> _fanout_size;
 
-      std::unordered_set<node>   _nodes_lut;
-      std::unordered_set<signal> _roots_lut;
+    private:
+      Ntk const* _parent;
+      std::vector<uint32_t> _index;
+      unsigned _index_bits{4u};
     };
 
-  } /* namespace oracle */
\ No newline at end of file
+  } /* namespace oracle */
@@ -0,0 +1,283 @@
+/*!
+  \file timing_engine.hpp
+  \brief Unit delay arrival, required and slack times kept in dense arrays
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace oracle
+{
+
+  namespace detail
+  {
+    template<class Ntk, class = void>
+    struct has_dead_nodes : std::false_type
+    {
+    };
+
+    template<class Ntk>
+    struct has_dead_nodes<Ntk, std::void_t<decltype( std::declval<Ntk const>().is_dead( std::declval<typename Ntk::node>() ) )>> : std::true_type
+    {
+    };
+  } /* namespace detail */
+
+  /*! \brief Unit delay timing of a network
+   *
+   * The arrival time of a node is its level (constants and combinational
+   * inputs are on level 0). Required times count back from the network depth,
+   * the largest arrival time of an output, through the fanouts of every node.
+   * The slack of a node is required minus arrival time, so the nodes with
+   * slack 0 form the critical paths.
+   *
+   * Times and fanouts are stored in arrays indexed by node index and computed
+   * in one forward and one backward pass. After the network has been edited,
+   * update() only revisits the transitive fanout (arrival) and fanin
+   * (required) of the nodes that changed; all required times are recomputed
+   * only if the network depth changes.
+   */
+  template<typename Ntk>
+  class timing_engine
+  {
+  public:
+    using node = typename Ntk::node;
+
+  public:
+    timing_engine() = default;
+
+    explicit timing_engine( Ntk const& ntk )
+    {
+      std::vector<node> nodes;
+      nodes.reserve( ntk.size() );
+      ntk.foreach_node( [&]( auto n ) {
+        nodes.push_back( n );
+      } );
+      update( ntk, nodes );
+    }
+
+    uint32_t depth() const
+    {
+      return _depth;
+    }
+
+    uint32_t arrival( node const& n ) const
+    {
+      return _arrival[n];
+    }
+
+    int32_t required( node const& n ) const
+    {
+      return _required[n];
+    }
+
+    int32_t slack( node const& n ) const
+    {
+      return _required[n] - static_cast<int32_t>( _arrival[n] );
+    }
+
+    bool is_critical( node const& n ) const
+    {
+      return _alive[n] && slack( n ) == 0;
+    }
+
+    int32_t max_slack() const
+    {
+      int32_t result = 0;
+      for ( uint32_t i = 0; i < _alive.size(); i++ )
+      {
+        if ( _alive[i] )
+          result = std::max( result, slack( i ) );
+      }
+      return result;
+    }
+
+    /*! \brief Nodes other than constants with slack 0, in index order */
+    std::vector<node> critical_path() const
+    {
+      std::vector<node> path;
+      for ( uint32_t i = 0; i < _alive.size(); i++ )
+      {
+        if ( is_critical( i ) )
+          path.push_back( i );
+      }
+      return path;
+    }
+
+    /*! \brief Brings all times up to date after the given nodes changed
+     *
+     * changed lists the nodes that were added, taken out of the network, or
+     * had their fanins replaced. Nodes taken out along with a listed node, as
+     * take_out_node does with fanins left without fanout, are found by the
+     * engine. Outputs may have been redirected as well.
+     */
+    void update( Ntk const& ntk, std::vector<node> const& changed )
+    {
+      const uint32_t size = ntk.size();
+      if ( _arrival.size() < size )
+      {
+        _arrival.resize( size, 0u );
+        _required.resize( size, 0 );
+        _alive.resize( size, 0u );
+        _fanins.resize( size );
+        _fanouts.resize( size );
+      }
+
+      /* refresh the fanins and fanouts of the changed nodes */
+      std::vector<uint32_t> forward_seeds, backward_seeds;
+      std::vector<uint32_t> stack;
+      for ( auto const& n : changed )
+        stack.push_back( ntk.node_to_index( n ) );
+      while ( !stack.empty() )
+      {
+        const uint32_t index = stack.back();
+        stack.pop_back();
+
+        for ( auto fanin : _fanins[index] )
+        {
+          auto& fanouts = _fanouts[fanin];
+          fanouts.erase( std::remove( fanouts.begin(), fanouts.end(), index ), fanouts.end() );
+          backward_seeds.push_back( fanin );
+          if ( !is_alive( ntk, fanin ) && !_fanins[fanin].empty() )
+            stack.push_back( fanin );
+        }
+        _fanins[index].clear();
+
+        /* constants have no fanins and are never part of a critical path */
+        _alive[index] = is_alive( ntk, index ) && !ntk.is_constant( ntk.index_to_node( index ) );
+        if ( _alive[index] )
+        {
+          ntk.foreach_fanin( ntk.index_to_node( index ), [&]( auto const& f ) {
+            const uint32_t fanin = ntk.node_to_index( ntk.get_node( f ) );
+            if ( std::find( _fanins[index].begin(), _fanins[index].end(), fanin ) != _fanins[index].end() )
+              return;
+            _fanins[index].push_back( fanin );
+            _fanouts[fanin].push_back( index );
+            backward_seeds.push_back( fanin );
+          } );
+        }
+        forward_seeds.push_back( index );
+        backward_seeds.push_back( index );
+      }
+
+      /* arrival times of the transitive fanout, fanins first */
+      for ( auto index : order( forward_seeds, _fanouts, _fanins ) )
+      {
+        uint32_t level = 0;
+        for ( auto fanin : _fanins[index] )
+          level = std::max( level, _arrival[fanin] + 1 );
+        _arrival[index] = _alive[index] ? level : 0u;
+      }
+
+      /* network depth, which all required times count back from */
+      uint32_t new_depth = 0;
+      ntk.foreach_po( [&]( auto const& f ) {
+        new_depth = std::max( new_depth, _arrival[ntk.node_to_index( ntk.get_node( f ) )] );
+      } );
+
+      if ( new_depth != _depth || !_initialized )
+      {
+        _depth = new_depth;
+        _initialized = true;
+        backward_seeds.clear();
+        for ( uint32_t i = 0; i < size; i++ )
+          backward_seeds.push_back( i );
+      }
+
+      /* required times of the transitive fanin, fanouts first */
+      for ( auto index : order( backward_seeds, _fanins, _fanouts ) )
+      {
+        int32_t required = _depth;
+        for ( auto fanout : _fanouts[index] )
+          required = std::min( required, _required[fanout] - 1 );
+        _required[index] = required;
+      }
+    }
+
+  private:
+    static bool is_alive( Ntk const& ntk, uint32_t index )
+    {
+      if constexpr ( detail::has_dead_nodes<Ntk>::value )
+        return !ntk.is_dead( ntk.index_to_node( index ) );
+      else
+        return true;
+    }
+
+    /* All nodes reachable from seeds along next, ordered so that every node
+     * comes after those of its prev neighbours that are reachable as well */
+    std::vector<uint32_t> order( std::vector<uint32_t> const& seeds, std::vector<std::vector<uint32_t>> const& next,
+                                 std::vector<std::vector<uint32_t>> const& prev )
+    {
+      _state.resize( _arrival.size(), 0u );
+      std::vector<uint32_t> reached;
+      for ( auto seed : seeds )
+      {
+        if ( !_state[seed] )
+        {
+          _state[seed] = 1u;
+          reached.push_back( seed );
+        }
+      }
+      for ( std::size_t i = 0; i < reached.size(); i++ )
+      {
+        for ( auto n : next[reached[i]] )
+        {
+          if ( !_state[n] )
+          {
+            _state[n] = 1u;
+            reached.push_back( n );
+          }
+        }
+      }
+
+      /* depth-first post order on prev, restricted to the reached nodes */
+      std::vector<uint32_t> result;
+      result.reserve( reached.size() );
+      std::vector<std::pair<uint32_t, uint32_t>> stack;
+      for ( auto root : reached )
+      {
+        if ( _state[root] != 1u )
+          continue;
+        _state[root] = 2u;
+        stack.emplace_back( root, 0u );
+        while ( !stack.empty() )
+        {
+          const uint32_t index = stack.back().first;
+          const uint32_t pos = stack.back().second++;
+          if ( pos < prev[index].size() )
+          {
+            const uint32_t n = prev[index][pos];
+            if ( _state[n] == 1u )
+            {
+              _state[n] = 2u;
+              stack.emplace_back( n, 0u );
+            }
+          }
+          else
+          {
+            result.push_back( index );
+            stack.pop_back();
+          }
+        }
+      }
+
+      for ( auto index : reached )
+        _state[index] = 0u;
+      return result;
+    }
+
+    uint32_t _depth = 0;
+    bool _initialized = false;
+    std::vector<uint32_t> _arrival;
+    std::vector<int32_t> _required;
+    std::vector<uint8_t> _alive;
+    std::vector<uint8_t> _state;
+    std::vector<std::vector<uint32_t>> _fanins;
+    std::vector<std::vector<uint32_t>> _fanouts;
+  };
+
+} /* namespace oracle */
@@ -0,0 +1,490 @@
+/*!
+  \file snapshot.hpp
+  \brief Binary snapshots of networks and their names
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include <kitty/constructors.hpp>
+#include <kitty/dynamic_truth_table.hpp>
+#include <mockturtle/networks/aig.hpp>
+#include <mockturtle/networks/klut.hpp>
+#include <mockturtle/networks/mig.hpp>
+#include <mockturtle/networks/xag.hpp>
+#include <mockturtle/traits.hpp>
+#include <mockturtle/utils/truth_table_cache.hpp>
+
+#include "../input/mapped_file.hpp"
+
+namespace oracle
+{
+
+  /*! \brief Network types a snapshot can hold */
+  enum class snapshot_kind : uint32_t { none = 0, aig = 1, mig = 2, xag = 3, klut = 4 };
+
+  namespace detail
+  {
+    static constexpr char snapshot_magic[8] = {'L', 'S', 'O', 'S', 'N', 'A', 'P', '\0'};
+    static constexpr uint32_t snapshot_version = 1u;
+
+    template<class Ntk>
+    constexpr snapshot_kind kind_of()
+    {
+      if constexpr ( std::is_base_of_v<mockturtle::aig_network, Ntk> )
+        return snapshot_kind::aig;
+      else if constexpr ( std::is_base_of_v<mockturtle::mig_network, Ntk> )
+        return snapshot_kind::mig;
+      else if constexpr ( std::is_base_of_v<mockturtle::xag_network, Ntk> )
+        return snapshot_kind::xag;
+      else if constexpr ( std::is_base_of_v<mockturtle::klut_network, Ntk> )
+        return snapshot_kind::klut;
+      else
+        return snapshot_kind::none;
+    }
+
+    /* Writes 64-bit words and byte arrays padded to 8 bytes, so that every
+     * section of the file starts on an aligned offset */
+    class snapshot_writer
+    {
+    public:
+      explicit snapshot_writer( std::ostream& os ) : os( os ) {}
+
+      void word( uint64_t value )
+      {
+        os.write( reinterpret_cast<char const*>( &value ), sizeof( value ) );
+      }
+
+      void bytes( void const* data, uint64_t size )
+      {
+        static constexpr char zeros[8] = {};
+        os.write( static_cast<char const*>( data ), size );
+        os.write( zeros, ( 8u - size % 8u ) % 8u );
+      }
+
+      void string( std::string_view s )
+      {
+        word( s.size() );
+        bytes( s.data(), s.size() );
+      }
+
+    private:
+      std::ostream& os;
+    };
+
+    /* Reads back what snapshot_writer wrote, directly from the mapped file */
+    class snapshot_reader
+    {
+    public:
+      snapshot_reader( char const* begin, char const* end ) : pos( begin ), end( end ) {}
+
+      bool good() const
+      {
+        return ok;
+      }
+
+      uint64_t word()
+      {
+        uint64_t value = 0u;
+        if ( available( sizeof( value ) ) )
+        {
+          std::memcpy( &value, pos, sizeof( value ) );
+          pos += sizeof( value );
+        }
+        return value;
+      }
+
+      /* the next size bytes, which stay valid as long as the file is mapped */
+      char const* bytes( uint64_t size )
+      {
+        if ( !available( size ) || !available( size + ( 8u - size % 8u ) % 8u ) )
+          return nullptr;
+        char const* data = pos;
+        pos += size + ( 8u - size % 8u ) % 8u;
+        return data;
+      }
+
+      /* the next count items of size bytes each, without overflowing count * size */
+      char const* array( uint64_t count, uint64_t size )
+      {
+        if ( size != 0u && count > remaining() / size )
+        {
+          ok = false;
+          return nullptr;
+        }
+        return bytes( count * size );
+      }
+
+      uint64_t remaining() const
+      {
+        return static_cast<uint64_t>( end - pos );
+      }
+
+      std::string string()
+      {
+        const uint64_t size = word();
+        char const* data = bytes( size );
+        return data ? std::string( data, size ) : std::string();
+      }
+
+    private:
+      bool available( uint64_t size )
+      {
+        ok = ok && static_cast<uint64_t>( end - pos ) >= size;
+        return ok;
+      }
+
+      char const* pos;
+      char const* end;
+      bool ok = true;
+    };
+  } /* namespace detail */
+
+  /*! \brief Writes the storage of ntk and its names to a snapshot file
+   *
+   * A snapshot holds the nodes, inputs, outputs, latches, network name and
+   * latch information of the network storage, the truth table cache of k-LUT
+   * networks, and the signal and output names of a names_view. Nodes with a
+   * fixed number of fanins are stored as one array in their in-memory
+   * layout; all sections are aligned to 8 bytes. The structural hash table
+   * is not stored, since it can be rebuilt from the nodes.
+   */
+  template<class Ntk>
+  bool write_snapshot( Ntk const& ntk, std::string const& filename )
+  {
+    constexpr snapshot_kind kind = detail::kind_of<Ntk>();
+    static_assert( kind != snapshot_kind::none, "Ntk is not an AIG, MIG, XAG or k-LUT network" );
+
+    std::ofstream os( filename, std::ofstream::binary );
+    if ( !os.is_open() )
+    {
+      std::cout << "Unable to write " << filename << "\n";
+      return false;
+    }
+    std::vector<char> buffer( 1u << 20 );
+    os.rdbuf()->pubsetbuf( buffer.data(), buffer.size() );
+
+    auto const& storage = *ntk._storage;
+    using node_type = typename std::decay_t<decltype( storage.nodes )>::value_type;
+    detail::snapshot_writer out( os );
+
+    os.write( detail::snapshot_magic, sizeof( detail::snapshot_magic ) );
+    out.word( ( static_cast<uint64_t>( kind ) << 32 ) | detail::snapshot_version );
+
+    /* nodes */
+    out.word( storage.nodes.size() );
+    if constexpr ( kind == snapshot_kind::klut )
+    {
+      std::vector<uint64_t> offsets{0u};
+      offsets.reserve( storage.nodes.size() + 1u );
+      for ( auto const& n : storage.nodes )
+        offsets.push_back( offsets.back() + n.children.size() );
+      out.bytes( offsets.data(), offsets.size() * sizeof( uint64_t ) );
+      for ( auto const& n : storage.nodes )
+        out.bytes( n.children.data(), n.children.size() * sizeof( typename node_type::pointer_type ) );
+      for ( auto const& n : storage.nodes )
+        out.bytes( n.data.data(), sizeof( n.data ) );
+    }
+    else
+    {
+      static_assert( std::is_trivially_copyable_v<node_type>, "nodes must be trivially copyable" );
+      out.word( sizeof( node_type ) );
+      out.bytes( storage.nodes.data(), storage.nodes.size() * sizeof( node_type ) );
+    }
+
+    /* inputs, outputs and latches */
+    out.word( storage.inputs.size() );
+    out.bytes( storage.inputs.data(), storage.inputs.size() * sizeof( uint64_t ) );
+    out.word( storage.outputs.size() );
+    for ( auto const& o : storage.outputs )
+      out.word( o.data );
+    out.word( storage.data.num_pis );
+    out.word( storage.data.num_pos );
+    out.word( storage.data.trav_id );
+    out.word( storage.data.latches.size() );
+    out.bytes( storage.data.latches.data(), storage.data.latches.size() );
+    out.string( storage.net_name );
+    out.word( storage.latch_information.size() );
+    for ( auto const& [index, info] : storage.latch_information )
+    {
+      out.word( index );
+      out.word( info.init );
+      out.string( info.control );
+      out.string( info.type );
+    }
+
+    /* truth tables of k-LUT nodes, in cache order */
+    if constexpr ( kind == snapshot_kind::klut )
+    {
+      out.word( storage.data.cache.size() );
+      for ( uint32_t i = 0u; i < storage.data.cache.size(); ++i )
+      {
+        const auto tt = storage.data.cache[2u * i];
+        out.word( tt.num_vars() );
+        out.bytes( &*tt.cbegin(), tt.num_blocks() * sizeof( uint64_t ) );
+      }
+    }
+
+    /* names */
+    std::vector<std::pair<uint64_t, std::string_view>> signal_names, output_names;
+    if constexpr ( mockturtle::has_get_name_v<Ntk> )
+    {
+      ntk.foreach_signal_name( [&]( auto const& s, std::string_view name ) {
+        const uint64_t literal = ( static_cast<uint64_t>( ntk.node_to_index( ntk.get_node( s ) ) ) << 1 ) | ( ntk.is_complemented( s ) ? 1u : 0u );
+        signal_names.emplace_back( literal, name );
+      } );
+      ntk.foreach_output_name( [&]( uint32_t index, std::string_view name ) {
+        output_names.emplace_back( index, name );
+      } );
+    }
+    for ( auto const* names : {&signal_names, &output_names} )
+    {
+      out.word( names->size() );
+      for ( auto const& [key, name] : *names )
+      {
+        out.word( key );
+        out.string( name );
+      }
+    }
+
+    os.flush();
+    if ( !os.good() )
+    {
+      std::cout << "Unable to write " << filename << "\n";
+      return false;
+    }
+    return true;
+  }
+
+  /*! \brief Network type stored in a snapshot file, none if it is not a snapshot */
+  inline snapshot_kind read_snapshot_kind( std::string const& filename )
+  {
+    detail::mapped_file file( filename );
+    if ( !file.is_open() || file.end() - file.begin() < 16 || std::memcmp( file.begin(), detail::snapshot_magic, 8u ) != 0 )
+      return snapshot_kind::none;
+    detail::snapshot_reader in( file.begin() + 8, file.end() );
+    const uint64_t header = in.word();
+    if ( ( header & 0xffffffffu ) != detail::snapshot_version )
+      return snapshot_kind::none;
+    return static_cast<snapshot_kind>( header >> 32 );
+  }
+
+  /*! \brief Replaces ntk with the network stored in a snapshot file
+   *
+   * ntk must be a newly constructed network. The file is memory mapped and
+   * the storage arrays are copied out of it in bulk. Nodes are not created one by one, so no structural hashing
+   * takes place while loading; the hash table is filled afterwards in a
+   * single pass over the gates.
+   *
+   * Like read_aiger_mmap, the file is not trusted: sizes are checked against
+   * the file before anything is allocated or copied, and every node, input,
+   * output, latch and name must refer to a node of the file. Returns false on
+   * any failure, in which case ntk may hold part of the network.
+   */
+  template<class Ntk>
+  bool read_snapshot( std::string const& filename, Ntk& ntk )
+  {
+    constexpr snapshot_kind kind = detail::kind_of<Ntk>();
+    static_assert( kind != snapshot_kind::none, "Ntk is not an AIG, MIG, XAG or k-LUT network" );
+
+    if ( read_snapshot_kind( filename ) != kind )
+    {
+      std::cout << filename << " is not a snapshot of this network type\n";
+      return false;
+    }
+    detail::mapped_file file( filename );
+    detail::snapshot_reader in( file.begin() + 16, file.end() );
+    auto corrupt = [&]() {
+      std::cout << filename << ( in.good() ? " is corrupt\n" : " is truncated\n" );
+      return false;
+    };
+
+    auto& storage = *ntk._storage;
+    using node_type = typename std::decay_t<decltype( storage.nodes )>::value_type;
+    using pointer_type = typename node_type::pointer_type;
+
+    /* nodes, starting with the constants */
+    const uint64_t num_nodes = in.word();
+    if ( num_nodes < ( kind == snapshot_kind::klut ? 2u : 1u ) )
+      return corrupt();
+    if constexpr ( kind == snapshot_kind::klut )
+    {
+      /* the fanins of node i are children[offsets[i]] to children[offsets[i + 1] - 1] */
+      if ( num_nodes >= in.remaining() / sizeof( uint64_t ) )
+        return corrupt();
+      auto const* offsets = reinterpret_cast<uint64_t const*>( in.array( num_nodes + 1u, sizeof( uint64_t ) ) );
+      if ( !offsets || offsets[0] != 0u )
+        return corrupt();
+      storage.nodes.assign( num_nodes, node_type() );
+      for ( uint64_t i = 0u; i < num_nodes; ++i )
+      {
+        if ( offsets[i + 1u] < offsets[i] )
+          return corrupt();
+        const uint64_t fanin = offsets[i + 1u] - offsets[i];
+        auto const* children = reinterpret_cast<pointer_type const*>( in.array( fanin, sizeof( pointer_type ) ) );
+        if ( !children )
+          return corrupt();
+        storage.nodes[i].children.assign( children, children + fanin );
+      }
+      for ( uint64_t i = 0u; i < num_nodes; ++i )
+      {
+        auto const* data = in.bytes( sizeof( storage.nodes[i].data ) );
+        if ( !data )
+          return corrupt();
+        std::memcpy( storage.nodes[i].data.data(), data, sizeof( storage.nodes[i].data ) );
+      }
+    }
+    else
+    {
+      if ( in.word() != sizeof( node_type ) )
+      {
+        std::cout << filename << " was written with a different node layout\n";
+        return false;
+      }
+      char const* nodes = in.array( num_nodes, sizeof( node_type ) );
+      if ( !nodes )
+        return corrupt();
+      storage.nodes.resize( num_nodes );
+      std::memcpy( storage.nodes.data(), nodes, num_nodes * sizeof( node_type ) );
+    }
+
+    /* inputs, outputs and latches */
+    const uint64_t num_inputs = in.word();
+    auto const* inputs = reinterpret_cast<uint64_t const*>( in.array( num_inputs, sizeof( uint64_t ) ) );
+    if ( !inputs )
+      return corrupt();
+    storage.inputs.assign( inputs, inputs + num_inputs );
+    const uint64_t num_outputs = in.word();
+    if ( num_outputs > in.remaining() / sizeof( uint64_t ) )
+      return corrupt();
+    storage.outputs.resize( num_outputs );
+    for ( auto& o : storage.outputs )
+      o.data = in.word();
+    const uint64_t num_pis = in.word(), num_pos = in.word();
+    if ( num_pis > num_inputs || num_pos > num_outputs )
+      return corrupt();
+    storage.data.num_pis = static_cast<uint32_t>( num_pis );
+    storage.data.num_pos = static_cast<uint32_t>( num_pos );
+    storage.data.trav_id = static_cast<uint32_t>( in.word() );
+    const uint64_t num_latches = in.word();
+    auto const* latches = reinterpret_cast<int8_t const*>( in.array( num_latches, 1u ) );
+    if ( !latches || num_latches > num_inputs || num_latches > num_outputs )
+      return corrupt();
+    storage.data.latches.assign( latches, latches + num_latches );
+    storage.net_name = in.string();
+    for ( uint64_t i = in.word(); i > 0u && in.good(); --i )
+    {
+      const uint64_t index = in.word();
+      mockturtle::latch_info info;
+      info.init = in.word();
+      info.control = in.string();
+      info.type = in.string();
+      if ( index >= num_nodes )
+        return corrupt();
+      storage.latch_information[index] = info;
+    }
+
+    /* truth tables of k-LUT nodes; inserting them in order reproduces the cache literals */
+    if constexpr ( kind == snapshot_kind::klut )
+    {
+      storage.data.cache = mockturtle::truth_table_cache<kitty::dynamic_truth_table>();
+      for ( uint64_t i = in.word(); i > 0u && in.good(); --i )
+      {
+        const uint64_t num_vars = in.word();
+        if ( num_vars >= 64u )
+          return corrupt();
+        const uint64_t num_blocks = num_vars <= 6u ? 1u : uint64_t( 1u ) << ( num_vars - 6u );
+        auto const* words = reinterpret_cast<uint64_t const*>( in.array( num_blocks, sizeof( uint64_t ) ) );
+        if ( !words )
+          return corrupt();
+        kitty::dynamic_truth_table tt( static_cast<uint32_t>( num_vars ) );
+        kitty::create_from_words( tt, words, words + num_blocks );
+        storage.data.cache.insert( tt );
+      }
+    }
+
+    /* inputs are combinational inputs, all other nodes are constants or gates
+     * whose fanins (and for k-LUTs, whose function) are in the file */
+    std::vector<bool> is_input( num_nodes, false );
+    for ( auto n : storage.inputs )
+    {
+      if ( n >= num_nodes || ntk.is_constant( n ) || !ntk.is_ci( n ) )
+        return corrupt();
+      is_input[n] = true;
+    }
+    for ( uint64_t i = 0u; i < num_nodes; ++i )
+    {
+      if ( ntk.is_constant( i ) || is_input[i] )
+        continue;
+      if ( ntk.is_ci( i ) )
+        return corrupt();
+      for ( auto const& c : storage.nodes[i].children )
+      {
+        if ( c.index >= num_nodes )
+          return corrupt();
+      }
+      if constexpr ( kind == snapshot_kind::klut )
+      {
+        const auto function = storage.nodes[i].data[1].h1 >> 1;
+        if ( function >= storage.data.cache.size() || static_cast<std::size_t>( storage.data.cache[function << 1].num_vars() ) != storage.nodes[i].children.size() )
+          return corrupt();
+      }
+    }
+    for ( auto const& o : storage.outputs )
+    {
+      if ( o.index >= num_nodes )
+        return corrupt();
+    }
+
+    /* names */
+    for ( uint64_t i = in.word(); i > 0u && in.good(); --i )
+    {
+      const uint64_t literal = in.word();
+      const std::string name = in.string();
+      if ( ( literal >> 1 ) >= num_nodes )
+        return corrupt();
+      if constexpr ( mockturtle::has_set_name_v<Ntk> )
+      {
+        const auto s = ntk.make_signal( ntk.index_to_node( literal >> 1 ) );
+        ntk.set_name( ( literal & 1u ) ? ntk.create_not( s ) : s, name );
+      }
+    }
+    for ( uint64_t i = in.word(); i > 0u && in.good(); --i )
+    {
+      const uint64_t index = in.word();
+      const std::string name = in.string();
+      if ( index >= num_outputs )
+        return corrupt();
+      if constexpr ( mockturtle::has_set_output_name_v<Ntk> )
+        ntk.set_output_name( static_cast<uint32_t>( index ), name );
+    }
+
+    if ( !in.good() )
+      return corrupt();
+
+    /* structural hash table, which holds the live gates */
+    storage.hash.clear();
+    storage.hash.reserve( storage.nodes.size() );
+    ntk.foreach_node( [&]( auto const& n ) {
+      if ( ntk.is_constant( n ) || ntk.is_ci( n ) )
+        return;
+      if constexpr ( kind != snapshot_kind::klut )
+      {
+        if ( ntk.is_dead( n ) )
+          return;
+      }
+      const auto index = ntk.node_to_index( n );
+      storage.hash.insert( std::make_pair( storage.nodes[index], index ) );
+    } );
+    return true;
+  }
+
+} /* namespace oracle */
@@ -0,0 +1,201 @@
+/*!
+  \file cone_stats.hpp
+  \brief Size, depth and support of the logic cones of all outputs
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace oracle
+{
+
+  /*! \brief Statistics of the logic cone of one combinational output */
+  struct cone_stats
+  {
+    bool is_register = false; /* latch input rather than primary output */
+    uint32_t index = 0;       /* PO index, or latch index for registers */
+    uint32_t size = 0;        /* gates in the cone */
+    uint32_t depth = 0;       /* level of the driver */
+    uint32_t support = 0;     /* combinational inputs in the cone */
+  };
+
+  /*! \brief Computes the cone statistics of all combinational outputs
+   *
+   * The cone of an output is the transitive fanin of its driver, down to the
+   * combinational inputs (primary inputs and register outputs). Levels are
+   * computed for the whole network in one pass. Cones are then traversed in
+   * parallel: every thread keeps its own visited marks, tagged with an epoch
+   * that is bumped per cone, so no marks are ever cleared and the network is
+   * not modified. Outputs with the same driver share one traversal.
+   * Results are listed in output order, primary outputs first.
+   */
+  template<typename Ntk>
+  std::vector<cone_stats> compute_cone_stats( Ntk const& ntk, unsigned num_threads = std::thread::hardware_concurrency() )
+  {
+    using node = typename Ntk::node;
+    const uint32_t size = ntk.size();
+
+    auto is_leaf = [&]( node const& n ) {
+      return ntk.is_constant( n ) || ntk.is_ci( n );
+    };
+
+    std::vector<cone_stats> result;
+    std::vector<uint32_t> drivers;
+    ntk.foreach_po( [&]( auto const& f, auto i ) {
+      result.push_back( {i >= ntk.num_pos() - ntk.num_latches(), 0u, 0u, 0u, 0u} );
+      drivers.push_back( ntk.node_to_index( ntk.get_node( f ) ) );
+    } );
+    uint32_t num_registers = 0u;
+    for ( uint32_t i = 0u; i < result.size(); i++ )
+      result[i].index = result[i].is_register ? num_registers++ : i;
+
+    /* levels of the transitive fanin of all outputs, fanins first */
+    std::vector<uint32_t> levels( size, 0u );
+    std::vector<uint8_t> state( size, 0u );
+    std::vector<std::pair<uint32_t, bool>> stack;
+    for ( auto root : drivers )
+    {
+      stack.emplace_back( root, false );
+      while ( !stack.empty() )
+      {
+        const auto [index, expanded] = stack.back();
+        const node n = ntk.index_to_node( index );
+        if ( expanded )
+        {
+          stack.pop_back();
+          uint32_t level = 0u;
+          ntk.foreach_fanin( n, [&]( auto const& f ) {
+            level = std::max( level, levels[ntk.node_to_index( ntk.get_node( f ) )] + 1u );
+          } );
+          levels[index] = level;
+          state[index] = 2u;
+        }
+        else if ( state[index] != 0u )
+        {
+          stack.pop_back();
+        }
+        else if ( is_leaf( n ) )
+        {
+          stack.pop_back();
+          state[index] = 2u;
+        }
+        else
+        {
+          state[index] = 1u;
+          stack.back().second = true;
+          ntk.foreach_fanin( n, [&]( auto const& f ) {
+            const auto fanin = ntk.node_to_index( ntk.get_node( f ) );
+            if ( state[fanin] == 0u )
+              stack.emplace_back( fanin, false );
+          } );
+        }
+      }
+    }
+
+    /* one traversal per distinct driver */
+    std::vector<uint32_t> roots;
+    std::unordered_map<uint32_t, uint32_t> root_of_driver;
+    std::vector<uint32_t> root_index( drivers.size() );
+    for ( uint32_t i = 0u; i < drivers.size(); i++ )
+    {
+      const auto it = root_of_driver.emplace( drivers[i], static_cast<uint32_t>( roots.size() ) ).first;
+      if ( it->second == roots.size() )
+        roots.push_back( drivers[i] );
+      root_index[i] = it->second;
+    }
+
+    std::vector<std::pair<uint32_t, uint32_t>> counts( roots.size() );
+    std::atomic<uint32_t> next{0u};
+    auto worker = [&]() {
+      std::vector<uint32_t> visited( size, 0u );
+      std::vector<uint32_t> todo;
+      uint32_t epoch = 0u;
+      for ( uint32_t r = next++; r < roots.size(); r = next++ )
+      {
+        ++epoch;
+        uint32_t gates = 0u, support = 0u;
+        todo.assign( 1u, roots[r] );
+        visited[roots[r]] = epoch;
+        while ( !todo.empty() )
+        {
+          const auto index = todo.back();
+          todo.pop_back();
+          const node n = ntk.index_to_node( index );
+          if ( ntk.is_constant( n ) )
+            continue;
+          if ( ntk.is_ci( n ) )
+          {
+            ++support;
+            continue;
+          }
+          ++gates;
+          ntk.foreach_fanin( n, [&]( auto const& f ) {
+            const auto fanin = ntk.node_to_index( ntk.get_node( f ) );
+            if ( visited[fanin] != epoch )
+            {
+              visited[fanin] = epoch;
+              todo.push_back( fanin );
+            }
+          } );
+        }
+        counts[r] = {gates, support};
+      }
+    };
+
+    num_threads = std::max( 1u, std::min<unsigned>( num_threads, static_cast<unsigned>( roots.size() ) ) );
+    if ( num_threads <= 1u )
+    {
+      worker();
+    }
+    else
+    {
+      std::vector<std::thread> threads;
+      for ( unsigned i = 0u; i < num_threads; i++ )
+        threads.emplace_back( worker );
+      for ( auto& thread : threads )
+        thread.join();
+    }
+
+    for ( uint32_t i = 0u; i < result.size(); i++ )
+    {
+      result[i].size = counts[root_index[i]].first;
+      result[i].support = counts[root_index[i]].second;
+      result[i].depth = levels[drivers[i]];
+    }
+    return result;
+  }
+
+  /*! \brief Writes cone statistics as CSV, one line per output */
+  inline void write_cone_stats_csv( std::vector<cone_stats> const& stats, std::ostream& os )
+  {
+    os << "kind,index,size,depth,support\n";
+    for ( auto const& s : stats )
+    {
+      os << ( s.is_register ? "register," : "output," ) << s.index << ',' << s.size << ',' << s.depth << ','
+         << s.support << '\n';
+    }
+  }
+
+  /*! \brief Writes cone statistics as a JSON array of objects */
+  inline void write_cone_stats_json( std::vector<cone_stats> const& stats, std::ostream& os )
+  {
+    os << "[";
+    for ( std::size_t i = 0u; i < stats.size(); i++ )
+    {
+      auto const& s = stats[i];
+      os << ( i == 0u ? "\n" : ",\n" ) << "  {\"kind\": \"" << ( s.is_register ? "register" : "output" )
+         << "\", \"index\": " << s.index << ", \"size\": " << s.size << ", \"depth\": " << s.depth
+         << ", \"support\": " << s.support << "}";
+    }
+    os << "\n]\n";
+  }
+
+} /* namespace oracle */
@@ -13,40 +13,38 @@ namespace alice
             //opts.add_option( "--cut_size,-C", cut_size, "Max number of priority cuts [DEFAULT = 8]" );
             add_flag("--aig,-a", "Read from the stored AIG network");
             add_flag("--NPN, -n", "outputs the NPN classes that make up the function");
+            add_flag("--sc_map,-s", "Map cuts directly to the standard cells of their NPN classes instead of expanding 4-input LUTs");
+            opts.add_option( "--histogram", histogram_file, "With --NPN, also write the number of LUTs of every NPN class to a file, as JSON if it ends in .json and as CSV otherwise" );
+            opts.add_option( "--npn_library", npn_library_file, "Json file with the standard cell netlist of every NPN class (../../NPN_complete_noZero.json is default)" );
+            opts.add_option( "--npn_cache", npn_cache_file, "Binary file of NPN canonizations, read before mapping if it exists and updated afterwards" );
+            opts.add_option( "--threads,-t", num_threads, "Number of threads enumerating cuts and canonizing LUT functions (all hardware threads is default)" );
+            opts.add_option( "--liberty,-l", liberty_files, "Liberty files with the cells of the mapped netlist; reports its static timing" );
+            opts.add_option( "--clock_period,-p", clock_period, "Required time at the outputs in library time units for --liberty (latest output arrival is default)" );
         }
 
         protected:
         void execute(){
+          //an existing file that is not a cache is left untouched
+          bool save_cache = npn_cache_file != "";
+          if(save_cache && std::ifstream(npn_cache_file).good()){
+            auto& cache = oracle::npn_cache::global();
+            const auto before = cache.size();
+            save_cache = cache.load(npn_cache_file);
+            if(save_cache)
+              std::cout << "Loaded " << cache.size() - before << " NPN canonizations from " << npn_cache_file << "\n";
+          }
+          oracle::npn_cell_library const* cells = nullptr;
+          if(!is_set("NPN")){
+            cells = oracle::npn_cell_library::get(npn_library_file);
+            if(cells == nullptr){
+              std::cout << "Unable to open cell library " << npn_library_file << "\n";
+              return;
+            }
+          }
           if(is_set("NPN")){
-            std::unordered_map<std::string, int> npn_count;
             if(is_set("aig")){
               if(!store<aig_ntk>().empty()){
-                auto& aig = *store<aig_ntk>().current();
-                mockturtle::topo_view aig_topo{aig};
-                mockturtle::mapping_view <mockturtle::aig_network, true> mapped_aig{aig_topo};
-                mockturtle::lut_mapping_params ps;
-                ps.cut_enumeration_ps.cut_size = 6;
-                ps.cut_enumeration_ps.cut_limit = 6;
-                mockturtle::lut_mapping<mockturtle::mapping_view<mockturtle::aig_network, true>, true>( mapped_aig, ps );
-                const auto klut_opt = mockturtle::collapse_mapped_network<mockturtle::klut_network>( mapped_aig );
-                auto const& klut = *klut_opt;
-                klut.foreach_node( [&]( auto const n ) {
-                  if ( klut.is_constant( n ) || klut.is_pi( n ) ){
-                    return;
-                  }
-                  auto func = klut.node_function( n );
-                  auto NPNconfig = kitty::exact_npn_canonization(func);
-                  std::string tempstr = kitty::to_hex(std::get<0>(NPNconfig));
-                  if (npn_count.find(tempstr) != npn_count.end()){
-                    npn_count.at(tempstr) = npn_count.at(tempstr) + 1;
-                  } else {
-                    npn_count.insert({tempstr, 1});
-                  }
-                });
-                for(std::pair<std::string, int> npnclass : npn_count){
-                  if (npnclass.first.size() > 8)
-                    std::cout << setw(20)  << npnclass.first <<":\t"<< npnclass.second <<"\n";
-                }
+                npn_classes(*store<aig_ntk>().current());
               }
               else{
                 std::cout << "There is not an AIG network stored.\n";
@@ -55,39 +53,27 @@ namespace alice
             else{
               if(!store<mig_ntk>().empty()){
                 std::cout << "Beginning tech-mapping\n";
-                auto& mig = *store<mig_ntk>().current();
-                mockturtle::topo_view mig_topo{mig};
-                mockturtle::mapping_view <mockturtle::mig_network, true> mapped_mig{mig_topo};
-                mockturtle::lut_mapping_params ps;
-                ps.cut_enumeration_ps.cut_size = 6;
-                ps.cut_enumeration_ps.cut_limit = 6;
-                std::cout << "LUT mapping\n";
-                mockturtle::lut_mapping<mockturtle::mapping_view<mockturtle::mig_network, true>, true>( mapped_mig, ps );
-                const auto klut_opt = mockturtle::collapse_mapped_network<mockturtle::klut_network>( mapped_mig );
-                auto const& klut = *klut_opt;
-                klut.foreach_node( [&]( auto const n ) {
-                  if ( klut.is_constant( n ) || klut.is_pi( n ) ){
-                    return;
-                  }
-                  auto func = klut.node_function( n );
-                  auto NPNconfig = kitty::exact_npn_canonization(func);
-                  std::string tempstr = kitty::to_hex(std::get<0>(NPNconfig));
-                  if (npn_count.find(tempstr) != npn_count.end()){
-                    npn_count.at(tempstr) = npn_count.at(tempstr) + 1;
-                  } else {
-                    npn_count.insert({tempstr, 1});
-                  }
-                });
-                for(std::pair<std::string, int> npnclass : npn_count){
-                  if (npnclass.first.size() > 8)
-                    std::cout << setw(20)  << npnclass.first <<":\t"<< npnclass.second <<"\n";
-                }
+                npn_classes(*store<mig_ntk>().current());
               }
               else{
                 std::cout << "There is not an MIG network stored.\n";
               }
             }
           }
+          else if(is_set("sc_map")){
+            if(is_set("aig")){
+              if(!store<aig_ntk>().empty())
+                sc_map(*store<aig_ntk>().current(), *cells, "test_top");
+              else
+                std::cout << "There is not an AIG network stored.\n";
+            }
+            else{
+              if(!store<mig_ntk>().empty())
+                sc_map(*store<mig_ntk>().current(), *cells, "top");
+              else
+                std::cout << "There is not an MIG network stored.\n";
+            }
+          }
           else if(is_set("aig")){
             if(!store<aig_ntk>().empty()){
               std::cout << "Beginning tech-mapping\n";
@@ -97,16 +83,18 @@ namespace alice
               mockturtle::lut_mapping_params ps;
               ps.cut_enumeration_ps.cut_size = 4;
               ps.cut_enumeration_ps.cut_limit = 4;
+              ps.cut_enumeration_ps.num_threads = num_threads;
               std::cout << "LUT mapping\n";
               mockturtle::lut_mapping<mockturtle::mapping_view<mockturtle::aig_network, true>, true>( mapped_aig, ps );
               const auto klut_opt = mockturtle::collapse_mapped_network<mockturtle::klut_network>( mapped_aig );
               auto const& klut = *klut_opt;
               mockturtle::topo_view klut_topo{klut};
               mockturtle::write_bench(klut_topo, filename + "KLUT.bench");
-              std::tuple<mockturtle::klut_network, std::unordered_map <int, std::string>> techmap_test = oracle::techmap_mapped_network<mockturtle::klut_network>(klut_topo); 
+              std::tuple<mockturtle::klut_network, std::unordered_map <int, std::string>> techmap_test = oracle::techmap_mapped_network<mockturtle::klut_network>(klut_topo, *cells); 
               mockturtle::write_bench(std::get<0>(techmap_test), filename + "Techmapped.bench");
               std::cout << "Outputing mapped netlist\n";
               oracle::write_techmapped_verilog(std::get<0>(techmap_test), filename, std::get<1>(techmap_test), "test_top");
+              report_timing(std::get<0>(techmap_test), std::get<1>(techmap_test));
               mockturtle::write_bench(mockturtle::cleanup_dangling(std::get<0>(techmap_test)), filename + "cleanup.bench" );
               mockturtle::depth_view mapped_depth {std::get<0>(techmap_test)};
               // std::cout << "\n\nFinal network size: " << std::get<1>(techmap_test).size() << " Depth: " << mapped_depth.depth()<<"\n";
@@ -125,16 +113,18 @@ namespace alice
               mockturtle::lut_mapping_params ps;
               ps.cut_enumeration_ps.cut_size = 4;
               ps.cut_enumeration_ps.cut_limit = 4;
+              ps.cut_enumeration_ps.num_threads = num_threads;
               std::cout << "LUT mapping\n";
               mockturtle::lut_mapping<mockturtle::mapping_view<mockturtle::mig_network, true>, true>( mapped_mig, ps );
               const auto klut_opt = mockturtle::collapse_mapped_network<mockturtle::klut_network>( mapped_mig );
               auto const& klut = *klut_opt;
               mockturtle::topo_view klut_topo{klut};
               mockturtle::write_bench(klut_topo, filename + "KLUT.bench");
-              std::tuple<mockturtle::klut_network, std::unordered_map <int, std::string>> techmap_test = oracle::techmap_mapped_network<mockturtle::klut_network>(klut_topo); 
+              std::tuple<mockturtle::klut_network, std::unordered_map <int, std::string>> techmap_test = oracle::techmap_mapped_network<mockturtle::klut_network>(klut_topo, *cells); 
               mockturtle::write_bench(std::get<0>(techmap_test), filename + "Techmapped.bench");
               std::cout << "Outputing mapped netlist\n";
               oracle::write_techmapped_verilog(std::get<0>(techmap_test), filename, std::get<1>(techmap_test), "top");
+              report_timing(std::get<0>(techmap_test), std::get<1>(techmap_test));
               mockturtle::write_bench(mockturtle::cleanup_dangling(std::get<0>(techmap_test)), filename + "cleanup.bench" );
               mockturtle::depth_view mapped_depth {std::get<0>(techmap_test)};
               std::cout << "\n\nFinal network size: " << std::get<1>(techmap_test).size() << " Depth: " << mapped_depth.depth()<<"\n";
@@ -144,11 +134,98 @@ namespace alice
                 std::cout << "There is not an MIG network stored.\n";
             }
           }
-                
+          if(save_cache && !oracle::npn_cache::global().save(npn_cache_file))
+            std::cout << "Unable to write NPN cache " << npn_cache_file << "\n";
         }
 
         private:
+          /*LUT maps ntk and prints how many LUTs fall into each 6-input NPN class*/
+          template<typename Ntk>
+          void npn_classes(Ntk& ntk){
+            mockturtle::topo_view ntk_topo{ntk};
+            mockturtle::mapping_view <Ntk, true> mapped{ntk_topo};
+            mockturtle::lut_mapping_params ps;
+            ps.cut_enumeration_ps.cut_size = 6;
+            ps.cut_enumeration_ps.cut_limit = 6;
+            ps.cut_enumeration_ps.num_threads = num_threads;
+            mockturtle::lut_mapping<mockturtle::mapping_view<Ntk, true>, true>( mapped, ps );
+            const auto klut_opt = mockturtle::collapse_mapped_network<mockturtle::klut_network>( mapped );
+            const auto histogram = oracle::npn_class_histogram(*klut_opt, num_threads);
+            for(auto const& npnclass : histogram){
+              const std::string hex = kitty::to_hex(npnclass.canonical);
+              if (hex.size() > 8)
+                std::cout << setw(20)  << hex <<":\t"<< npnclass.count <<"\n";
+            }
+
+            if(histogram_file == "")
+              return;
+            std::ofstream out(histogram_file);
+            if(!out.is_open()){
+              std::cout << "Unable to open " << histogram_file << "\n";
+              return;
+            }
+            if(oracle::checkExt(histogram_file, "json"))
+              oracle::write_npn_histogram_json(histogram, out);
+            else
+              oracle::write_npn_histogram_csv(histogram, out);
+          }
+
+          /*Maps ntk with cuts matched against the NPN classes' standard cells and writes the netlist*/
+          template<typename Ntk>
+          void sc_map(Ntk const& ntk, oracle::npn_cell_library const& cells, std::string const& top){
+            std::cout << "Beginning tech-mapping\n";
+            mockturtle::sc_mapping_params ps;
+            ps.cut_enumeration_ps.cut_size = 4;
+            ps.cut_enumeration_ps.cut_limit = 8;
+            ps.cut_enumeration_ps.num_threads = num_threads;
+            mockturtle::liberty_library const* liberty = nullptr;
+            if(!liberty_files.empty() && !oracle::liberty_library_for(liberty_files).cells.empty())
+              liberty = &oracle::liberty_library_for(liberty_files);
+            mockturtle::sc_mapping_stats st;
+            std::cout << "Standard cell mapping\n";
+            auto techmapped = oracle::sc_techmap_network<mockturtle::klut_network>(ntk, cells, ps, liberty, &st);
+            std::cout << "Mapped area: " << st.area << " Delay: " << st.delay << " Cells without a match: " << st.num_unmatched << "\n";
+            mockturtle::write_bench(std::get<0>(techmapped), filename + "Techmapped.bench");
+            std::cout << "Outputing mapped netlist\n";
+            oracle::write_techmapped_verilog(std::get<0>(techmapped), filename, std::get<1>(techmapped), top);
+            report_timing(std::get<0>(techmapped), std::get<1>(techmapped));
+            mockturtle::write_bench(mockturtle::cleanup_dangling(std::get<0>(techmapped)), filename + "cleanup.bench" );
+            mockturtle::depth_view mapped_depth {std::get<0>(techmapped)};
+            std::cout << "\n\nFinal network size: " << std::get<1>(techmapped).size() << " Depth: " << mapped_depth.depth()<<"\n";
+          }
+
+          /*Static timing of the mapped netlist with the cells of the --liberty files*/
+          void report_timing(mockturtle::klut_network const& ntk, std::unordered_map<int, std::string> const& cell_names){
+            if(liberty_files.empty())
+              return;
+            auto const& library = oracle::liberty_library_for(liberty_files);
+            if(library.cells.empty()){
+              std::cout << "No cells read from the Liberty files\n";
+              return;
+            }
+            mockturtle::sta_params ps;
+            ps.clock_period = clock_period;
+            std::vector<std::string> missing;
+            const auto timing = oracle::techmap_timing(ntk, cell_names, library, ps, &missing);
+            for(auto const& cell : missing)
+              std::cout << "Cell " << cell << " is not in the Liberty library and is timed as a wire\n";
+            //"1ps" is printed as ps
+            std::string unit = library.time_unit;
+            if(unit.size() > 1 && unit[0] == '1' && std::isalpha(static_cast<unsigned char>(unit[1])))
+              unit.erase(0, 1);
+            std::cout << "Worst arrival: " << timing.worst_arrival << " " << unit << "\n";
+            std::cout << "Clock period: " << timing.clock_period << " " << unit << "\n";
+            std::cout << "Worst negative slack: " << std::min(0.0, timing.worst_slack) << " " << unit << "\n";
+            std::cout << "Total negative slack: " << timing.total_negative_slack << " " << unit << " over " << timing.num_endpoints << " outputs\n";
+          }
+
           std::string filename{};
+          std::string histogram_file{};
+          std::string npn_library_file = "../../NPN_complete_noZero.json";
+          std::string npn_cache_file{};
+          unsigned num_threads{std::thread::hardware_concurrency()};
+          std::vector<std::string> liberty_files{};
+          double clock_period{0.0};
         };
 
     ALICE_ADD_COMMAND(techmap, "Output");
@@ -0,0 +1,66 @@
+#include <alice/alice.hpp>
+
+#include <stdio.h>
+#include <fstream>
+
+#include <sys/stat.h>
+#include <stdlib.h>
+
+
+namespace alice
+{
+  /*Loads a network saved with save_snapshot into the store of its type*/
+  class load_snapshot_command : public alice::command{
+
+    public:
+      explicit load_snapshot_command( const environment::ptr& env )
+          : command( env, "Loads a network and its names from a binary snapshot file written by save_snapshot" ){
+
+        opts.add_option( "--filename,filename", filename, "Snapshot file to read in" )->required();
+      }
+
+    protected:
+      void execute(){
+        switch(oracle::read_snapshot_kind(filename)){
+          case oracle::snapshot_kind::aig:{
+            auto ntk = std::make_shared<aig_names>();
+            if(oracle::read_snapshot(filename, *ntk)){
+              store<aig_ntk>().extend() = ntk;
+              std::cout << "AIG network stored\n";
+            }
+            break;
+          }
+          case oracle::snapshot_kind::mig:{
+            auto ntk = std::make_shared<mig_names>();
+            if(oracle::read_snapshot(filename, *ntk)){
+              store<mig_ntk>().extend() = ntk;
+              std::cout << "MIG network stored\n";
+            }
+            break;
+          }
+          case oracle::snapshot_kind::xag:{
+            auto ntk = std::make_shared<xag_names>();
+            if(oracle::read_snapshot(filename, *ntk)){
+              store<xag_ntk>().extend() = ntk;
+              std::cout << "XAG network stored\n";
+            }
+            break;
+          }
+          case oracle::snapshot_kind::klut:{
+            auto ntk = std::make_shared<klut_names>();
+            if(oracle::read_snapshot(filename, *ntk)){
+              store<klut_ntk>().extend() = ntk;
+              std::cout << "KLUT network stored\n";
+            }
+            break;
+          }
+          default:
+            std::cout << filename << " is not a valid snapshot file\n";
+        }
+      }
+    private:
+      std::string filename{};
+  };
+
+  ALICE_ADD_COMMAND(load_snapshot, "Input");
+}
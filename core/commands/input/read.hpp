@@ -38,7 +38,7 @@ namespace alice
           if(is_set("mig")){
             mockturtle::mig_network ntk;
             mockturtle::names_view<mockturtle::mig_network> names_view{ntk};
-            lorina::read_aiger(filename, mockturtle::aiger_reader( names_view ));
+            oracle::read_aiger_mmap(filename, names_view);
 
             store<mig_ntk>().extend() = std::make_shared<mig_names>( names_view );
             std::cout << "MIG network stored\n";
@@ -67,7 +67,7 @@ namespace alice
           else if(is_set("xag")){
             mockturtle::xag_network ntk;
             mockturtle::names_view<mockturtle::xag_network> names_view{ntk};
-            lorina::read_aiger(filename, mockturtle::aiger_reader( names_view ));
+            oracle::read_aiger_mmap(filename, names_view);
                 
             store<xag_ntk>().extend() = std::make_shared<xag_names>( names_view );
             std::cout << "XAG network stored\n";
@@ -78,7 +78,7 @@ namespace alice
           else{
             mockturtle::aig_network ntk;
             mockturtle::names_view<mockturtle::aig_network> names_view{ntk};
-            lorina::read_aiger(filename, mockturtle::aiger_reader( names_view ));
+            oracle::read_aiger_mmap(filename, names_view);
             
             store<aig_ntk>().extend() = std::make_shared<aig_names>( names_view );
             std::cout << "AIG network stored\n";
@@ -11,6 +11,9 @@
 
 #include <stdio.h>
 #include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <thread>
 
 #include <sys/stat.h>
 #include <stdlib.h>
@@ -28,10 +31,29 @@ namespace alice
         opts.add_option( "--cut_size,-C", cut_size, "Max number of priority cuts [DEFAULT = 8]" );
         add_flag("--mig,-m", "Read from the stored MIG network");
         opts.add_option( "--out,-o", out_file, "Write LUT mapping to bench file" );
+        opts.add_option( "--sweep", sweep_sizes, "Map for every LUT size in a range or list, e.g. K=4..8 or 4,6, and print the Pareto table of LUT count against depth" );
+        opts.add_option( "--cut-limits", sweep_cut_limits, "Cut limits to sweep together with --sweep, e.g. 4,8,16 [DEFAULT = -C]" );
+        opts.add_option( "--threads,-t", num_threads, "Number of threads enumerating cuts, or mapping LUT sizes and cut limits with --sweep (all hardware threads is default)" );
       }
 
     protected:
         void execute(){
+
+          if(is_set("sweep")){
+            if(is_set("mig")){
+              if(!store<mig_ntk>().empty())
+                sweep<mockturtle::mig_network>(*store<mig_ntk>().current());
+              else
+                std::cout << "There is not an MIG network stored.\n";
+            }
+            else{
+              if(!store<aig_ntk>().empty())
+                sweep<mockturtle::aig_network>(*store<aig_ntk>().current());
+              else
+                std::cout << "There is not an AIG network stored.\n";
+            }
+            return;
+          }
             
           if(is_set("mig")){
             if(!store<mig_ntk>().empty()){
@@ -42,6 +64,7 @@ namespace alice
                 mockturtle::lut_mapping_params ps;
                 ps.cut_enumeration_ps.cut_size = lut_size;
                 ps.cut_enumeration_ps.cut_limit = cut_size;
+                ps.cut_enumeration_ps.num_threads = num_threads;
 
                 mockturtle::lut_mapping<mockturtle::mapping_view<mockturtle::mig_network, true>, true>( mapped, ps );
 
@@ -51,13 +74,12 @@ namespace alice
                 // auto const& klut = *klut_opt;
                 mockturtle::names_view<mockturtle::klut_network> names_view{*klut_opt};
 
+                names_view.share_name_pool(mig);
                 names_view.foreach_pi([&](auto pi){
-                  if(mig.has_name(mig.make_signal(pi - 1))){
-                    names_view.set_name(names_view.make_signal(pi), mig.get_name(mig.make_signal(pi - 1)));
-                  }
+                  names_view.copy_name(names_view.make_signal(pi), mig, mig.make_signal(pi - 1));
                 });
                 names_view.foreach_po([&](auto po, auto index){
-                  names_view.set_output_name(index, mig.get_output_name(index));
+                  names_view.copy_output_name(index, mig, index);
                 });
 
                 mockturtle::depth_view klut_depth{names_view};
@@ -90,6 +112,7 @@ namespace alice
               mockturtle::lut_mapping_params ps;
               ps.cut_enumeration_ps.cut_size = lut_size;
               ps.cut_enumeration_ps.cut_limit = cut_size;
+              ps.cut_enumeration_ps.num_threads = num_threads;
 
               mockturtle::lut_mapping<mockturtle::mapping_view<mockturtle::aig_network, true>, true>( mapped, ps );
 
@@ -99,13 +122,12 @@ namespace alice
               // auto const& klut = *klut_opt;
               mockturtle::names_view<mockturtle::klut_network> names_view{*klut_opt};
 
+              names_view.share_name_pool(aig);
               names_view.foreach_pi([&](auto pi){
-                if(aig.has_name(aig.make_signal(pi - 1))){
-                  names_view.set_name(names_view.make_signal(pi), aig.get_name(aig.make_signal(pi - 1)));
-                }
+                names_view.copy_name(names_view.make_signal(pi), aig, aig.make_signal(pi - 1));
               });
               names_view.foreach_po([&](auto po, auto index){
-                names_view.set_output_name(index, aig.get_output_name(index));
+                names_view.copy_output_name(index, aig, index);
               });
 
               mockturtle::depth_view klut_depth{names_view};
@@ -138,9 +160,90 @@ namespace alice
           }
         }    
     private:
+      /* parses "4..8", "K=4..8" or "4,6,8" (ranges and values may be mixed) */
+      static std::vector<uint32_t> parse_values(std::string spec){
+        std::vector<uint32_t> values;
+        if(spec.size() > 1 && spec[1] == '=')
+          spec = spec.substr(2);
+        std::stringstream ss(spec);
+        std::string item;
+        while(std::getline(ss, item, ',')){
+          const auto dots = item.find("..");
+          try{
+            if(dots == std::string::npos){
+              values.push_back(std::stoul(item));
+            }
+            else{
+              const auto last = std::stoul(item.substr(dots + 2));
+              for(auto v = std::stoul(item.substr(0, dots)); v <= last; v++)
+                values.push_back(v);
+            }
+          }
+          catch(std::exception const&){
+            return {};
+          }
+        }
+        return values;
+      }
+
+      template<typename Ntk, typename NamedNtk>
+      void sweep(NamedNtk const& ntk){
+        const auto lut_sizes = parse_values(sweep_sizes);
+        const auto cut_limits = is_set("cut-limits") ? parse_values(sweep_cut_limits) : std::vector<uint32_t>{uint32_t(cut_size)};
+        if(lut_sizes.empty() || cut_limits.empty()){
+          std::cout << "Not valid sweep ranges\n";
+          return;
+        }
+        for(auto k : lut_sizes){
+          if(k < Ntk::max_fanin_size || k > 16){
+            std::cout << "LUT sizes must be between " << Ntk::max_fanin_size << " and 16\n";
+            return;
+          }
+        }
+        for(auto c : cut_limits){
+          if(c < 2 || c > 25){
+            std::cout << "Cut limits must be between 2 and 25\n";
+            return;
+          }
+        }
+
+        const auto result = oracle::lut_sweep<Ntk>(ntk, lut_sizes, cut_limits, num_threads);
+        std::cout << "   K    C       LUT    lev    #LUT Level Product\n";
+        for(auto const& p : result.points){
+          std::cout << (p.pareto ? "*" : " ") << std::setw(3) << p.lut_size << std::setw(5) << p.cut_limit
+                    << std::setw(10) << p.luts << std::setw(7) << p.depth << std::setw(22) << uint64_t(p.luts) * p.depth << "\n";
+        }
+        auto const& best = result.points[result.best_point];
+        std::cout << "* = Pareto optimal, best #LUT Level Product with K = " << best.lut_size << " C = " << best.cut_limit << "\n";
+
+        if(out_file != ""){
+          mockturtle::names_view<mockturtle::klut_network> names_view{*result.best};
+          names_view.share_name_pool(ntk);
+          names_view.foreach_pi([&](auto pi){
+            names_view.copy_name(names_view.make_signal(pi), ntk, ntk.make_signal(pi - 1));
+          });
+          names_view.foreach_po([&](auto, auto index){
+            names_view.copy_output_name(index, ntk, index);
+          });
+          std::cout << "filename = " << out_file << "\n";
+          if(oracle::checkExt(out_file, "bench")){
+            mockturtle::write_bench(names_view, out_file);
+          }
+          else if(oracle::checkExt(out_file, "blif")){
+            mockturtle::write_blif(names_view, out_file);
+          }
+          else{
+            std::cout << "Not valid output file\n";
+          }
+        }
+      }
+
       int lut_size = 6;
       int cut_size = 8;
       std::string out_file = "";
+      std::string sweep_sizes = "";
+      std::string sweep_cut_limits = "";
+      unsigned num_threads = std::thread::hardware_concurrency();
     };
 
   ALICE_ADD_COMMAND(lut_map, "LUT");
@@ -24,6 +24,7 @@ namespace alice
                 : command( env, "Perform AIG based optimization script" ){
 
                 opts.add_option( "--strategy", strategy, "Optimization strategy [0-4]" );
+                opts.add_option( "--threads,-t", num_threads, "Number of threads enumerating cuts in the cut rewriting passes of strategies 0-3 (1 is the default)" );
         }
 
     protected:
@@ -43,24 +44,28 @@ namespace alice
             case 0:
             {
               oracle::aig_script aigopt;
+              aigopt.num_threads = num_threads;
               opt = aigopt.run(opt);
             }
             break;
             case 1:
             {
               oracle::aig_script2 aigopt;
+              aigopt.num_threads = num_threads;
               opt = aigopt.run(opt);
             }
             break;
             case 2:
             {
               oracle::aig_script3 aigopt;
+              aigopt.num_threads = num_threads;
               opt = aigopt.run(opt);
             }
             break;
             case 3:
             {
               oracle::aig_script4 aigopt;
+              aigopt.num_threads = num_threads;
               opt = aigopt.run(opt);
             }
             break;
@@ -90,6 +95,7 @@ namespace alice
       }
     private:
         unsigned strategy{0u};
+        unsigned num_threads{1u};
     };
 
   ALICE_ADD_COMMAND(aigscript, "Optimization");
@@ -25,6 +25,7 @@ namespace alice
                 : command( env, "Perform cut rewriting on stored network" ){
 
                 opts.add_option( "--cut_size,-c", cut_size, "Cut size (4 is the default)" );
+                opts.add_option( "--threads,-t", num_threads, "Number of threads enumerating cuts (1 is the default)" );
                 add_flag("--mig,-m", "Performs cut rewriting on stored MIG network (AIG is default)");
         }
 
@@ -40,6 +41,7 @@ namespace alice
             mockturtle::mig_npn_resynthesis resyn;
             mockturtle::cut_rewriting_params ps;
             ps.cut_enumeration_ps.cut_size = cut_size;
+            ps.cut_enumeration_ps.num_threads = num_threads;
 
             mockturtle::cut_rewriting(ntk_mig, resyn, ps);
             ntk_mig = mockturtle::cleanup_dangling(ntk_mig);
@@ -54,6 +56,7 @@ namespace alice
             mockturtle::xag_npn_resynthesis<mockturtle::aig_network> resyn;
             mockturtle::cut_rewriting_params ps;
             ps.cut_enumeration_ps.cut_size = cut_size;
+            ps.cut_enumeration_ps.num_threads = num_threads;
 
             mockturtle::cut_rewriting(ntk_aig, resyn, ps);
             // ntk_aig.foreach_pi([&](auto pi){
@@ -80,6 +83,7 @@ namespace alice
       }
     private:
         int cut_size = 4;
+        unsigned num_threads = 1;
     };
 
   ALICE_ADD_COMMAND(cut_rewriting, "Optimization");
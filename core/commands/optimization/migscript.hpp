@@ -24,6 +24,7 @@ namespace alice
                 : command( env, "Perform MIG based optimization script" ){
 
                 opts.add_option( "--strategy", strategy, "Optimization strategy [0-2]" );
+                opts.add_option( "--threads,-t", num_threads, "Number of threads enumerating cuts for cut rewriting (1 is the default)" );
         }
 
     protected:
@@ -43,18 +44,21 @@ namespace alice
             case 0:
             {
               oracle::mig_script migopt;
+              migopt.num_threads = num_threads;
               opt = migopt.run(opt);
             }
             break;
             case 1:
             {
               oracle::mig_script2 migopt;
+              migopt.num_threads = num_threads;
               opt = migopt.run(opt);
             }
             break;
             case 2:
             {
               oracle::mig_script3 migopt;
+              migopt.num_threads = num_threads;
               opt = migopt.run(opt);
             }
             break;
@@ -78,6 +82,7 @@ namespace alice
       }
     private:
         unsigned strategy{0u};
+        unsigned num_threads{1u};
     };
 
   ALICE_ADD_COMMAND(migscript, "Optimization");
@@ -11,6 +11,7 @@
 
 #include <stdio.h>
 #include <fstream>
+#include <memory>
 
 #include <sys/stat.h>
 #include <stdlib.h>
@@ -29,18 +30,26 @@ namespace alice
                 opts.add_option( "--nn_model,-n", nn_model, "Trained neural network model for classification" );
                 opts.add_option( "--out,-o", out_file, "output file to write resulting network to [.v, .blif]" );
                 opts.add_option( "--strategy,-s", strategy, "classification strategy [area delay product{DEFAULT}=0, area=1, delay=2]" );
-                // add_flag("--bipart,-g", "Use BiPart from the Galois system for partitioning");
+                opts.add_option( "--threads,-t", num_threads, "Number of threads used to optimize partitions in parallel and to partition with bipart (1 is default)" );
+                opts.add_option( "--engine,-e", engine_name, "Hypergraph partitioner, kahypar or bipart (kahypar is default)" );
+                opts.add_option( "--cache_size", cache_size, "Maximum number of optimized nodes kept to reuse partitions across runs (1048576 is default, 0 keeps none)" );
                 add_flag("--aig,-a", "Perform only AIG optimization on all partitions");
                 add_flag("--mig,-m", "Perform only MIG optimization on all partitions");
                 add_flag("--combine,-c", "Combine adjacent partitions that have been classified for the same optimization");
                 add_flag("--skip-feedthrough", "Do not include feedthrough nets when writing out the file");
+                add_flag("--in_place,-i", "Build the result directly from the optimized partitions instead of from an MIG copy of the network, keeping no replaced logic");
         }
 
     protected:
       void execute(){
 
+        oracle::partition_engine engine;
+        if(!oracle::parse_partition_engine(engine_name, engine)){
+          std::cout << "Unknown partitioning engine " << engine_name << ", use kahypar or bipart\n";
+          return;
+        }
         if(!store<aig_ntk>().empty()){
-          auto ntk = *store<aig_ntk>().current();
+          auto& ntk = *store<aig_ntk>().current();
           //If number of partitions is not specified
           if(num_partitions == 0){
             double size = ( (double) ntk.size() ) / 300.0;
@@ -48,7 +57,7 @@ namespace alice
           }
 
           mockturtle::depth_view orig_depth{ntk};
-          oracle::partition_manager<aig_names> partitions(ntk, num_partitions);
+          oracle::partition_manager<aig_names> partitions(ntk, num_partitions, "../../core/test.ini", "", engine, num_threads);
           store<part_man_aig_ntk>().extend() = std::make_shared<part_man_aig>( partitions );
 
           std::cout << ntk._storage->net_name << " partitioned " << num_partitions << " times\n";
@@ -63,10 +72,19 @@ namespace alice
           if(is_set("combine"))
             combine = true;
 
+          //results only depend on the partition structure and would be valid for any
+          //network, but the cache is cleared whenever another network is optimized so
+          //that it only grows with the partitions of one design
+          if(cached_storage.lock() != ntk._storage){
+            cache.clear();
+            cached_storage = ntk._storage;
+          }
+          cache.set_max_nodes(cache_size);
+
           auto start = std::chrono::high_resolution_clock::now();
 
           auto ntk_mig = oracle::optimization_test(ntk, partitions, strategy, nn_model, 
-            high, aig, mig, combine);
+            high, aig, mig, combine, num_threads, is_set("in_place"), &cache);
 
           auto stop = std::chrono::high_resolution_clock::now();
 
@@ -119,10 +137,15 @@ namespace alice
       std::string nn_model{};
       std::string out_file{};
       unsigned strategy{0u};
+      unsigned num_threads{1u};
+      std::string engine_name = "kahypar";
       bool high = false;
       bool aig = false;
       bool mig = false;
       bool combine = false;
+      std::size_t cache_size{oracle::optimization_cache::default_max_nodes};
+      oracle::optimization_cache cache;
+      std::weak_ptr<aig_names::storage::element_type> cached_storage;
     };
 
   ALICE_ADD_COMMAND(oracle, "Optimization");
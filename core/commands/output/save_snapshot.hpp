@@ -0,0 +1,57 @@
+#include <alice/alice.hpp>
+
+#include <stdio.h>
+#include <fstream>
+
+#include <sys/stat.h>
+#include <stdlib.h>
+
+
+namespace alice
+{
+  /*Saves a stored network and its names into a binary snapshot that load_snapshot reads back*/
+  class save_snapshot_command : public alice::command{
+
+    public:
+      explicit save_snapshot_command( const environment::ptr& env )
+          : command( env, "Saves the stored network and its names into a binary snapshot file" ){
+
+        opts.add_option( "--filename,filename", filename, "Snapshot file to write out to" )->required();
+        add_flag("--mig,-m", "Save the stored MIG network (AIG network is default)");
+        add_flag("--xag,-x", "Save the stored XAG network (AIG network is default)");
+        add_flag("--klut,-k", "Save the stored KLUT network (AIG network is default)");
+      }
+
+    protected:
+      void execute(){
+        if(is_set("mig")){
+          if(!store<mig_ntk>().empty())
+            oracle::write_snapshot(*store<mig_ntk>().current(), filename);
+          else
+            std::cout << "There is not an MIG network stored.\n";
+        }
+        else if(is_set("xag")){
+          if(!store<xag_ntk>().empty())
+            oracle::write_snapshot(*store<xag_ntk>().current(), filename);
+          else
+            std::cout << "There is not an XAG network stored.\n";
+        }
+        else if(is_set("klut")){
+          if(!store<klut_ntk>().empty())
+            oracle::write_snapshot(*store<klut_ntk>().current(), filename);
+          else
+            std::cout << "There is not a KLUT network stored.\n";
+        }
+        else{
+          if(!store<aig_ntk>().empty())
+            oracle::write_snapshot(*store<aig_ntk>().current(), filename);
+          else
+            std::cout << "There is not an AIG network stored.\n";
+        }
+      }
+    private:
+      std::string filename{};
+  };
+
+  ALICE_ADD_COMMAND(save_snapshot, "Output");
+}
@@ -40,7 +40,8 @@ namespace alice
 
             oracle::hypergraph<mig_names> t(ntk);
             t.get_hypergraph(ntk);
-            t.dump(filename);
+            if(!t.dump(filename))
+              std::cout << "Unable to write hypergraph to " << filename << "\n";
           }
           else{
             std::cout << filename << " is not a valid hpg file\n";
@@ -59,7 +60,8 @@ namespace alice
 
             oracle::hypergraph<aig_names> t(ntk);
             t.get_hypergraph(ntk);
-            t.dump(filename);
+            if(!t.dump(filename))
+              std::cout << "Unable to write hypergraph to " << filename << "\n";
 
           }
           else{
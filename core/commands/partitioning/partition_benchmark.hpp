@@ -0,0 +1,98 @@
+#include <alice/alice.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <thread>
+#include <vector>
+
+
+namespace alice
+{
+  /*Partitions the hypergraph of the stored network with KaHyPar and BiPart and compares cut and runtime*/
+  class partition_benchmark_command : public alice::command{
+
+    public:
+      explicit partition_benchmark_command( const environment::ptr& env )
+        : command( env, "Compares cut quality and runtime of the KaHyPar and BiPart partitioners on the stored network" ) {
+
+          opts.add_option( "--num,num", num_partitions, "Number of desired partitions" )->required();
+          opts.add_option( "--config_direc,-c", config_direc, "Path to the configuration file for KaHyPar (../../core/test.ini is default)" );
+          opts.add_option( "--threads,-t", num_threads, "Number of threads used by bipart, which also runs on one thread (all hardware threads is default)" );
+          add_flag("--mig,-m", "Partitions stored MIG network (AIG network is default)");
+          add_flag("--skip-kahypar", "Only run BiPart");
+        }
+
+    protected:
+      void execute(){
+        if(is_set("mig")){
+          if(!store<mig_ntk>().empty())
+            run(*store<mig_ntk>().current());
+          else
+            std::cout << "MIG network not stored\n";
+        }
+        else{
+          if(!store<aig_ntk>().empty())
+            run(*store<aig_ntk>().current());
+          else
+            std::cout << "AIG network not stored\n";
+        }
+      }
+
+    private:
+      template<typename Ntk>
+      void run(Ntk const& ntk){
+        if(num_partitions < 2){
+          std::cout << "At least 2 partitions are needed\n";
+          return;
+        }
+        oracle::hypergraph<Ntk> t(ntk);
+        t.get_hypergraph(ntk);
+        auto const& offsets = t.get_offsets();
+        auto const& pins = t.get_pins();
+        const uint32_t num_vertices = t.get_num_vertices();
+        std::cout << "Hypergraph with " << num_vertices << " vertices and " << t.get_num_edges() << " hyperedges into " << num_partitions << " partitions\n";
+        std::cout << std::setw(10) << "engine" << std::setw(9) << "threads" << std::setw(10) << "km1" << std::setw(10) << "cut"
+                  << std::setw(12) << "max part" << std::setw(12) << "seconds" << "\n";
+
+        auto report = [&](std::string const& engine, unsigned threads, std::vector<uint32_t> const& partition, double seconds){
+          std::vector<uint32_t> sizes(num_partitions, 0u);
+          for(auto part : partition)
+            ++sizes[part];
+          std::cout << std::setw(10) << engine << std::setw(9) << threads << std::setw(10) << oracle::hypergraph_km1(offsets, pins, partition)
+                    << std::setw(10) << oracle::hypergraph_cut(offsets, pins, partition) << std::setw(12) << *std::max_element(sizes.begin(), sizes.end())
+                    << std::setw(12) << std::fixed << std::setprecision(3) << seconds << "\n";
+        };
+        auto elapsed = [](auto start){
+          return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        };
+
+        if(!is_set("skip-kahypar")){
+          const auto start = std::chrono::steady_clock::now();
+          const auto partition = oracle::partition_kahypar(num_vertices, offsets, pins, num_partitions, config_direc);
+          report("kahypar", 1u, partition, elapsed(start));
+        }
+
+        std::vector<uint32_t> single;
+        for(unsigned threads : {1u, std::max(num_threads, 1u)}){
+          if(threads == 1u && !single.empty())
+            break;
+          oracle::bipart_params ps;
+          ps.num_threads = threads;
+          const auto start = std::chrono::steady_clock::now();
+          const auto partition = oracle::bipart(num_vertices, offsets, pins, num_partitions, ps);
+          report("bipart", threads, partition, elapsed(start));
+          if(single.empty())
+            single = partition;
+          else if(partition != single)
+            std::cout << "BiPart partitions differ between 1 and " << threads << " threads\n";
+        }
+      }
+
+      int num_partitions{};
+      std::string config_direc = "../../core/test.ini";
+      unsigned num_threads{std::thread::hardware_concurrency()};
+  };
+
+  ALICE_ADD_COMMAND(partition_benchmark, "Partitioning");
+}
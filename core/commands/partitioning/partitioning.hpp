@@ -14,7 +14,7 @@
 
 #include <sys/stat.h>
 #include <stdlib.h>
-// #include <utah/BiPart.h>
+#include <thread>
 
 
 namespace alice
@@ -38,12 +38,19 @@ namespace alice
           opts.add_option( "--num,num", num_partitions, "Number of desired partitions" )->required();
           opts.add_option( "--config_direc,-c", config_direc, "Path to the configuration file for KaHyPar (../../core/test.ini is default)" );
           opts.add_option("--file,-f", part_file, "External file containing partitiion information");
+          opts.add_option("--dump-hypergraph", hypergraph_file, "Also write the hypergraph given to KaHyPar to this file (hMETIS format)");
           add_flag("--mig,-m", "Partitions stored MIG network (AIG network is default)");
-          // add_flag("--bipart,-g", "Run hypergraph partitionining using BiPart from the Galois system");
+          opts.add_option("--engine,-e", engine_name, "Hypergraph partitioner, kahypar or bipart (kahypar is default)");
+          opts.add_option("--threads,-t", num_threads, "Number of threads used by bipart (all hardware threads is default); the partition is the same for any number");
         }
 
     protected:
       void execute(){
+        oracle::partition_engine engine;
+        if(!oracle::parse_partition_engine(engine_name, engine)){
+          std::cout << "Unknown partitioning engine " << engine_name << ", use kahypar or bipart\n";
+          return;
+        }
         mockturtle::mig_npn_resynthesis resyn_mig;
         mockturtle::xag_npn_resynthesis<mockturtle::aig_network> resyn_aig;
         
@@ -78,37 +85,10 @@ namespace alice
               }
             }
             else{
-              // if(is_set("bipart")){
-              //   std::cout << "Partitioning stored MIG network using Galois BiPart\n";
-              //   oracle::hypergraph<mig_names> t(ntk);
-              //   uint32_t num_vertices = 0;
-          
-              //   t.get_hypergraph(ntk);
-              //   std::vector<std::vector<uint32_t>> hedges = t.get_hyperedges();
-              //   num_vertices = t.get_num_vertices();
-
-              //   int num_threads = 14;
-              //   scheduleMode mode = PP;
-              //   std::map<int, int> bipart = biparting(hedges, num_vertices, num_partitions, num_threads, mode);
-              //   std::map<mockturtle::mig_network::node, int> part_data;
-              //   ntk.foreach_node([&](auto node){
-              //     part_data[node] = bipart[node];
-              //   });
-
-              //   oracle::partition_manager<mig_names> partitions(ntk, part_data, num_partitions);
-              //   store<part_man_mig_ntk>().extend() = std::make_shared<part_man_mig>( partitions );
-              // }
-              // else{
-                std::cout << "Partitioning stored MIG network using KaHyPar\n";
-                if(config_direc != ""){
-                  oracle::partition_manager<mig_names> partitions(ntk, num_partitions, config_direc);
-                  store<part_man_mig_ntk>().extend() = std::make_shared<part_man_mig>( partitions );
-                }
-                else{
-                  oracle::partition_manager<mig_names> partitions(ntk, num_partitions);
-                  store<part_man_mig_ntk>().extend() = std::make_shared<part_man_mig>( partitions );
-                }
-              //}
+                std::cout << "Partitioning stored MIG network using " << (engine == oracle::partition_engine::bipart ? "BiPart" : "KaHyPar") << "\n";
+                oracle::partition_manager<mig_names> partitions(ntk, num_partitions, config_direc != "" ? config_direc : default_config,
+                  hypergraph_file, engine, num_threads);
+                store<part_man_mig_ntk>().extend() = std::make_shared<part_man_mig>( partitions );
             }
           }
           else{
@@ -146,37 +126,10 @@ namespace alice
               }
             }
             else{
-              // if(is_set("bipart")){
-              //   std::cout << "Partitioning stored AIG network using Galois BiPart\n";
-              //   oracle::hypergraph<aig_names> t(ntk);
-              //   uint32_t num_vertices = 0;
-          
-              //   t.get_hypergraph(ntk);
-              //   std::vector<std::vector<uint32_t>> hedges = t.get_hyperedges();
-              //   num_vertices = t.get_num_vertices();
-
-              //   int num_threads = 14;
-              //   scheduleMode mode = PP;
-              //   std::map<int, int> bipart = biparting(hedges, num_vertices, num_partitions, num_threads, mode);
-              //   std::map<mockturtle::aig_network::node, int> part_data;
-              //   ntk.foreach_node([&](auto node){
-              //     part_data[node] = bipart[node];
-              //   });
-
-              //   oracle::partition_manager<aig_names> partitions(ntk, part_data, num_partitions);
-              //   store<part_man_aig_ntk>().extend() = std::make_shared<part_man_aig>( partitions );
-              // }
-              // else{
-                std::cout << "Partitioning stored AIG network using KaHyPar\n";
-                if(config_direc != ""){
-                  oracle::partition_manager<aig_names> partitions(ntk, num_partitions, config_direc);
-                  store<part_man_aig_ntk>().extend() = std::make_shared<part_man_aig>( partitions );
-                }
-                else{
-                  oracle::partition_manager<aig_names> partitions(ntk, num_partitions);
-                  store<part_man_aig_ntk>().extend() = std::make_shared<part_man_aig>( partitions );
-                }
-              //}
+                std::cout << "Partitioning stored AIG network using " << (engine == oracle::partition_engine::bipart ? "BiPart" : "KaHyPar") << "\n";
+                oracle::partition_manager<aig_names> partitions(ntk, num_partitions, config_direc != "" ? config_direc : default_config,
+                  hypergraph_file, engine, num_threads);
+                store<part_man_aig_ntk>().extend() = std::make_shared<part_man_aig>( partitions );
             }
           }
           else{
@@ -188,6 +141,10 @@ namespace alice
       int num_partitions{};
       std::string config_direc = "";
       std::string part_file = "";
+      std::string hypergraph_file = "";
+      std::string engine_name = "kahypar";
+      unsigned num_threads{std::thread::hardware_concurrency()};
+      const std::string default_config = "../../core/test.ini";
   };
 
   ALICE_ADD_COMMAND(partitioning, "Partitioning");
@@ -43,7 +43,7 @@ namespace alice
             auto ntk = *store<mig_ntk>().current();
 
             oracle::slack_view<mig_names> slack{ntk};
-            auto critical_path = slack.get_critical_path( ntk );
+            auto critical_path = slack.get_critical_path();
             int maj_num = 0;
             int and_num = 0;
             int input_num = 0;
@@ -386,7 +386,7 @@ namespace oracle
 
     double attraction( Ntk const& ntk, node curr_node, cluster<Ntk> curr_cluster ){
 
-      int net_intersec = curr_cluster.num_intersec(ntk, curr_node);
+      int net_intersec = curr_cluster.num_intersec(curr_node);
 
       oracle::slack_view<Ntk> slack_view(ntk);
       mockturtle::fanout_view<Ntk> fanout(ntk);
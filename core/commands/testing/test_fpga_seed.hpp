@@ -30,6 +30,7 @@ class fpga_seed_partitioning_command : public alice::command{
             opts.add_option( "--num_pis,-p", num_pis, "Number of PIs constraint" );
             opts.add_option( "--num_int,-i", num_int, "Number of internal nodes constraint" );
             add_flag("--mig,-m", "Use fpga seed partitioning on stored MIG network (AIG is default)");
+            add_flag("--verbose,-v", "List the nodes of every partition");
     }
 
   protected:
@@ -37,7 +38,7 @@ class fpga_seed_partitioning_command : public alice::command{
       if(is_set("mig")){
         if(!store<mockturtle::mig_network>().empty()){
           auto ntk = store<mockturtle::mig_network>().current();
-          oracle::fpga_seed_partitioner<mockturtle::mig_network> partitioner(ntk, net_delay, max_net, num_pis, num_int);
+          oracle::fpga_seed_partitioner<mockturtle::mig_network> partitioner(ntk, net_delay, max_net, num_pis, num_int, is_set("verbose"));
           oracle::partition_manager<mockturtle::mig_network> part_man = partitioner.create_part_man(ntk);
           store<oracle::partition_manager<mockturtle::mig_network>>().extend() = part_man;
           
@@ -50,7 +51,7 @@ class fpga_seed_partitioning_command : public alice::command{
         if(!store<mockturtle::aig_network>().empty()){
           auto ntk = store<mockturtle::aig_network>().current();
           auto start = std::chrono::high_resolution_clock::now();
-          oracle::fpga_seed_partitioner<mockturtle::aig_network> partitioner(ntk, net_delay, max_net, num_pis, num_int);
+          oracle::fpga_seed_partitioner<mockturtle::aig_network> partitioner(ntk, net_delay, max_net, num_pis, num_int, is_set("verbose"));
           auto stop = std::chrono::high_resolution_clock::now();
           auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(stop - start);
           std::cout << "Partitioning time: " << duration.count() << "ms\n";
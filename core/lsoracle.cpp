@@ -6,16 +6,17 @@
 #include <alice/alice.hpp>
 #include <mockturtle/mockturtle.hpp>
 #include <libkahypar.h>
-// #include <utah/BiPart.h>
 
 /*** Algorithms ***/
 #include "algorithms/partitioning/partition_view.hpp"
 #include "algorithms/partitioning/hyperg.hpp"
+#include "algorithms/partitioning/bipart.hpp"
 #include "utility.hpp"
 #include "algorithms/partitioning/partition_manager.hpp"
 #include "algorithms/partitioning/cluster.hpp"
 #include "algorithms/partitioning/seed_partitioner.hpp"
 #include "algorithms/partitioning/fpga_seed_partitioner.hpp"
+#include "algorithms/partitioning/timing_engine.hpp"
 #include "algorithms/partitioning/slack_view.hpp"
 #include "algorithms/optimization/rw_script.hpp"
 #include "algorithms/optimization/aig_script.hpp"
@@ -28,10 +29,20 @@
 #include "algorithms/optimization/mig_script3.hpp"
 #include "algorithms/optimization/test_script.hpp"
 #include "algorithms/optimization/optimization.hpp"
+#include "algorithms/optimization/optimization_cache.hpp"
+#include "algorithms/optimization/partition_assembly.hpp"
 #include "algorithms/optimization/optimization_test.hpp"
+#include "algorithms/input/aiger_mmap.hpp"
 #include "algorithms/output/verilog.hpp"
+#include "algorithms/snapshot/snapshot.hpp"
+#include "algorithms/stats/cone_stats.hpp"
+#include "algorithms/lut_mapping/lut_sweep.hpp"
+#include "algorithms/asic_mapping/npn_cache.hpp"
+#include "algorithms/asic_mapping/npn_cell_library.hpp"
 #include "algorithms/asic_mapping/techmapping.hpp"
+#include "algorithms/asic_mapping/sc_techmapping.hpp"
 #include "algorithms/output/mapped_verilog.hpp"
+#include "algorithms/asic_mapping/techmap_timing.hpp"
 
 /*** Stores ***/
 #include "store/aig.hpp"
@@ -46,6 +57,7 @@
 #include "commands/input/read_blif.hpp"
 #include "commands/input/read_verilog.hpp"
 #include "commands/input/read_bench.hpp"
+#include "commands/input/load_snapshot.hpp"
 
 //LUT_Map
 #include "commands/lut_map/lut_map.hpp"
@@ -60,6 +72,7 @@
 #include "commands/output/disjoint_clouds.hpp"
 #include "commands/output/get_all_partitions.hpp"
 #include "commands/output/print_karnaugh_map.hpp"
+#include "commands/output/save_snapshot.hpp"
 
 //Stats
 #include "commands/stats/crit_path_stats.hpp"
@@ -70,6 +83,7 @@
 //Partitioning
 #include "commands/partitioning/partitioning.hpp"
 #include "commands/partitioning/partition_detail.hpp"
+#include "commands/partitioning/partition_benchmark.hpp"
 
 //Classification
 #include "commands/classification/generate_truth_tables.hpp"
@@ -11,6 +11,13 @@
 
 #include <stdio.h>
 #include <fstream>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 
 #include <sys/stat.h>
 #include <stdlib.h>
@@ -23,73 +30,46 @@ namespace oracle
   using mig_names = mockturtle::names_view<mockturtle::mig_network>;
   using mig_ntk = std::shared_ptr<mig_names>;
 
-  template<typename Ntk>
-  int computeLevel( Ntk const& ntk, int index ) {
-	 //if node not visited
-    if(ntk._storage->nodes[index].data[1].h1==0) {
-
-      //set node as visited
-      ntk._storage->nodes[index].data[1].h1=1;
-
-      //if is input
-      if (ntk.is_ci(index)) {
-        return 0;
-      }
-
-  		auto inIdx2 = ntk._storage->nodes[index].children[1].data;
-  		if (inIdx2 & 1)
-  			inIdx2 = inIdx2 - 1;
-
-  		//calculate input node index
-  		auto inNode1 = inIdx2 >> 1;
-  		int levelNode1 = computeLevel(ntk, inNode1);
-
-      auto inIdx = ntk._storage->nodes[index].children[0].data;
-      if (inIdx & 1)
-          inIdx = inIdx - 1;
-
-      //calculate input node index
-      auto inNode0 = inIdx >> 1;
-      int levelNode0 = computeLevel(ntk, inNode0);
-
-      int level = 1 + std::max(levelNode0, levelNode1);
-      return level;
-    } 
-    return 0;
-  }
-
-  template<typename Ntk>
-  int computeLevel( Ntk const& ntk, typename Ntk::node curr_node, std::set<typename Ntk::node> partition_inputs ) {
-    //if node not visited
-    if(ntk._storage->nodes[curr_node].data[1].h1==0 && !ntk.is_constant(curr_node))  {
-      //set node as visited
-      ntk._storage->nodes[curr_node].data[1].h1=1;
-      //if is input
-      if (partition_inputs.find(curr_node) != partition_inputs.end()) {
-        return 0;
+  /* Level of every node in the fanin cones of roots. Leaves, constants and
+   * combinational inputs are on level 0, every other node is one level above
+   * its deepest fanin. The cones are traversed iteratively and every node is
+   * expanded once, so the cost is linear in the size of the cones. */
+  template<typename Ntk, typename Nodes>
+  std::unordered_map<typename Ntk::node, int> compute_levels( Ntk const& ntk, Nodes const& roots,
+                                                             std::set<typename Ntk::node> const& leaves = {} ) {
+    using node = typename Ntk::node;
+    std::unordered_map<node, int> levels;
+    std::vector<std::pair<node, bool>> stack;
+
+    for(auto root : roots){
+      stack.emplace_back(root, false);
+      while(!stack.empty()){
+        const auto curr_node = stack.back().first;
+        if(stack.back().second){
+          stack.pop_back();
+          int level = 0;
+          ntk.foreach_fanin(curr_node, [&](auto const& f){
+            level = std::max(level, levels[ntk.get_node(f)] + 1);
+          });
+          levels[curr_node] = level;
+        }
+        else if(levels.find(curr_node) != levels.end()){
+          stack.pop_back();
+        }
+        else if(ntk.is_constant(curr_node) || ntk.is_ci(curr_node) || leaves.find(curr_node) != leaves.end()){
+          stack.pop_back();
+          levels[curr_node] = 0;
+        }
+        else{
+          stack.back().second = true;
+          ntk.foreach_fanin(curr_node, [&](auto const& f){
+            if(levels.find(ntk.get_node(f)) == levels.end())
+              stack.emplace_back(ntk.get_node(f), false);
+          });
+        }
       }
-
-      auto inIdx2 = ntk._storage->nodes[curr_node].children[1].data;
-  
-      if (inIdx2 & 1)
-        inIdx2 = inIdx2 - 1;
-
-      //calculate input node index
-      auto inNode1 = inIdx2 >> 1;
-      int levelNode1 = computeLevel(ntk, inNode1, partition_inputs);
-
-      auto inIdx = ntk._storage->nodes[curr_node].children[0].data;
-      if (inIdx & 1)
-        inIdx = inIdx - 1;
-
-      //calculate input node index
-      auto inNode0 = inIdx >> 1;
-      int levelNode0 = computeLevel(ntk, inNode0, partition_inputs);
-
-      int level = 1 + std::max(levelNode0, levelNode1);
-      return level;
     }
-    return 0;
+    return levels;
   }
 
   void dfs (mockturtle::aig_network aig, uint64_t index, UnionFind uf){
@@ -132,74 +112,6 @@ namespace oracle
     }
   }
 
-  void compute_cone(mockturtle::aig_network aig, uint64_t index, std::unordered_map<int, int> &nodes, int outindex, std::unordered_map<int, int> &ins){
-  	if(aig._storage->nodes[index].data[1].h1==0){
-
-  		//increment number of nodes in this cone
-  		std::unordered_map<int, int>::iterator it = nodes.find(outindex);
-
-  		if(it!=nodes.end() && index > aig.num_pis()) {
-  			//increment the number of nodes
-  			it->second++;
-  		}
-
-  		//set node as visited
-  		aig._storage->nodes[index].data[1].h1=1;
-
-  		//traverse one side to the PIs
-  		if(!aig.is_pi(aig._storage->nodes[index].children[0].index) && index > aig.num_pis() ){
-  			if(aig._storage->nodes[index].children[0].data & 1)
-  				aig._storage->nodes[index].children[0].data = aig._storage->nodes[index].children[0].data - 1;
-
-  			//calculate input node index
-  			auto inIndex = aig._storage->nodes[index].children[0].data >> 1;
-
-  			//im ignoring latches
-  			if(inIndex > aig.num_pis()) {
-  				//call recursion
-  				compute_cone(aig, inIndex, nodes, outindex, ins);
-  			}
-  		}
-
-  		//traverse the other side to the PIs
-  		if(!aig.is_pi(aig._storage->nodes[index].children[1].index)&& index > aig.num_pis() ){
-  			if(aig._storage->nodes[index].children[1].data & 1)
-  				aig._storage->nodes[index].children[1].data = aig._storage->nodes[index].children[1].data - 1;
-
-  			//calculate input node index
-  			auto inIndex = aig._storage->nodes[index].children[1].data >> 1;
-
-  			//im ignoring latches
-  			if(inIndex > aig.num_pis()) {
-  				//call recursion
-  				compute_cone(aig, inIndex, nodes, outindex, ins);
-  			}
-  		}
-
-  		//if my child is PI and was not visited yet, I increase the input counter
-  		if(aig.is_ci(aig._storage->nodes[index].children[0].index) && aig._storage->nodes[aig._storage->nodes[index].children[0].index].data[1].h1 == 0 ){
-  			aig._storage->nodes[aig._storage->nodes[index].children[0].index].data[1].h1 = 1;
-
-  			std::unordered_map<int, int>::iterator it = ins.find(outindex);
-  			if(it!=ins.end()) {
-  				//increment the number of inputs
-  				it->second++;
-  			}
-  		}
-
-  		//if my other child is PI and was not visited yet, I also increase the input counter
-  		if(aig.is_ci(aig._storage->nodes[index].children[1].index) && aig._storage->nodes[aig._storage->nodes[index].children[1].index].data[1].h1 == 0){
-  			aig._storage->nodes[aig._storage->nodes[index].children[1].index].data[1].h1 = 1;
-
-  			std::unordered_map<int, int>::iterator it = ins.find(outindex);
-  			if(it!=ins.end()) {
-  				//increment the number of inputs
-  				it->second++;
-  			}
-  		}
-  	}
-  }
-  
   /***************************************************
     Truth Table
   ***************************************************/
@@ -262,12 +174,13 @@ namespace oracle
   /***************************************************
     Network conversion
   ***************************************************/
-  mig_ntk aig_to_mig(aig_names aig, int skip_edge_min){
+  mig_ntk aig_to_mig(aig_names const& aig, int skip_edge_min){
 
     using NtkSource = aig_names;
     using NtkDest = mig_names;
     mockturtle::mig_network ntk;
     NtkDest mig( ntk );
+    mig.share_name_pool( aig );
 
     mockturtle::node_map<mockturtle::mig_network::signal, mockturtle::aig_network> node2new( aig );
 
@@ -285,8 +198,7 @@ namespace oracle
 
       if constexpr ( mockturtle::has_has_name_v<NtkSource> && mockturtle::has_get_name_v<NtkSource> && mockturtle::has_set_name_v<NtkDest> )
       {
-        if ( aig.has_name( aig.make_signal( n ) ) )
-          mig.set_name( node2new[n], aig.get_name( aig.make_signal( n ) ) );
+        mig.copy_name( node2new[n], aig, aig.make_signal( n ) );
       }
     } );
         
@@ -308,8 +220,7 @@ namespace oracle
       
       if constexpr ( mockturtle::has_has_name_v<NtkSource> && mockturtle::has_get_name_v<NtkSource> && mockturtle::has_set_name_v<NtkDest> )
       {
-        if ( aig.has_name( aig.make_signal( n ) ) )
-          mig.set_name( node2new[n], aig.get_name( aig.make_signal( n ) ) );
+        mig.copy_name( node2new[n], aig, aig.make_signal( n ) );
       }
           
     } );
@@ -320,20 +231,21 @@ namespace oracle
 
       if constexpr ( mockturtle::has_has_output_name_v<NtkSource> && mockturtle::has_get_output_name_v<NtkSource> && mockturtle::has_set_output_name_v<NtkDest> )
       {
-        if ( aig.has_output_name( index ) )
-        {
-          mig.set_output_name( index, aig.get_output_name( index ) );
-        }
+        mig.copy_output_name( index, aig, index );
       }
     } );
 
     return std::make_shared<mig_names>( mig );
   }
 
-  mig_ntk part_to_mig(oracle::partition_view<mig_names> part, int skip_edge_min){
+  /* Converts a partition into an MIG, with one input per partition input and
+     one output per partition output. The gates of AIG partitions become
+     majority gates with a constant input, as in aig_to_mig. */
+  template<typename Ntk>
+  mig_ntk part_to_mig(oracle::partition_view<Ntk> const& part, int skip_edge_min){
     mockturtle::mig_network mig;
 
-    std::unordered_map<mockturtle::mig_network::node, mockturtle::mig_network::signal> node2new;
+    std::unordered_map<typename Ntk::node, mockturtle::mig_network::signal> node2new;
 
     node2new[part.get_node( part.get_constant( false ) )] = mig.get_constant( false );
     if ( part.get_node( part.get_constant( true ) ) != part.get_node( part.get_constant( false ) ) ){
@@ -350,6 +262,9 @@ namespace oracle
         return;
 
       std::vector<mockturtle::mig_network::signal> children;
+      if constexpr ( Ntk::max_fanin_size == 2u ){
+        children.push_back( mig.get_constant( false ) );
+      }
       part.foreach_fanin( n, [&]( auto const& f ) {
         children.push_back( part.is_complemented( f ) ? mig.create_not( node2new[part.get_node(f)] ) : node2new[part.get_node(f)] );
       } );
@@ -370,11 +285,12 @@ namespace oracle
     return std::make_shared<mig_names>( mig );
   }
 
-  aig_ntk mig_to_aig(mig_names mig){
+  aig_ntk mig_to_aig(mig_names const& mig){
     using NtkSource = mig_names;
     using NtkDest = aig_names;
     mockturtle::aig_network ntk;
     NtkDest aig( ntk );
+    aig.share_name_pool( mig );
 
     mockturtle::node_map<mockturtle::aig_network::signal, mockturtle::mig_network> node2new( mig );
 
@@ -389,8 +305,7 @@ namespace oracle
 
       if constexpr ( mockturtle::has_has_name_v<NtkSource> && mockturtle::has_get_name_v<NtkSource> && mockturtle::has_set_name_v<NtkDest> )
       {
-        if ( mig.has_name( mig.make_signal( n ) ) )
-          aig.set_name( node2new[n], mig.get_name( mig.make_signal( n ) ) );
+        aig.copy_name( node2new[n], mig, mig.make_signal( n ) );
       }
     } );
     
@@ -427,8 +342,7 @@ namespace oracle
 
       if constexpr ( mockturtle::has_has_name_v<NtkSource> && mockturtle::has_get_name_v<NtkSource> && mockturtle::has_set_name_v<NtkDest> )
       {
-        if ( mig.has_name( mig.make_signal( n ) ) )
-          aig.set_name( node2new[n], mig.get_name( mig.make_signal( n ) ) );
+        aig.copy_name( node2new[n], mig, mig.make_signal( n ) );
       }
           
     } );
@@ -439,10 +353,7 @@ namespace oracle
 
       if constexpr ( mockturtle::has_has_output_name_v<NtkSource> && mockturtle::has_get_output_name_v<NtkSource> && mockturtle::has_set_output_name_v<NtkDest> )
       {
-        if ( mig.has_output_name( index ) )
-        {
-          aig.set_output_name( index, mig.get_output_name( index ) );
-        }
+        aig.copy_output_name( index, mig, index );
       }
     } );
 
@@ -491,6 +402,58 @@ namespace oracle
 
   /***************************************************/
 
+  /***************************************************
+    Threading helpers
+  ***************************************************/
+
+  /* Calls fn(i) for every i in [begin, end) using up to num_threads threads
+   * (the calling thread included). Indices are handed out one at a time so
+   * that work items of very different cost still balance out. fn must only
+   * write state that belongs to index i. The first exception thrown by fn is
+   * rethrown on the calling thread once all workers have stopped.
+   */
+  template<typename Fn>
+  void parallel_for(unsigned num_threads, int begin, int end, Fn&& fn){
+
+    if(end <= begin)
+      return;
+    if(num_threads <= 1 || end - begin == 1){
+      for(int i = begin; i < end; i++)
+        fn(i);
+      return;
+    }
+
+    std::atomic<int> next{begin};
+    std::exception_ptr error;
+    std::mutex error_mutex;
+    auto worker = [&](){
+      for(int i = next++; i < end; i = next++){
+        try{
+          fn(i);
+        }
+        catch(...){
+          std::lock_guard<std::mutex> lock(error_mutex);
+          if(!error)
+            error = std::current_exception();
+          next = end;
+        }
+      }
+    };
+
+    unsigned num_workers = std::min<unsigned>(num_threads, end - begin);
+    std::vector<std::thread> workers;
+    for(unsigned t = 1; t < num_workers; t++)
+      workers.emplace_back(worker);
+    worker();
+    for(auto& t : workers)
+      t.join();
+
+    if(error)
+      std::rethrow_exception(error);
+  }
+
+  /***************************************************/
+
   int get_index(std::vector<int> index, int nodeIdx){
 
     std::vector<int>::iterator it = find(index.begin(), index.end(), nodeIdx);
@@ -32,15 +32,22 @@
 
 #pragma once
 
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <cassert>
+#include <condition_variable>
 #include <cstdint>
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <optional>
+#include <thread>
 #include <vector>
 
 #include <kitty/constructors.hpp>
 #include <kitty/dynamic_truth_table.hpp>
+#include <kitty/static_truth_table.hpp>
 
 #include <fmt/format.h>
 
@@ -72,6 +79,15 @@ struct cut_enumeration_params
   /*! \brief Prune cuts by removing don't cares. */
   bool minimize_truth_table{false};
 
+  /*! \brief Number of threads.
+   *
+   * With more than one thread, the nodes of each level are enumerated
+   * together, spread over the threads.  The cut sets and their truth tables
+   * are the same as with one thread, but truth table ids are assigned level
+   * by level and may differ.
+   */
+  uint32_t num_threads{1u};
+
   /*! \brief Be verbose. */
   bool verbose{false};
 
@@ -84,7 +100,7 @@ struct cut_enumeration_stats
   /*! \brief Total time. */
   stopwatch<>::duration time_total{0};
 
-  /*! \brief Time for truth table computation. */
+  /*! \brief Time for truth table computation (summed over all threads). */
   stopwatch<>::duration time_truth_table{0};
 
   /*! \brief Prints report. */
@@ -118,11 +134,28 @@ using cut_type = cut<max_cut_size, cut_data<ComputeTruth, T>>;
 
 /* forward declarations */
 /*! \cond PRIVATE */
-template<typename Ntk, bool ComputeTruth, typename CutData>
+template<typename Ntk, bool ComputeTruth, typename CutData, typename TT = kitty::dynamic_truth_table>
 struct network_cuts;
 
-template<typename Ntk, bool ComputeTruth = false, typename CutData = empty_cut_data>
-network_cuts<Ntk, ComputeTruth, CutData> cut_enumeration( Ntk const& ntk, cut_enumeration_params const& ps = {}, cut_enumeration_stats * pst = nullptr );
+template<typename Ntk, bool ComputeTruth = false, typename CutData = empty_cut_data, typename TT = kitty::dynamic_truth_table>
+network_cuts<Ntk, ComputeTruth, CutData, TT> cut_enumeration( Ntk const& ntk, cut_enumeration_params const& ps = {}, cut_enumeration_stats * pst = nullptr );
+
+template<typename Ntk, bool ComputeTruth, typename CutData, typename TT>
+network_cuts<Ntk, ComputeTruth, CutData, TT> restrict_cuts( Ntk const& ntk, network_cuts<Ntk, ComputeTruth, CutData, TT> const& cuts, cut_enumeration_params const& ps );
+
+/* true for truth tables whose number of variables is fixed at compile-time */
+template<typename TT>
+struct is_static_truth_table : std::false_type
+{
+};
+
+template<int NumVars>
+struct is_static_truth_table<kitty::static_truth_table<NumVars>> : std::true_type
+{
+};
+
+template<typename TT>
+inline constexpr bool is_static_truth_table_v = is_static_truth_table<TT>::value;
 
 /* function to update a cut */
 template<typename CutData>
@@ -140,7 +173,7 @@ struct cut_enumeration_update_cut
 
 namespace detail
 {
-template<typename Ntk, bool ComputeTruth, typename CutData>
+template<typename Ntk, bool ComputeTruth, typename CutData, typename TT>
 class cut_enumeration_impl;
 }
 /*! \endcond */
@@ -153,20 +186,27 @@ class cut_enumeration_impl;
  *
  * An instance of type `network_cuts` can only be constructed from the
  * `cut_enumeration` algorithm.
+ *
+ * The truth tables of the cuts are of type `TT`.  A
+ * `kitty::dynamic_truth_table` has as many variables as its cut has leaves.
+ * A `kitty::static_truth_table<K>` always has `K` variables, of which only
+ * the first ones, one for each leaf, are in the functional support; the
+ * tables are then stored inline and the cut size must not exceed `K`.
  */
-template<typename Ntk, bool ComputeTruth, typename CutData>
+template<typename Ntk, bool ComputeTruth, typename CutData, typename TT>
 struct network_cuts
 {
 public:
   static constexpr uint32_t max_cut_num = 26;
   using cut_t = cut_type<ComputeTruth, CutData>;
   using cut_set_t = cut_set<cut_t, max_cut_num>;
+  using truth_table_t = TT;
   static constexpr bool compute_truth = ComputeTruth;
 
 private:
   explicit network_cuts( uint32_t size ) : _cuts( size )
   {
-    kitty::dynamic_truth_table zero( 0u ), proj( 1u );
+    auto zero = create_truth_table( 0u ), proj = create_truth_table( 1u );
     kitty::create_nth_var( proj, 0u );
 
     _truth_tables.insert( zero );
@@ -182,8 +222,12 @@ public:
 
   /*! \brief Returns the truth table of a cut */
   template<bool enabled = ComputeTruth, typename = std::enable_if_t<std::is_same_v<Ntk, Ntk> && enabled>>
-  auto truth_table( cut_t const& cut ) const
+  TT truth_table( cut_t const& cut ) const
   {
+    if ( cut->func_id & pending_function )
+    {
+      return ( *_pending_functions )[cut->func_id ^ pending_function];
+    }
     return _truth_tables[cut->func_id];
   }
 
@@ -234,17 +278,35 @@ public:
    * \param tt Truth table to add
    * \return Literal id from the truth table store
    */
-  uint32_t insert_truth_table( kitty::dynamic_truth_table const& tt )
+  uint32_t insert_truth_table( TT const& tt )
   {
     return _truth_tables.insert( tt );
   }
 
+  /*! \brief Creates a constant truth table for a cut with `num_vars` leaves. */
+  static TT create_truth_table( uint32_t num_vars )
+  {
+    if constexpr ( is_static_truth_table_v<TT> )
+    {
+      assert( num_vars <= static_cast<uint32_t>( TT().num_vars() ) );
+      (void)num_vars;
+      return TT();
+    }
+    else
+    {
+      return TT( num_vars );
+    }
+  }
+
 private:
-  template<typename _Ntk, bool _ComputeTruth, typename _CutData>
+  template<typename _Ntk, bool _ComputeTruth, typename _CutData, typename _TT>
   friend class detail::cut_enumeration_impl;
 
-  template<typename _Ntk, bool _ComputeTruth, typename _CutData>
-  friend network_cuts<_Ntk, _ComputeTruth, _CutData> cut_enumeration( _Ntk const& ntk, cut_enumeration_params const& ps, cut_enumeration_stats * pst );
+  template<typename _Ntk, bool _ComputeTruth, typename _CutData, typename _TT>
+  friend network_cuts<_Ntk, _ComputeTruth, _CutData, _TT> cut_enumeration( _Ntk const& ntk, cut_enumeration_params const& ps, cut_enumeration_stats * pst );
+
+  template<typename _Ntk, bool _ComputeTruth, typename _CutData, typename _TT>
+  friend network_cuts<_Ntk, _ComputeTruth, _CutData, _TT> restrict_cuts( _Ntk const& ntk, network_cuts<_Ntk, _ComputeTruth, _CutData, _TT> const& cuts, cut_enumeration_params const& ps );
 
 private:
   void add_zero_cut( uint32_t index )
@@ -268,11 +330,18 @@ private:
   }
 
 private:
+  /* while the cuts of a level are enumerated, the functions of a node's new
+   * cuts are kept with the node; their ids are marked by pending_function
+   * and index _pending_functions of the node that is processed by the
+   * current thread */
+  static constexpr uint32_t pending_function = 0x80000000;
+  inline static thread_local std::vector<TT> const* _pending_functions = nullptr;
+
   /* compressed representation of cuts */
   std::vector<cut_set_t> _cuts;
 
   /* cut truth tables */
-  truth_table_cache<kitty::dynamic_truth_table> _truth_tables;
+  truth_table_cache<TT> _truth_tables;
 
   /* statistics */
   uint32_t _total_tuples{};
@@ -283,18 +352,51 @@ private:
 namespace detail
 {
 
-template<typename Ntk, bool ComputeTruth, typename CutData>
+/* waits until all threads have finished a level */
+class level_barrier
+{
+public:
+  explicit level_barrier( uint32_t num_threads ) : num_threads( num_threads ) {}
+
+  void wait()
+  {
+    std::unique_lock<std::mutex> lock( mutex );
+    const auto current = generation;
+    if ( ++waiting == num_threads )
+    {
+      waiting = 0u;
+      ++generation;
+      cv.notify_all();
+    }
+    else
+    {
+      cv.wait( lock, [&]() { return generation != current; } );
+    }
+  }
+
+private:
+  std::mutex mutex;
+  std::condition_variable cv;
+  uint32_t num_threads;
+  uint32_t waiting{0u};
+  uint64_t generation{0u};
+};
+
+template<typename Ntk, bool ComputeTruth, typename CutData, typename TT>
 class cut_enumeration_impl
 {
 public:
-  using cut_t = typename network_cuts<Ntk, ComputeTruth, CutData>::cut_t;
-  using cut_set_t = typename network_cuts<Ntk, ComputeTruth, CutData>::cut_set_t;
+  using network_cuts_t = network_cuts<Ntk, ComputeTruth, CutData, TT>;
+  using cut_t = typename network_cuts_t::cut_t;
+  using cut_set_t = typename network_cuts_t::cut_set_t;
 
-  explicit cut_enumeration_impl( Ntk const& ntk, cut_enumeration_params const& ps, cut_enumeration_stats& st, network_cuts<Ntk, ComputeTruth, CutData>& cuts )
+  explicit cut_enumeration_impl( Ntk const& ntk, cut_enumeration_params const& ps, cut_enumeration_stats& st, network_cuts_t& cuts,
+                                 std::vector<std::vector<TT>>* pending = nullptr )
       : ntk( ntk ),
         ps( ps ),
         st( st ),
-        cuts( cuts )
+        cuts( cuts ),
+        pending( pending )
   {
   }
 
@@ -303,46 +405,202 @@ public:
   {
     stopwatch t( st.time_total );
 
+    if ( ps.num_threads > 1u )
+    {
+      run_levels();
+      return;
+    }
+
     ntk.foreach_node( [this]( auto node ) {
-      const auto index = ntk.node_to_index( node );
+      compute_cuts( node );
+    } );
+    cuts._total_tuples += total_tuples;
+    cuts._total_cuts += total_cuts;
+  }
+
+private:
+  void compute_cuts( node<Ntk> const& node )
+  {
+    const auto index = ntk.node_to_index( node );
+
+    if ( ps.very_verbose )
+    {
+      std::cout << fmt::format( "[i] compute cut for node at index {}\n", index );
+    }
 
-      if ( ps.very_verbose )
+    if ( ntk.is_constant( node ) )
+    {
+      cuts.add_zero_cut( index );
+    }
+    else if ( ntk.is_pi( node ) )
+    {
+      cuts.add_unit_cut( index );
+    }
+    else
+    {
+      if constexpr ( Ntk::min_fanin_size == 2 && Ntk::max_fanin_size == 2 )
+      {
+        merge_cuts2( index );
+      }
+      else
       {
-        std::cout << fmt::format( "[i] compute cut for node at index {}\n", index );
+        merge_cuts( index );
       }
+    }
+  }
+
+  /* Enumerates the cuts of all nodes of a level together, spread over
+   * ps.num_threads threads.  The functions of new cuts are kept with their
+   * nodes until the level is done; then the functions of the cuts that
+   * survived are inserted into the truth table cache, and the others are
+   * dropped. */
+  void run_levels()
+  {
+    std::vector<std::vector<TT>> functions( ComputeTruth ? ntk.size() : 0u );
+    std::vector<uint32_t> levels( ntk.size(), 0u );
+    std::vector<std::vector<uint32_t>> level_nodes( 1u );
 
-      if ( ntk.is_constant( node ) )
+    ntk.foreach_node( [&]( auto node ) {
+      const auto index = ntk.node_to_index( node );
+      if ( ntk.is_constant( node ) || ntk.is_pi( node ) )
       {
-        cuts.add_zero_cut( index );
+        compute_cuts( node );
+        return;
       }
-      else if ( ntk.is_pi( node ) )
+
+      uint32_t level{0u};
+      ntk.foreach_fanin( node, [&]( auto const& f ) {
+        level = std::max( level, levels[ntk.node_to_index( ntk.get_node( f ) )] );
+      } );
+      levels[index] = ++level;
+      if ( level_nodes.size() <= level )
       {
-        cuts.add_unit_cut( index );
+        level_nodes.resize( level + 1u );
       }
-      else
+      level_nodes[level].push_back( index );
+    } );
+
+    const auto num_threads = ps.num_threads;
+    std::vector<cut_enumeration_stats> stats( num_threads );
+    std::vector<std::unique_ptr<cut_enumeration_impl>> workers;
+    for ( auto i = 0u; i < num_threads; ++i )
+    {
+      workers.emplace_back( std::make_unique<cut_enumeration_impl>( ntk, ps, stats[i], cuts, &functions ) );
+    }
+
+    std::unique_ptr<std::atomic<uint32_t>[]> next( new std::atomic<uint32_t>[level_nodes.size()] );
+    for ( auto l = 0u; l < level_nodes.size(); ++l )
+    {
+      next[l] = 0u;
+    }
+    level_barrier barrier( num_threads );
+
+    auto work = [&]( uint32_t thread ) {
+      auto& worker = *workers[thread];
+      for ( auto l = 1u; l < level_nodes.size(); ++l )
       {
-        if constexpr ( Ntk::min_fanin_size == 2 && Ntk::max_fanin_size == 2 )
+        auto const& nodes = level_nodes[l];
+        for ( auto i = next[l]++; i < nodes.size(); i = next[l]++ )
         {
-          merge_cuts2( index );
+          if constexpr ( ComputeTruth )
+          {
+            network_cuts_t::_pending_functions = &functions[nodes[i]];
+          }
+          worker.compute_cuts( ntk.index_to_node( nodes[i] ) );
         }
-        else
+        barrier.wait();
+
+        if constexpr ( ComputeTruth )
         {
-          merge_cuts( index );
+          if ( thread == 0u )
+          {
+            insert_functions( nodes, functions );
+          }
+          barrier.wait();
         }
       }
-    } );
+    };
+
+    std::vector<std::thread> threads;
+    for ( auto i = 1u; i < num_threads; ++i )
+    {
+      threads.emplace_back( work, i );
+    }
+    work( 0u );
+    for ( auto& thread : threads )
+    {
+      thread.join();
+    }
+
+    for ( auto const& worker : workers )
+    {
+      cuts._total_tuples += worker->total_tuples;
+      cuts._total_cuts += worker->total_cuts;
+    }
+    for ( auto const& s : stats )
+    {
+      st.time_truth_table += s.time_truth_table;
+    }
+  }
+
+  /* inserts the functions of the remaining cuts of a level's nodes into the
+   * truth table cache, in the order of the nodes and their cuts, and frees
+   * the functions of all candidates */
+  void insert_functions( std::vector<uint32_t> const& nodes, std::vector<std::vector<TT>>& functions )
+  {
+    for ( auto index : nodes )
+    {
+      auto& node_functions = functions[index];
+      for ( auto* cut : cuts.cuts( index ) )
+      {
+        if ( ( *cut )->func_id & network_cuts_t::pending_function )
+        {
+          ( *cut )->func_id = cuts._truth_tables.insert( node_functions[( *cut )->func_id ^ network_cuts_t::pending_function] );
+        }
+      }
+      std::vector<TT>().swap( node_functions );
+    }
+  }
+
+  /* function of a cut of the node at index leaf_index */
+  TT cut_function( uint32_t leaf_index, cut_t const& cut ) const
+  {
+    if ( ( cut->func_id & network_cuts_t::pending_function ) && pending != nullptr )
+    {
+      return ( *pending )[leaf_index][cut->func_id ^ network_cuts_t::pending_function];
+    }
+    return cuts._truth_tables[cut->func_id];
+  }
+
+  uint32_t insert_function( uint32_t index, TT const& tt )
+  {
+    if ( pending == nullptr )
+    {
+      return cuts._truth_tables.insert( tt );
+    }
+    auto& functions = ( *pending )[index];
+    functions.push_back( tt );
+    return network_cuts_t::pending_function | static_cast<uint32_t>( functions.size() - 1u );
   }
 
-private:
   uint32_t compute_truth_table( uint32_t index, std::vector<cut_t const*> const& vcuts, cut_t& res )
   {
     stopwatch t( st.time_truth_table );
 
-    std::vector<kitty::dynamic_truth_table> tt( vcuts.size() );
+    auto& tt = ltts;
+    tt.resize( vcuts.size() );
     auto i = 0;
     for ( auto const& cut : vcuts )
     {
-      tt[i] = kitty::extend_to( cuts._truth_tables[( *cut )->func_id], res.size() );
+      /* static truth tables already have the size of every cut */
+      if constexpr ( is_static_truth_table_v<TT> )
+      {
+        tt[i] = cut_function( lnodes[i], *cut );
+      }
+      else
+      {
+        tt[i] = kitty::extend_to( cut_function( lnodes[i], *cut ), res.size() );
+      }
       const auto supp = cuts.compute_truth_table_support( *cut, res );
       kitty::expand_inplace( tt[i], supp );
       ++i;
@@ -355,7 +613,15 @@ private:
       const auto support = kitty::min_base_inplace( tt_res );
       if ( support.size() != res.size() )
       {
-        auto tt_res_shrink = shrink_to( tt_res, static_cast<unsigned>( support.size() ) );
+        TT tt_res_shrink;
+        if constexpr ( is_static_truth_table_v<TT> )
+        {
+          tt_res_shrink = tt_res;
+        }
+        else
+        {
+          tt_res_shrink = shrink_to( tt_res, static_cast<unsigned>( support.size() ) );
+        }
         std::vector<uint32_t> leaves_before( res.begin(), res.end() );
         std::vector<uint32_t> leaves_after( support.size() );
 
@@ -366,11 +632,11 @@ private:
           *it_leaves++ = leaves_before[*it_support++];
         }
         res.set_leaves( leaves_after.begin(), leaves_after.end() );
-        return cuts._truth_tables.insert( tt_res_shrink );
+        return insert_function( index, tt_res_shrink );
       }
     }
 
-    return cuts._truth_tables.insert( tt_res );
+    return insert_function( index, tt_res );
   }
 
   void merge_cuts2( uint32_t index )
@@ -379,7 +645,8 @@ private:
 
     uint32_t pairs{1};
     ntk.foreach_fanin( ntk.index_to_node( index ), [this, &pairs]( auto child, auto i ) {
-      lcuts[i] = &cuts.cuts( ntk.node_to_index( ntk.get_node( child ) ) );
+      lnodes[i] = ntk.node_to_index( ntk.get_node( child ) );
+      lcuts[i] = &cuts.cuts( lnodes[i] );
       pairs *= static_cast<uint32_t>( lcuts[i]->size() );
     } );
     lcuts[2] = &cuts.cuts( index );
@@ -390,7 +657,7 @@ private:
 
     std::vector<cut_t const*> vcuts( fanin );
 
-    cuts._total_tuples += pairs;
+    total_tuples += pairs;
     for ( auto const& c1 : *lcuts[0] )
     {
       for ( auto const& c2 : *lcuts[1] )
@@ -421,7 +688,7 @@ private:
     /* limit the maximum number of cuts */
     rcuts.limit( ps.cut_limit - 1 );
 
-    cuts._total_cuts += rcuts.size();
+    total_cuts += rcuts.size();
 
     if ( rcuts.size() > 1 || ( *rcuts.begin() )->size() > 1 )
     {
@@ -434,7 +701,8 @@ private:
     uint32_t pairs{1};
     std::vector<uint32_t> cut_sizes;
     ntk.foreach_fanin( ntk.index_to_node( index ), [this, &pairs, &cut_sizes]( auto child, auto i ) {
-      lcuts[i] = &cuts.cuts( ntk.node_to_index( ntk.get_node( child ) ) );
+      lnodes[i] = ntk.node_to_index( ntk.get_node( child ) );
+      lcuts[i] = &cuts.cuts( lnodes[i] );
       cut_sizes.push_back( lcuts[i]->size() );
       pairs *= cut_sizes.back();
     } );
@@ -452,7 +720,7 @@ private:
 
       std::vector<cut_t const*> vcuts( fanin );
 
-      cuts._total_tuples += pairs;
+      total_tuples += pairs;
       foreach_mixed_radix_tuple( cut_sizes.begin(), cut_sizes.end(), [&]( auto begin, auto end ) {
         auto it = vcuts.begin();
         auto i = 0u;
@@ -514,7 +782,7 @@ private:
       rcuts.limit( ps.cut_limit - 1 );
     }
 
-    cuts._total_cuts += static_cast<uint32_t>( rcuts.size() );
+    total_cuts += static_cast<uint32_t>( rcuts.size() );
 
     cuts.add_unit_cut( index );
   }
@@ -523,9 +791,15 @@ private:
   Ntk const& ntk;
   cut_enumeration_params const& ps;
   cut_enumeration_stats& st;
-  network_cuts<Ntk, ComputeTruth, CutData>& cuts;
+  network_cuts_t& cuts;
+  std::vector<std::vector<TT>>* pending;
 
   std::array<cut_set_t*, Ntk::max_fanin_size + 1> lcuts;
+  std::array<uint32_t, Ntk::max_fanin_size + 1> lnodes;
+  std::vector<TT> ltts;
+
+  uint32_t total_tuples{};
+  std::size_t total_cuts{};
 };
 } /* namespace detail */
 /*! \endcond */
@@ -539,7 +813,10 @@ private:
  *
  * The template parameter `ComputeTruth` controls whether truth tables should
  * be computed for each cut.  Computing truth tables slows down the execution
- * time of the algorithm.
+ * time of the algorithm.  The template parameter `TT` is the type of the
+ * truth tables.  When the cut size is known to be small, a
+ * `kitty::static_truth_table` of at least the cut size avoids allocating
+ * every truth table on the heap (see `network_cuts`).
  *
  * The number of computed cuts is controlled via the `cut_limit` parameter.
  * To decide which cuts are collected in each node's cut set, cuts are sorted.
@@ -560,7 +837,7 @@ private:
  * - `node_to_index`
  * - `foreach_node`
  * - `foreach_fanin`
- * - `compute` for `kitty::dynamic_truth_table` (if `ComputeTruth` is true)
+ * - `compute` for `TT` (if `ComputeTruth` is true)
  *
    \verbatim embed:rst
 
@@ -576,8 +853,8 @@ private:
       enumeration implementations in ABC.
    \endverbatim
  */
-template<typename Ntk, bool ComputeTruth, typename CutData>
-network_cuts<Ntk, ComputeTruth, CutData> cut_enumeration( Ntk const& ntk, cut_enumeration_params const& ps, cut_enumeration_stats * pst )
+template<typename Ntk, bool ComputeTruth, typename CutData, typename TT>
+network_cuts<Ntk, ComputeTruth, CutData, TT> cut_enumeration( Ntk const& ntk, cut_enumeration_params const& ps, cut_enumeration_stats * pst )
 {
   static_assert( is_network_type_v<Ntk>, "Ntk is not a network type" );
   static_assert( has_is_constant_v<Ntk>, "Ntk does not implement the is_constant method" );
@@ -587,11 +864,12 @@ network_cuts<Ntk, ComputeTruth, CutData> cut_enumeration( Ntk const& ntk, cut_en
   static_assert( has_foreach_node_v<Ntk>, "Ntk does not implement the foreach_node method" );
   static_assert( has_foreach_fanin_v<Ntk>, "Ntk does not implement the foreach_fanin method" );
   static_assert( has_node_to_index_v<Ntk>, "Ntk does not implement the node_to_index method" );
-  static_assert( !ComputeTruth || has_compute_v<Ntk, kitty::dynamic_truth_table>, "Ntk does not implement the compute method for kitty::dynamic_truth_table" );
+  static_assert( !ComputeTruth || has_compute_v<Ntk, TT>, "Ntk does not implement the compute method for the truth table type" );
+  assert( !ComputeTruth || !is_static_truth_table_v<TT> || ps.cut_size <= static_cast<uint32_t>( TT().num_vars() ) );
 
   cut_enumeration_stats st;
-  network_cuts<Ntk, ComputeTruth, CutData> res( ntk.size() );
-  detail::cut_enumeration_impl<Ntk, ComputeTruth, CutData> p( ntk, ps, st, res );
+  network_cuts<Ntk, ComputeTruth, CutData, TT> res( ntk.size() );
+  detail::cut_enumeration_impl<Ntk, ComputeTruth, CutData, TT> p( ntk, ps, st, res );
   p.run();
 
   if ( ps.verbose )
@@ -606,6 +884,137 @@ network_cuts<Ntk, ComputeTruth, CutData> cut_enumeration( Ntk const& ntk, cut_en
   return res;
 }
 
+/*! \brief Restricts a cut database to a smaller cut size and cut limit.
+ *
+ * Derives the cuts for `ps.cut_size` and `ps.cut_limit` from a database that
+ * `cut_enumeration` computed for the same network with a cut size and cut
+ * limit at least as large, without merging cuts again.  The cuts of each node
+ * that fit into the new cut size are kept; their cut data is updated from the
+ * new cut sets of their leaves, they are sorted again and limited to
+ * `ps.cut_limit` cuts including the unit cut.  Truth tables are taken over
+ * from `cuts`.
+ *
+ * A node none of whose cuts fits gets the cut formed by its fanins, so
+ * `ps.cut_size` must not be smaller than the largest fan-in of a node.  As
+ * the kept cuts were selected among the larger cuts, the result can differ
+ * from running `cut_enumeration` with `ps` directly.
+ *
+ * **Required network functions:**
+ * - `is_constant`
+ * - `is_pi`
+ * - `size`
+ * - `get_node`
+ * - `node_to_index`
+ * - `foreach_node`
+ * - `foreach_fanin`
+ * - `compute` for `TT` (if `ComputeTruth` is true)
+ */
+template<typename Ntk, bool ComputeTruth, typename CutData, typename TT>
+network_cuts<Ntk, ComputeTruth, CutData, TT> restrict_cuts( Ntk const& ntk, network_cuts<Ntk, ComputeTruth, CutData, TT> const& cuts, cut_enumeration_params const& ps )
+{
+  static_assert( is_network_type_v<Ntk>, "Ntk is not a network type" );
+  static_assert( has_is_constant_v<Ntk>, "Ntk does not implement the is_constant method" );
+  static_assert( has_is_pi_v<Ntk>, "Ntk does not implement the is_pi method" );
+  static_assert( has_size_v<Ntk>, "Ntk does not implement the size method" );
+  static_assert( has_get_node_v<Ntk>, "Ntk does not implement the get_node method" );
+  static_assert( has_foreach_node_v<Ntk>, "Ntk does not implement the foreach_node method" );
+  static_assert( has_foreach_fanin_v<Ntk>, "Ntk does not implement the foreach_fanin method" );
+  static_assert( has_node_to_index_v<Ntk>, "Ntk does not implement the node_to_index method" );
+  static_assert( !ComputeTruth || has_compute_v<Ntk, TT>, "Ntk does not implement the compute method for the truth table type" );
+
+  using network_cuts_t = network_cuts<Ntk, ComputeTruth, CutData, TT>;
+  using cut_t = typename network_cuts_t::cut_t;
+
+  network_cuts_t res( ntk.size() );
+  if constexpr ( ComputeTruth )
+  {
+    res._truth_tables = cuts._truth_tables;
+  }
+
+  ntk.foreach_node( [&]( auto n ) {
+    const auto index = ntk.node_to_index( n );
+
+    if ( ntk.is_constant( n ) )
+    {
+      res.add_zero_cut( index );
+      return;
+    }
+    if ( ntk.is_pi( n ) )
+    {
+      res.add_unit_cut( index );
+      return;
+    }
+
+    /* insert the cuts from the back, so that cuts of equal cost keep their order */
+    auto& rcuts = res._cuts[index];
+    auto const& ocuts = cuts.cuts( index );
+    for ( auto it = ocuts.end(); it != ocuts.begin(); )
+    {
+      auto const* cut = *--it;
+      if ( cut->size() > ps.cut_size || ( cut->size() == 1u && *cut->begin() == index ) )
+      {
+        continue;
+      }
+
+      cut_t new_cut = *cut;
+      if ( rcuts.is_dominated( new_cut ) )
+      {
+        continue;
+      }
+      cut_enumeration_update_cut<CutData>::apply( new_cut, res, ntk, n );
+      rcuts.insert( new_cut );
+    }
+
+    if ( rcuts.size() == 0 )
+    {
+      std::vector<uint32_t> leaves;
+      ntk.foreach_fanin( n, [&]( auto const& f ) {
+        if ( !ntk.is_constant( ntk.get_node( f ) ) )
+          leaves.push_back( ntk.node_to_index( ntk.get_node( f ) ) );
+      } );
+      std::sort( leaves.begin(), leaves.end() );
+      leaves.erase( std::unique( leaves.begin(), leaves.end() ), leaves.end() );
+
+      cut_t new_cut;
+      new_cut.set_leaves( leaves.begin(), leaves.end() );
+      if constexpr ( ComputeTruth )
+      {
+        std::vector<TT> tts;
+        ntk.foreach_fanin( n, [&]( auto const& f ) {
+          auto tt = network_cuts_t::create_truth_table( static_cast<uint32_t>( leaves.size() ) );
+          if ( !ntk.is_constant( ntk.get_node( f ) ) )
+          {
+            const auto leaf = std::find( leaves.begin(), leaves.end(), ntk.node_to_index( ntk.get_node( f ) ) );
+            kitty::create_nth_var( tt, static_cast<uint32_t>( std::distance( leaves.begin(), leaf ) ) );
+          }
+          tts.push_back( tt );
+        } );
+        new_cut->func_id = res._truth_tables.insert( ntk.compute( n, tts.begin(), tts.end() ) );
+      }
+      cut_enumeration_update_cut<CutData>::apply( new_cut, res, ntk, n );
+      rcuts.insert( new_cut );
+    }
+
+    /* limit the maximum number of cuts */
+    rcuts.limit( ps.cut_limit - 1 );
+    res._total_cuts += rcuts.size();
+
+    if constexpr ( Ntk::min_fanin_size == 2 && Ntk::max_fanin_size == 2 )
+    {
+      if ( rcuts.size() > 1 || ( *rcuts.begin() )->size() > 1 )
+      {
+        res.add_unit_cut( index );
+      }
+    }
+    else
+    {
+      res.add_unit_cut( index );
+    }
+  } );
+
+  return res;
+}
+
 // This function expects to receive a network where nodes are sorted in
 // topological order. Cuts are represented as a 64-bit bit vector where each bit
 // determines whether a given node exists in the cut.
@@ -278,8 +278,8 @@ struct cut_enumeration_cut_rewriting_cut
   int32_t gain{-1};
 };
 
-template<typename Ntk, bool ComputeTruth>
-std::tuple<graph, std::vector<std::pair<node<Ntk>, uint32_t>>> network_cuts_graph( Ntk const& ntk, network_cuts<Ntk, ComputeTruth, cut_enumeration_cut_rewriting_cut> const& cuts, cut_rewriting_params const& ps )
+template<typename Ntk, bool ComputeTruth, typename TT>
+std::tuple<graph, std::vector<std::pair<node<Ntk>, uint32_t>>> network_cuts_graph( Ntk const& ntk, network_cuts<Ntk, ComputeTruth, cut_enumeration_cut_rewriting_cut, TT> const& cuts, cut_rewriting_params const& ps )
 {
   static_assert( is_network_type_v<Ntk>, "Ntk is not a network type" );
   static_assert( has_size_v<Ntk>, "Ntk does not implement the size method" );
@@ -379,6 +379,25 @@ struct has_rewrite_with_dont_cares<Ntk,
 template<class Ntk, class RewritingFn, class Iterator>
 inline constexpr bool has_rewrite_with_dont_cares_v = has_rewrite_with_dont_cares<Ntk, RewritingFn, Iterator>::value;
 
+template<class Ntk, class RewritingFn, class Iterator, class = void>
+struct has_rewrite_with_static_truth_table : std::false_type
+{
+};
+
+template<class Ntk, class RewritingFn, class Iterator>
+struct has_rewrite_with_static_truth_table<Ntk,
+                                           RewritingFn, Iterator,
+                                           std::void_t<decltype( std::declval<RewritingFn>()( std::declval<Ntk&>(),
+                                                                                              std::declval<kitty::static_truth_table<4>>(),
+                                                                                              std::declval<Iterator const&>(),
+                                                                                              std::declval<Iterator const&>(),
+                                                                                              std::declval<void( signal<Ntk> )>() ) )>> : std::true_type
+{
+};
+
+template<class Ntk, class RewritingFn, class Iterator>
+inline constexpr bool has_rewrite_with_static_truth_table_v = has_rewrite_with_static_truth_table<Ntk, RewritingFn, Iterator>::value;
+
 template<class Ntk>
 struct unit_cost
 {
@@ -406,8 +425,26 @@ public:
   {
     stopwatch t( st.time_total );
 
+    /* cuts of up to four leaves keep their functions in static truth tables
+     * if the rewriting function takes them, which saves allocating a truth
+     * table for every cut */
+    if constexpr ( has_rewrite_with_static_truth_table_v<Ntk, RewritingFn, typename std::vector<signal<Ntk>>::iterator> )
+    {
+      if ( ps.cut_enumeration_ps.cut_size <= 4u && !ps.use_dont_cares )
+      {
+        run_with<kitty::static_truth_table<4>>();
+        return;
+      }
+    }
+    run_with<kitty::dynamic_truth_table>();
+  }
+
+private:
+  template<typename TT>
+  void run_with()
+  {
     /* enumerate cuts */
-    const auto cuts = call_with_stopwatch( st.time_cuts, [&]() { return cut_enumeration<Ntk, true, cut_enumeration_cut_rewriting_cut>( ntk, ps.cut_enumeration_ps ); } );
+    const auto cuts = call_with_stopwatch( st.time_cuts, [&]() { return cut_enumeration<Ntk, true, cut_enumeration_cut_rewriting_cut, TT>( ntk, ps.cut_enumeration_ps ); } );
 
     /* for cost estimation we use reference counters initialized by the fanout size */
     ntk.clear_values();
@@ -443,7 +480,7 @@ public:
           continue;
 
         const auto tt = cuts.truth_table( *cut );
-        assert( cut->size() == static_cast<unsigned>( tt.num_vars() ) );
+        assert( is_static_truth_table_v<TT> || cut->size() == static_cast<unsigned>( tt.num_vars() ) );
 
         pbar( index, ntk.node_to_index( n ), best_replacements[n].size(), max_total_gain );
 
@@ -483,23 +520,23 @@ public:
 
           if ( ps.use_dont_cares )
           {
-            if constexpr ( has_rewrite_with_dont_cares_v<Ntk, RewritingFn, decltype( children.begin() )> )
+            if constexpr ( has_rewrite_with_dont_cares_v<Ntk, RewritingFn, decltype( children.begin() )> && !is_static_truth_table_v<TT> )
             {
               std::vector<node<Ntk>> pivots;
               for ( auto const& c : children )
               {
                 pivots.push_back( ntk.get_node( c ) );
               }
-              rewriting_fn( ntk, cuts.truth_table( *cut ), satisfiability_dont_cares( ntk, pivots ), children.begin(), children.end(), on_signal );
+              rewriting_fn( ntk, tt, satisfiability_dont_cares( ntk, pivots ), children.begin(), children.end(), on_signal );
             }
             else
             {
-              rewriting_fn( ntk, cuts.truth_table( *cut ), children.begin(), children.end(), on_signal );
+              rewriting_fn( ntk, tt, children.begin(), children.end(), on_signal );
             }
           }
           else
           {
-            rewriting_fn( ntk, cuts.truth_table( *cut ), children.begin(), children.end(), on_signal );
+            rewriting_fn( ntk, tt, children.begin(), children.end(), on_signal );
           }
           
           if ( best_gain > 0 )
@@ -33,9 +33,14 @@
 #pragma once
 
 #include <cstdint>
+#include <type_traits>
 
 #include <fmt/format.h>
 
+#include <kitty/dynamic_truth_table.hpp>
+#include <kitty/operations.hpp>
+#include <kitty/static_truth_table.hpp>
+
 #include "../utils/stopwatch.hpp"
 #include "../views/topo_view.hpp"
 #include "cut_enumeration.hpp"
@@ -107,11 +112,11 @@ struct lut_mapping_update_cuts
 namespace detail
 {
 
-template<class Ntk, bool StoreFunction, typename CutData>
+template<class Ntk, bool StoreFunction, typename CutData, typename TT = kitty::dynamic_truth_table>
 class lut_mapping_impl
 {
 public:
-  using network_cuts_t = network_cuts<Ntk, StoreFunction, CutData>;
+  using network_cuts_t = network_cuts<Ntk, StoreFunction, CutData, TT>;
   using cut_t = typename network_cuts_t::cut_t;
 
 public:
@@ -123,11 +128,24 @@ public:
         map_refs( ntk.size(), 0 ),
         flows( ntk.size() ),
         delays( ntk.size() ),
-        cuts( cut_enumeration<Ntk, StoreFunction, CutData>( ntk, ps.cut_enumeration_ps ) )
+        cuts( cut_enumeration<Ntk, StoreFunction, CutData, TT>( ntk, ps.cut_enumeration_ps ) )
   {
     lut_mapping_update_cuts<CutData>().apply( cuts, ntk );
   }
 
+  lut_mapping_impl( Ntk& ntk, network_cuts_t&& cuts, lut_mapping_params const& ps, lut_mapping_stats& st )
+      : ntk( ntk ),
+        ps( ps ),
+        st( st ),
+        flow_refs( ntk.size() ),
+        map_refs( ntk.size(), 0 ),
+        flows( ntk.size() ),
+        delays( ntk.size() ),
+        cuts( std::move( cuts ) )
+  {
+    lut_mapping_update_cuts<CutData>().apply( this->cuts, ntk );
+  }
+
   void run()
   {
     stopwatch t( st.time_total );
@@ -433,7 +451,15 @@ private:
 
       if constexpr ( StoreFunction )
       {
-        ntk.set_cell_function( n, cuts.truth_table( cuts.cuts( index ).best() ) );
+        auto const& best = cuts.cuts( index ).best();
+        if constexpr ( std::is_same_v<TT, kitty::dynamic_truth_table> )
+        {
+          ntk.set_cell_function( n, cuts.truth_table( best ) );
+        }
+        else
+        {
+          ntk.set_cell_function( n, kitty::shrink_to( cuts.truth_table( best ), static_cast<unsigned>( best.size() ) ) );
+        }
       }
     }
   }
@@ -486,6 +512,10 @@ private:
  * - `float flow`
  * - `float costs`
  *
+ * If `StoreFunction` is true and the cut size is at most 6, the functions of
+ * the cuts are computed in static truth tables, which are not allocated on
+ * the heap.
+ *
  * See `include/mockturtle/algorithms/cut_enumeration/mf_cut.hpp` for one
  * example of a CutData type that implements the cost function that is used in
  * the LUT mapper `&mf` in ABC.
@@ -530,7 +560,61 @@ void lut_mapping( Ntk& ntk, lut_mapping_params const& ps = {}, lut_mapping_stats
   static_assert( !StoreFunction || has_set_cell_function_v<Ntk>, "Ntk does not implement the set_cell_function method" );
 
   lut_mapping_stats st;
-  detail::lut_mapping_impl<Ntk, StoreFunction, CutData> p( ntk, ps, st );
+  if constexpr ( StoreFunction && has_compute_v<Ntk, kitty::static_truth_table<6>> )
+  {
+    if ( ps.cut_enumeration_ps.cut_size <= 6u )
+    {
+      detail::lut_mapping_impl<Ntk, StoreFunction, CutData, kitty::static_truth_table<6>> p( ntk, ps, st );
+      p.run();
+    }
+    else
+    {
+      detail::lut_mapping_impl<Ntk, StoreFunction, CutData> p( ntk, ps, st );
+      p.run();
+    }
+  }
+  else
+  {
+    detail::lut_mapping_impl<Ntk, StoreFunction, CutData> p( ntk, ps, st );
+    p.run();
+  }
+  if ( ps.verbose )
+  {
+    st.report();
+  }
+
+  if ( pst )
+  {
+    *pst = st;
+  }
+}
+
+/*! \brief LUT mapping on precomputed cuts.
+ *
+ * Like the function above, but maps with the cut database `cuts`, which must
+ * have been computed for `ntk` (e.g., with `cut_enumeration` or
+ * `restrict_cuts`), instead of enumerating cuts.  The cut parameters in `ps`
+ * are not used.
+ */
+template<class Ntk, bool StoreFunction = false, typename CutData = cut_enumeration_mf_cut, typename TT = kitty::dynamic_truth_table>
+void lut_mapping( Ntk& ntk, network_cuts<Ntk, StoreFunction, CutData, TT>&& cuts, lut_mapping_params const& ps = {}, lut_mapping_stats* pst = nullptr )
+{
+  static_assert( is_network_type_v<Ntk>, "Ntk is not a network type" );
+  static_assert( has_size_v<Ntk>, "Ntk does not implement the size method" );
+  static_assert( has_is_pi_v<Ntk>, "Ntk does not implement the is_pi method" );
+  static_assert( has_is_constant_v<Ntk>, "Ntk does not implement the is_constant method" );
+  static_assert( has_node_to_index_v<Ntk>, "Ntk does not implement the node_to_index method" );
+  static_assert( has_index_to_node_v<Ntk>, "Ntk does not implement the index_to_node method" );
+  static_assert( has_get_node_v<Ntk>, "Ntk does not implement the get_node method" );
+  static_assert( has_foreach_po_v<Ntk>, "Ntk does not implement the foreach_po method" );
+  static_assert( has_foreach_node_v<Ntk>, "Ntk does not implement the foreach_node method" );
+  static_assert( has_fanout_size_v<Ntk>, "Ntk does not implement the fanout_size method" );
+  static_assert( has_clear_mapping_v<Ntk>, "Ntk does not implement the clear_mapping method" );
+  static_assert( has_add_to_mapping_v<Ntk>, "Ntk does not implement the add_to_mapping method" );
+  static_assert( !StoreFunction || has_set_cell_function_v<Ntk>, "Ntk does not implement the set_cell_function method" );
+
+  lut_mapping_stats st;
+  detail::lut_mapping_impl<Ntk, StoreFunction, CutData, TT> p( ntk, std::move( cuts ), ps, st );
   p.run();
   if ( ps.verbose )
   {
@@ -33,6 +33,7 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
 #include <cstdint>
 #include <vector>
 
@@ -47,6 +48,7 @@
 #include "../../io/write_bench.hpp"
 #include "../../networks/xag.hpp"
 #include "../../utils/node_map.hpp"
+#include "../../utils/npn4_cache.hpp"
 #include "../../utils/stopwatch.hpp"
 
 namespace mockturtle
@@ -126,6 +128,9 @@ public:
     _repr.reserve( 222u );
     build_classes();
     build_db();
+
+    _db_to_ntk.resize( _db.size() );
+    _db_marks.resize( _db.size(), 0u );
   }
 
   virtual ~xag_npn_resynthesis()
@@ -144,8 +149,18 @@ public:
   template<typename LeavesIterator, typename Fn>
   void operator()( Ntk& ntk, kitty::dynamic_truth_table const& function, LeavesIterator begin, LeavesIterator end, Fn&& fn )
   {
-    kitty::static_truth_table<4> tt = kitty::extend_to<4>( function );
+    ( *this )( ntk, kitty::extend_to<4>( function ), begin, end, fn );
+  }
 
+  /*! \brief Resynthesizes a function of up to 4 variables.
+   *
+   * Variables beyond the number of leaves must not be in the functional
+   * support of `tt`.  Unlike the overload for `kitty::dynamic_truth_table`,
+   * this one does not allocate memory to look up the function.
+   */
+  template<typename LeavesIterator, typename Fn>
+  void operator()( Ntk& ntk, kitty::static_truth_table<4> const& tt, LeavesIterator begin, LeavesIterator end, Fn&& fn )
+  {
     /* get representative of function */
     const auto repr = _repr[_classes[*tt.cbegin()]];
 
@@ -156,24 +171,24 @@ public:
       return;
     }
 
-    const auto config = kitty::exact_npn_canonization( tt );
+    auto const& config = _npn[tt];
 
-    assert( repr == std::get<0>( config ) );
+    assert( *repr.cbegin() == config.repr );
 
-    std::vector<signal<Ntk>> pis( 4, ntk.get_constant( false ) );
+    std::array<signal<Ntk>, 4> pis;
+    pis.fill( ntk.get_constant( false ) );
     std::copy( begin, end, pis.begin() );
 
-    std::vector<signal<Ntk>> pis_perm;
-    auto perm = std::get<2>( config );
+    std::array<signal<Ntk>, 4> pis_perm;
     for ( auto i = 0; i < 4; ++i )
     {
-      pis_perm.push_back( pis[perm[i]] );
+      pis_perm[i] = pis[config.perm[i]];
     }
 
-    const auto& phase = std::get<1>( config );
+    const auto phase = config.phase;
     for ( auto i = 0; i < 4; ++i )
     {
-      if ( ( phase >> perm[i] ) & 1 )
+      if ( ( phase >> config.perm[i] ) & 1 )
       {
         pis_perm[i] = ntk.create_not( pis_perm[i] );
       }
@@ -181,14 +196,18 @@ public:
 
     for ( auto const& cand : it->second )
     {
-      std::unordered_map<node<DatabaseNtk>, signal<Ntk>> db_to_ntk;
-
-      db_to_ntk.insert( {0, ntk.get_constant( false )} );
+      /* a new mark forgets the nodes copied for the previous candidate */
+      if ( ++_mark == 0u )
+      {
+        std::fill( _db_marks.begin(), _db_marks.end(), 0u );
+        _mark = 1u;
+      }
+      set_db_signal( 0, ntk.get_constant( false ) );
       for ( auto i = 0; i < 4; ++i )
       {
-        db_to_ntk.insert( {i + 1, pis_perm[i]} );
+        set_db_signal( i + 1, pis_perm[i] );
       }
-      auto f = copy_db_entry( ntk, _db.get_node( cand ), db_to_ntk );
+      auto f = copy_db_entry( ntk, _db.get_node( cand ) );
       if ( _db.is_complemented( cand ) != ( ( phase >> 4 ) & 1 ) )
       {
         f = ntk.create_not( f );
@@ -201,27 +220,33 @@ public:
   }
 
 private:
+  void set_db_signal( uint32_t index, signal<Ntk> const& f )
+  {
+    _db_to_ntk[index] = f;
+    _db_marks[index] = _mark;
+  }
+
   signal<Ntk>
-  copy_db_entry( Ntk& ntk, node<DatabaseNtk> const& n, std::unordered_map<node<DatabaseNtk>, signal<Ntk>>& db_to_ntk ) const
+  copy_db_entry( Ntk& ntk, node<DatabaseNtk> const& n )
   {
-    if ( const auto it = db_to_ntk.find( n ); it != db_to_ntk.end() )
+    const auto index = _db.node_to_index( n );
+    if ( _db_marks[index] == _mark )
     {
-      return it->second;
+      return _db_to_ntk[index];
     }
 
-    std::vector<signal<Ntk>> fanin;
-    //std::array<signal<Ntk>, 2> fanin;
-    _db.foreach_fanin( n, [&]( auto const& f ) {
-      auto ntk_f = copy_db_entry( ntk, _db.get_node( f ), db_to_ntk );
+    std::array<signal<Ntk>, 2> fanin;
+    _db.foreach_fanin( n, [&]( auto const& f, auto i ) {
+      auto ntk_f = copy_db_entry( ntk, _db.get_node( f ) );
       if ( _db.is_complemented( f ) )
       {
         ntk_f = ntk.create_not( ntk_f );
       }
-      fanin.push_back( ntk_f );
+      fanin[i] = ntk_f;
     } );
 
     const auto f = _db.is_xor( n ) ? ntk.create_xor( fanin[0], fanin[1] ) : ntk.create_and( fanin[0], fanin[1] );
-    db_to_ntk.insert( {n, f} );
+    set_db_signal( index, f );
     return f;
   }
 
@@ -328,6 +353,11 @@ private:
 
   DatabaseNtk _db;
 
+  npn4_cache _npn;
+  std::vector<signal<Ntk>> _db_to_ntk;
+  std::vector<uint32_t> _db_marks;
+  uint32_t _mark{0u};
+
   // clang-format off
   inline static const uint16_t subgraphs[]
   {
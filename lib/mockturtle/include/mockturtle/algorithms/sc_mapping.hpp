@@ -7,41 +7,588 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cstdint>
+#include <iostream>
+#include <limits>
+#include <vector>
 
 #include <fmt/format.h>
+#include <kitty/dynamic_truth_table.hpp>
 
+#include "../utils/stopwatch.hpp"
 #include "../views/topo_view.hpp"
 #include "cut_enumeration.hpp"
 #include "cut_enumeration/mf_cut.hpp"
 
-namespace mockturtle {
-    struct sc_mapping_params
+namespace mockturtle
+{
+
+/*! \brief Parameters for sc_mapping.
+ *
+ * The data structure `sc_mapping_params` holds configurable parameters
+ * with default arguments for `sc_mapping`.
+ */
+struct sc_mapping_params
+{
+  sc_mapping_params()
+  {
+    cut_enumeration_ps.cut_size = 6;
+    cut_enumeration_ps.cut_limit = 8;
+  }
+
+  /*! \brief Parameters for cut enumeration
+   *
+   * The default cut size is 6, the default cut limit is 8.
+   */
+  cut_enumeration_params cut_enumeration_ps{};
+
+  /*! \brief Number of rounds for area flow optimization.
+   *
+   * The first round is used for delay optimization.
+   */
+  uint32_t rounds{2u};
+
+  /*! \brief Number of rounds for exact area optimization. */
+  uint32_t rounds_ela{1u};
+
+  /*! \brief Be verbose. */
+  bool verbose{false};
+};
+
+/*! \brief Statistics for sc_mapping.
+ *
+ * The data structure `sc_mapping_stats` provides data collected by running
+ * `sc_mapping`.
+ */
+struct sc_mapping_stats
+{
+  /*! \brief Area of the mapped cells. */
+  double area{0.0};
+
+  /*! \brief Latest arrival time at the outputs. */
+  double delay{0.0};
+
+  /*! \brief Number of mapped cells. */
+  uint32_t num_cells{0u};
+
+  /*! \brief Number of cells for which no cut matched the library. */
+  uint32_t num_unmatched{0u};
+
+  /*! \brief Total runtime. */
+  stopwatch<>::duration time_total{0};
+
+  void report() const
+  {
+    std::cout << fmt::format( "[i] area = {:.2f}  delay = {:.2f}  cells = {}  unmatched = {}\n", area, delay, num_cells, num_unmatched );
+    std::cout << fmt::format( "[i] total time = {:>5.2f} secs\n", to_seconds( time_total ) );
+  }
+};
+
+/*! \brief Cost of a library implementation of a cut function.
+ *
+ * `delays[i]` is the delay from the i-th cut leaf to the output.
+ */
+struct sc_supergate
+{
+  double area{0.0};
+  std::vector<double> delays;
+};
+
+namespace detail
+{
+
+template<class Ntk, class Library>
+class sc_mapping_impl
+{
+public:
+  using network_cuts_t = network_cuts<Ntk, true, cut_enumeration_mf_cut>;
+  using cut_t = typename network_cuts_t::cut_t;
+
+public:
+  sc_mapping_impl( Ntk& ntk, Library const& library, sc_mapping_params const& ps, sc_mapping_stats& st )
+      : ntk( ntk ),
+        library( library ),
+        ps( ps ),
+        st( st ),
+        flow_refs( ntk.size() ),
+        map_refs( ntk.size(), 0 ),
+        flows( ntk.size(), 0.0 ),
+        arrivals( ntk.size(), 0.0 ),
+        requireds( ntk.size(), std::numeric_limits<double>::max() ),
+        best( ntk.size(), 0 ),
+        offsets( ntk.size() + 1, 0 ),
+        cuts( cut_enumeration<Ntk, true, cut_enumeration_mf_cut>( ntk, ps.cut_enumeration_ps ) )
+  {
+  }
+
+  void run()
+  {
+    stopwatch t( st.time_total );
+
+    /* compute and save topological order */
+    top_order.reserve( ntk.size() );
+    topo_view<Ntk>( ntk ).foreach_node( [this]( auto n ) {
+      top_order.push_back( n );
+    } );
+
+    match_cuts();
+    init_nodes();
+
+    while ( iteration < ps.rounds )
+    {
+      compute_mapping<false>();
+    }
+
+    while ( iteration < ps.rounds + ps.rounds_ela )
+    {
+      compute_mapping<true>();
+    }
+
+    derive_mapping();
+  }
+
+private:
+  /* matches every non-trivial cut against the library; nodes without any
+   * matching cut keep their first non-trivial cut as an unmatched cell */
+  void match_cuts()
+  {
+    for ( auto i = 0u; i < ntk.size(); ++i )
     {
-        sc_mapping_params()
+      offsets[i + 1] = offsets[i] + cuts.cuts( i ).size();
+    }
+    matches.resize( offsets.back(), nullptr );
+
+    for ( auto const& n : top_order )
+    {
+      if ( ntk.is_constant( n ) || ntk.is_pi( n ) )
+        continue;
+
+      const auto index = ntk.node_to_index( n );
+      auto const& set = cuts.cuts( index );
+      int32_t fallback{-1};
+      bool matched{false};
+      for ( auto i = 0u; i < set.size(); ++i )
+      {
+        if ( is_trivial( index, set[i] ) )
+          continue;
+        if ( fallback == -1 )
+          fallback = i;
+        matches[offsets[index] + i] = library.match( cuts.truth_table( set[i] ) );
+        matched = matched || matches[offsets[index] + i] != nullptr;
+      }
+      if ( !matched && fallback != -1 )
+      {
+        matches[offsets[index] + fallback] = &unmatched;
+      }
+    }
+  }
+
+  void init_nodes()
+  {
+    ntk.foreach_node( [this]( auto n, auto ) {
+      const auto index = ntk.node_to_index( n );
+
+      if ( ntk.is_constant( n ) || ntk.is_pi( n ) )
+      {
+        /* all terminals have flow 1.0 */
+        flow_refs[index] = 1.0;
+      }
+      else
+      {
+        flow_refs[index] = static_cast<double>( ntk.fanout_size( n ) );
+      }
+    } );
+  }
+
+  template<bool ELA>
+  void compute_mapping()
+  {
+    for ( auto const& n : top_order )
+    {
+      if ( ntk.is_constant( n ) || ntk.is_pi( n ) )
+        continue;
+      compute_best_cut<ELA>( ntk.node_to_index( n ) );
+    }
+    set_mapping_refs<ELA>();
+  }
+
+  template<bool ELA>
+  void set_mapping_refs()
+  {
+    const auto coef = 1.0 / ( 1.0 + ( iteration + 1 ) * ( iteration + 1 ) );
+
+    if constexpr ( !ELA )
+    {
+      std::fill( map_refs.begin(), map_refs.end(), 0 );
+    }
+
+    /* compute current delay and update mapping refs */
+    delay = 0.0;
+    ntk.foreach_po( [this]( auto s ) {
+      const auto index = ntk.node_to_index( ntk.get_node( s ) );
+      delay = std::max( delay, arrivals[index] );
+
+      if constexpr ( !ELA )
+      {
+        map_refs[index]++;
+      }
+    } );
+
+    /* the first round fixes the delay target of the area recovery */
+    if ( iteration == 0 )
+    {
+      target = delay;
+    }
+
+    /* compute current area, update mapping refs, and propagate required times */
+    area = 0.0;
+    std::fill( requireds.begin(), requireds.end(), std::numeric_limits<double>::max() );
+    ntk.foreach_po( [this]( auto s ) {
+      requireds[ntk.node_to_index( ntk.get_node( s ) )] = target;
+    } );
+    for ( auto it = top_order.rbegin(); it != top_order.rend(); ++it )
+    {
+      if ( ntk.is_constant( *it ) || ntk.is_pi( *it ) )
+        continue;
+
+      const auto index = ntk.node_to_index( *it );
+      if ( map_refs[index] == 0 )
+        continue;
+
+      auto const& cut = cuts.cuts( index )[best[index]];
+      auto const* gate = matches[offsets[index] + best[index]];
+      auto i = 0u;
+      for ( auto leaf : cut )
+      {
+        if constexpr ( !ELA )
         {
-            cut_enumeration_ps.cut_size = 6;
-            cut_enumeration_ps.cut_limit = 8;
+          map_refs[leaf]++;
         }
+        requireds[leaf] = std::min( requireds[leaf], requireds[index] - leaf_delay( *gate, i++ ) );
+      }
+      area += gate->area;
+    }
 
-        /*! \brief Parameters for cut enumeration
-         *
-         * The default cut size is 6, the default cut limit is 8.
-         */
-        cut_enumeration_params cut_enumeration_ps{};
+    /* blend flow references */
+    for ( auto i = 0u; i < ntk.size(); ++i )
+    {
+      flow_refs[i] = coef * flow_refs[i] + ( 1.0 - coef ) * std::max<double>( 1.0, map_refs[i] );
+    }
 
-        /*! \brief Number of rounds for area flow optimization.
-         *
-         * The first round is used for delay optimization.
-         */
-        uint32_t rounds{2u};
+    ++iteration;
+  }
 
-        /*! \brief Number of rounds for exact area optimization. */
-        uint32_t rounds_ela{1u};
-    };
+  bool is_trivial( uint32_t index, cut_t const& cut ) const
+  {
+    return cut.size() == 1 && *cut.begin() == index;
+  }
 
-    namespace detail {
+  static double leaf_delay( sc_supergate const& gate, uint32_t leaf )
+  {
+    return leaf < gate.delays.size() ? gate.delays[leaf] : 0.0;
+  }
 
+  double cut_arrival( cut_t const& cut, sc_supergate const& gate ) const
+  {
+    double time{0.0};
+    auto i = 0u;
+    for ( auto leaf : cut )
+    {
+      time = std::max( time, arrivals[leaf] + leaf_delay( gate, i++ ) );
+    }
+    return time;
+  }
+
+  double cut_flow( cut_t const& cut, sc_supergate const& gate ) const
+  {
+    double flow{gate.area};
+    for ( auto leaf : cut )
+    {
+      flow += flows[leaf];
+    }
+    return flow;
+  }
+
+  /* reference cut:
+   *   adds cut to current mapping and recursively adds best cuts of leaf
+   *   nodes, if they are not part of the current mapping.
+   */
+  double cut_ref( uint32_t index )
+  {
+    double area = matches[offsets[index] + best[index]]->area;
+    for ( auto leaf : cuts.cuts( index )[best[index]] )
+    {
+      if ( ntk.is_constant( ntk.index_to_node( leaf ) ) || ntk.is_pi( ntk.index_to_node( leaf ) ) )
+        continue;
+
+      if ( map_refs[leaf]++ == 0 )
+      {
+        area += cut_ref( leaf );
+      }
+    }
+    return area;
+  }
+
+  /* dereference cut:
+   *   removes cut from current mapping and recursively removes best cuts of
+   *   leaf nodes, if they are part of the current mapping.
+   *   (this is the inverse operation to cut_ref)
+   */
+  double cut_deref( uint32_t index )
+  {
+    double area = matches[offsets[index] + best[index]]->area;
+    for ( auto leaf : cuts.cuts( index )[best[index]] )
+    {
+      if ( ntk.is_constant( ntk.index_to_node( leaf ) ) || ntk.is_pi( ntk.index_to_node( leaf ) ) )
+        continue;
+
+      if ( --map_refs[leaf] == 0 )
+      {
+        area += cut_deref( leaf );
+      }
+    }
+    return area;
+  }
+
+  /* reference cut (special version):
+   *   this special version of cut_ref does two additional things:
+   *   1. it stops recursing if it has found `limit` cuts
+   *   2. it remembers all cuts for which the reference count increases in the
+   *      vector `tmp_area`.
+   */
+  double cut_ref_limit_save( cut_t const& cut, sc_supergate const& gate, uint32_t limit )
+  {
+    double area = gate.area;
+    if ( limit == 0 )
+      return area;
+
+    for ( auto leaf : cut )
+    {
+      if ( ntk.is_constant( ntk.index_to_node( leaf ) ) || ntk.is_pi( ntk.index_to_node( leaf ) ) )
+        continue;
+
+      tmp_area.push_back( leaf );
+      if ( map_refs[leaf]++ == 0 )
+      {
+        area += cut_ref_limit_save( cuts.cuts( leaf )[best[leaf]], *matches[offsets[leaf] + best[leaf]], limit - 1 );
+      }
+    }
+    return area;
+  }
+
+  /* estimates the area of adding this cut to the mapping, see cut_ref_limit_save */
+  double cut_area_estimation( cut_t const& cut, sc_supergate const& gate )
+  {
+    tmp_area.clear();
+    const auto area = cut_ref_limit_save( cut, gate, 8 );
+    for ( auto const& n : tmp_area )
+    {
+      map_refs[n]--;
+    }
+    return area;
+  }
+
+  template<bool ELA>
+  void compute_best_cut( uint32_t index )
+  {
+    constexpr auto mf_eps{0.005};
+
+    /* the delay round selects the fastest cut, area recovery the smallest
+     * cut that meets the required time of the current mapping */
+    const bool delay_round = iteration == 0;
+    const auto required = requireds[index] + mf_eps;
+
+    double flow{0.0};
+    int32_t best_cut{-1};
+    double best_flow{std::numeric_limits<double>::max()};
+    double best_time{std::numeric_limits<double>::max()};
+    bool best_meets{false};
+
+    if constexpr ( ELA )
+    {
+      if ( map_refs[index] > 0 )
+      {
+        cut_deref( index );
+      }
     }
 
+    auto const& set = cuts.cuts( index );
+    for ( auto i = 0u; i < set.size(); ++i )
+    {
+      auto const* gate = matches[offsets[index] + i];
+      if ( gate == nullptr )
+        continue;
+
+      if constexpr ( ELA )
+      {
+        flow = cut_area_estimation( set[i], *gate );
+      }
+      else
+      {
+        flow = cut_flow( set[i], *gate );
+      }
+      const auto time = cut_arrival( set[i], *gate );
+      const bool meets = time <= required;
+
+      bool better;
+      if ( delay_round || !( meets || best_meets ) )
+      {
+        better = best_time > time + mf_eps || ( best_time > time - mf_eps && best_flow > flow );
+      }
+      else
+      {
+        better = ( meets && !best_meets ) || ( meets && ( best_flow > flow + mf_eps || ( best_flow > flow - mf_eps && best_time > time ) ) );
+      }
+
+      if ( best_cut == -1 || better )
+      {
+        best_cut = i;
+        best_flow = flow;
+        best_time = time;
+        best_meets = meets;
+      }
+    }
+
+    if ( best_cut == -1 )
+      return;
+
+    best[index] = best_cut;
+    if constexpr ( ELA )
+    {
+      if ( map_refs[index] > 0 )
+      {
+        cut_ref( index );
+      }
+    }
+    arrivals[index] = best_time;
+    flows[index] = best_flow / flow_refs[index];
+  }
+
+  void derive_mapping()
+  {
+    ntk.clear_mapping();
+
+    st.area = area;
+    st.delay = delay;
+    st.num_cells = 0u;
+    st.num_unmatched = 0u;
+    for ( auto const& n : top_order )
+    {
+      if ( ntk.is_constant( n ) || ntk.is_pi( n ) )
+        continue;
+
+      const auto index = ntk.node_to_index( n );
+      if ( map_refs[index] == 0 )
+        continue;
+
+      std::vector<node<Ntk>> nodes;
+      auto const& cut = cuts.cuts( index )[best[index]];
+      for ( auto const& l : cut )
+      {
+        nodes.push_back( ntk.index_to_node( l ) );
+      }
+      ntk.add_to_mapping( n, nodes.begin(), nodes.end() );
+      ntk.set_cell_function( n, cuts.truth_table( cut ) );
+
+      ++st.num_cells;
+      if ( matches[offsets[index] + best[index]] == &unmatched )
+        ++st.num_unmatched;
+    }
+  }
+
+private:
+  Ntk& ntk;
+  Library const& library;
+  sc_mapping_params const& ps;
+  sc_mapping_stats& st;
+
+  uint32_t iteration{0}; /* current mapping iteration */
+  double delay{0.0};     /* current delay of the mapping */
+  double target{0.0};    /* delay of the delay oriented mapping */
+  double area{0.0};      /* current area of the mapping */
+
+  std::vector<node<Ntk>> top_order;
+  std::vector<double> flow_refs;
+  std::vector<uint32_t> map_refs;
+  std::vector<double> flows;
+  std::vector<double> arrivals;
+  std::vector<double> requireds;
+  std::vector<uint32_t> best;    /* position of the selected cut of every node */
+  std::vector<uint32_t> offsets; /* first entry of every node in matches */
+  std::vector<sc_supergate const*> matches;
+  network_cuts_t cuts;
+
+  sc_supergate const unmatched{};
+  std::vector<uint32_t> tmp_area; /* temporary vector to compute exact area */
+};
+
+}; /* namespace detail */
+
+/*! \brief Standard cell mapping.
+ *
+ * This function maps `ntk` to the cells of `library` with the same cut based
+ * algorithm as `lut_mapping`: priority cuts and their truth tables are
+ * enumerated once, and every cut is matched against the library.  The first
+ * round selects for every node the cut with the earliest arrival time, the
+ * remaining area flow and exact area rounds select the smallest cut that
+ * does not exceed the required time of the delay oriented mapping.  The
+ * selected cuts and their functions are stored in the mapping of `ntk`, as
+ * with `lut_mapping` for `StoreFunction`.
+ *
+ * The library must implement
+ *
+ * - `sc_supergate const* match( kitty::dynamic_truth_table const& function ) const`
+ *
+ * which returns the area and the per input delays of an implementation of
+ * `function`, whose variables are the cut leaves, or `nullptr` if the
+ * library cannot implement it.  Returned supergates must stay valid while
+ * mapping.  Nodes none of whose cuts match are mapped with an unmatched cut
+ * of area and delay 0, which is counted in the statistics.
+ *
+ * **Required network functions:**
+ * - `size`
+ * - `is_pi`
+ * - `is_constant`
+ * - `node_to_index`
+ * - `index_to_node`
+ * - `get_node`
+ * - `foreach_po`
+ * - `foreach_node`
+ * - `fanout_size`
+ * - `clear_mapping`
+ * - `add_to_mapping`
+ * - `set_cell_function`
+ */
+template<class Ntk, class Library>
+void sc_mapping( Ntk& ntk, Library const& library, sc_mapping_params const& ps = {}, sc_mapping_stats* pst = nullptr )
+{
+  static_assert( is_network_type_v<Ntk>, "Ntk is not a network type" );
+  static_assert( has_size_v<Ntk>, "Ntk does not implement the size method" );
+  static_assert( has_is_pi_v<Ntk>, "Ntk does not implement the is_pi method" );
+  static_assert( has_is_constant_v<Ntk>, "Ntk does not implement the is_constant method" );
+  static_assert( has_node_to_index_v<Ntk>, "Ntk does not implement the node_to_index method" );
+  static_assert( has_index_to_node_v<Ntk>, "Ntk does not implement the index_to_node method" );
+  static_assert( has_get_node_v<Ntk>, "Ntk does not implement the get_node method" );
+  static_assert( has_foreach_po_v<Ntk>, "Ntk does not implement the foreach_po method" );
+  static_assert( has_foreach_node_v<Ntk>, "Ntk does not implement the foreach_node method" );
+  static_assert( has_fanout_size_v<Ntk>, "Ntk does not implement the fanout_size method" );
+  static_assert( has_clear_mapping_v<Ntk>, "Ntk does not implement the clear_mapping method" );
+  static_assert( has_add_to_mapping_v<Ntk>, "Ntk does not implement the add_to_mapping method" );
+  static_assert( has_set_cell_function_v<Ntk>, "Ntk does not implement the set_cell_function method" );
+
+  sc_mapping_stats st;
+  detail::sc_mapping_impl<Ntk, Library> p( ntk, library, ps, st );
+  p.run();
+  if ( ps.verbose )
+  {
+    st.report();
+  }
+
+  if ( pst )
+  {
+    *pst = st;
+  }
 }
+
+} /* namespace mockturtle */
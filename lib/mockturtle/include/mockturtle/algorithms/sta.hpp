@@ -1 +1,385 @@
-//
\ No newline at end of file
+/* mockturtle: C++ logic network library
+ * Copyright (C) 2018-2019  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*!
+  \file sta.hpp
+  \brief Static timing analysis with NLDM delays of Liberty cells
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../io/liberty_reader.hpp"
+#include "../traits.hpp"
+
+namespace mockturtle
+{
+
+/*! \brief Library cell of a gate and the cell input driven by each fanin */
+struct liberty_binding
+{
+  liberty_cell const* cell = nullptr;
+  /*! \brief Input pin of the i-th fanin, liberty_cell::no_pin if the cell has none */
+  std::vector<uint32_t> pins;
+};
+
+/*! \brief Binds the cell to fanins connected to the given pins, in order
+ *
+ * Returns nothing if the library has no such cell.  The binding points into
+ * the library, which must not be extended while it is used.
+ */
+inline std::optional<liberty_binding> bind_cell( liberty_library const& library, std::string const& cell, std::vector<std::string> const& pins )
+{
+  liberty_binding binding;
+  binding.cell = library.find( cell );
+  if ( binding.cell == nullptr )
+    return std::nullopt;
+  for ( auto const& pin : pins )
+    binding.pins.push_back( binding.cell->find_input( pin ) );
+  return binding;
+}
+
+struct sta_params
+{
+  /*! \brief Required time at the outputs, the latest output arrival if 0 */
+  double clock_period{0.0};
+
+  /*! \brief Arrival time of the primary inputs */
+  double input_arrival{0.0};
+
+  /*! \brief Slew of the primary inputs */
+  double input_slew{0.0};
+
+  /*! \brief Load on every primary output */
+  double output_load{0.0};
+
+  /*! \brief Wire load added for every fanout */
+  double wire_load{0.0};
+};
+
+/*! \brief Timing of every node of a network
+ *
+ * Arrival, required and slew times are stored in flat arrays with the rise
+ * time of node index i at 2 * i and the fall time at 2 * i + 1.  Nodes
+ * without a path to an output have an infinite required time.  Times and
+ * loads are in the units of the library.
+ */
+struct sta_result
+{
+  std::vector<double> arrivals;
+  std::vector<double> requireds;
+  std::vector<double> slews;
+  std::vector<double> loads;
+
+  /*! \brief Required time of the outputs */
+  double clock_period{0.0};
+  double worst_arrival{0.0};
+  /*! \brief Smallest slack of an output */
+  double worst_slack{0.0};
+  /*! \brief Sum of the negative slacks of all outputs */
+  double total_negative_slack{0.0};
+  uint32_t num_endpoints{0u};
+  /*! \brief Gates with fanout that have no binding and are timed as wires */
+  uint32_t num_unbound{0u};
+
+  double arrival( uint32_t index ) const
+  {
+    return std::max( arrivals[2u * index], arrivals[2u * index + 1u] );
+  }
+
+  double required( uint32_t index ) const
+  {
+    return std::min( requireds[2u * index], requireds[2u * index + 1u] );
+  }
+
+  double slack( uint32_t index ) const
+  {
+    return std::min( requireds[2u * index] - arrivals[2u * index], requireds[2u * index + 1u] - arrivals[2u * index + 1u] );
+  }
+};
+
+namespace detail
+{
+
+/* node indices with every node after its fanins */
+inline std::vector<uint32_t> sta_order( std::vector<uint32_t> const& begin, std::vector<uint32_t> const& end, std::vector<uint32_t> const& fanins,
+                                        std::vector<uint8_t> const& alive )
+{
+  const uint32_t size = static_cast<uint32_t>( begin.size() );
+  std::vector<uint32_t> order;
+  order.reserve( size );
+
+  bool sorted = true;
+  for ( uint32_t i = 0u; i < size && sorted; i++ )
+  {
+    for ( auto k = begin[i]; k < end[i]; k++ )
+      sorted &= fanins[k] < i;
+  }
+  if ( sorted )
+  {
+    for ( uint32_t i = 0u; i < size; i++ )
+    {
+      if ( alive[i] )
+        order.push_back( i );
+    }
+    return order;
+  }
+
+  std::vector<uint8_t> visited( size, 0u );
+  std::vector<std::pair<uint32_t, uint32_t>> stack;
+  for ( uint32_t root = 0u; root < size; root++ )
+  {
+    if ( !alive[root] || visited[root] )
+      continue;
+    visited[root] = 1u;
+    stack.emplace_back( root, begin[root] );
+    while ( !stack.empty() )
+    {
+      auto& [index, next] = stack.back();
+      if ( next < end[index] )
+      {
+        const uint32_t fanin = fanins[next++];
+        if ( !visited[fanin] )
+        {
+          visited[fanin] = 1u;
+          stack.emplace_back( fanin, begin[fanin] );
+        }
+      }
+      else
+      {
+        order.push_back( index );
+        stack.pop_back();
+      }
+    }
+  }
+  return order;
+}
+
+} /* namespace detail */
+
+/*! \brief Static timing analysis with NLDM cell delays
+ *
+ * `binding( n )` returns the liberty_binding of gate `n`, or nullptr for
+ * gates without a cell.  The load of a gate is the sum of the input
+ * capacitances it drives, plus the wire load of every fanout and the output
+ * load of every output it drives.  One forward pass propagates rise and fall
+ * arrival times and slews through the timing arcs of every cell, following
+ * their timing sense and taking the latest arrival and the largest slew;
+ * one backward pass computes required times from the clock period.  Fanins
+ * of gates without a binding, and fanins on pins without timing arcs, are
+ * timed as wires.  Delays are table lookups on flat arrays, so the analysis
+ * is linear in the number of fanins.
+ *
+ * **Required network functions:**
+ * - `size`
+ * - `foreach_node`
+ * - `foreach_fanin`
+ * - `foreach_po`
+ * - `get_node`
+ * - `node_to_index`
+ * - `is_constant`
+ * - `is_ci`
+ */
+template<class Ntk, class Binding>
+sta_result static_timing_analysis( Ntk const& ntk, Binding&& binding, sta_params const& ps = {} )
+{
+  static_assert( is_network_type_v<Ntk>, "Ntk is not a network type" );
+  static_assert( has_size_v<Ntk>, "Ntk does not implement the size method" );
+  static_assert( has_foreach_node_v<Ntk>, "Ntk does not implement the foreach_node method" );
+  static_assert( has_foreach_fanin_v<Ntk>, "Ntk does not implement the foreach_fanin method" );
+  static_assert( has_foreach_po_v<Ntk>, "Ntk does not implement the foreach_po method" );
+  static_assert( has_get_node_v<Ntk>, "Ntk does not implement the get_node method" );
+  static_assert( has_node_to_index_v<Ntk>, "Ntk does not implement the node_to_index method" );
+  static_assert( has_is_constant_v<Ntk>, "Ntk does not implement the is_constant method" );
+  static_assert( has_is_ci_v<Ntk>, "Ntk does not implement the is_ci method" );
+
+  constexpr double infinity = std::numeric_limits<double>::infinity();
+  const uint32_t size = ntk.size();
+
+  sta_result result;
+  result.arrivals.assign( 2u * size, 0.0 );
+  result.requireds.assign( 2u * size, infinity );
+  result.slews.assign( 2u * size, 0.0 );
+  result.loads.assign( size, 0.0 );
+  auto& arrivals = result.arrivals;
+  auto& requireds = result.requireds;
+  auto& slews = result.slews;
+  auto& loads = result.loads;
+
+  /* fanins, bindings and loads */
+  std::vector<uint32_t> begin( size, 0u ), end( size, 0u ), fanins;
+  std::vector<liberty_binding const*> cells( size, nullptr );
+  std::vector<uint8_t> alive( size, 0u ), gate( size, 0u ), input( size, 0u ), driver( size, 0u );
+  fanins.reserve( size * 2u );
+  ntk.foreach_node( [&]( auto const& n ) {
+    const uint32_t index = ntk.node_to_index( n );
+    alive[index] = 1u;
+    input[index] = ntk.is_ci( n );
+    if ( ntk.is_constant( n ) || ntk.is_ci( n ) )
+      return;
+    gate[index] = 1u;
+    liberty_binding const* b = binding( n );
+    cells[index] = b;
+    begin[index] = static_cast<uint32_t>( fanins.size() );
+    ntk.foreach_fanin( n, [&]( auto const& f ) {
+      const uint32_t fanin = ntk.node_to_index( ntk.get_node( f ) );
+      const uint32_t i = static_cast<uint32_t>( fanins.size() ) - begin[index];
+      const uint32_t pin = b != nullptr && i < b->pins.size() ? b->pins[i] : liberty_cell::no_pin;
+      loads[fanin] += ( pin != liberty_cell::no_pin ? b->cell->capacitances[pin] : 0.0 ) + ps.wire_load;
+      driver[fanin] = 1u;
+      fanins.push_back( fanin );
+    } );
+    end[index] = static_cast<uint32_t>( fanins.size() );
+  } );
+  ntk.foreach_po( [&]( auto const& f ) {
+    const uint32_t index = ntk.node_to_index( ntk.get_node( f ) );
+    loads[index] += ps.output_load + ps.wire_load;
+    driver[index] = 1u;
+  } );
+  for ( uint32_t i = 0u; i < size; i++ )
+    result.num_unbound += gate[i] && driver[i] && cells[i] == nullptr;
+
+  /* calls fn( fanin, arc ) for every arc of the k-th fanin of gate index, or with nullptr for a wire */
+  auto foreach_arc = [&]( uint32_t index, uint32_t k, auto&& fn ) {
+    liberty_binding const* b = cells[index];
+    const uint32_t i = k - begin[index];
+    const uint32_t pin = b != nullptr && i < b->pins.size() ? b->pins[i] : liberty_cell::no_pin;
+    if ( pin == liberty_cell::no_pin || b->cell->pin_arcs[pin].empty() )
+    {
+      fn( fanins[k], static_cast<liberty_arc const*>( nullptr ) );
+      return;
+    }
+    for ( auto a : b->cell->pin_arcs[pin] )
+      fn( fanins[k], &b->cell->arcs[a] );
+  };
+  /* calls fn( input transition, output transition ) for the transitions related by the arc */
+  auto foreach_transition = []( liberty_arc const* arc, auto&& fn ) {
+    for ( uint32_t out = 0u; out < 2u; out++ )
+    {
+      for ( uint32_t in = 0u; in < 2u; in++ )
+      {
+        const bool unate = arc == nullptr || arc->sense == liberty_timing_sense::positive_unate;
+        if ( unate ? in != out : arc->sense == liberty_timing_sense::negative_unate && in == out )
+          continue;
+        fn( in, out );
+      }
+    }
+  };
+
+  /* arrival times and slews, fanins first */
+  const auto order = detail::sta_order( begin, end, fanins, alive );
+  for ( auto index : order )
+  {
+    if ( input[index] )
+    {
+      arrivals[2u * index] = arrivals[2u * index + 1u] = ps.input_arrival;
+      slews[2u * index] = slews[2u * index + 1u] = ps.input_slew;
+    }
+    if ( !gate[index] || begin[index] == end[index] )
+      continue;
+    double arrival[2] = {-infinity, -infinity}, slew[2] = {0.0, 0.0};
+    for ( auto k = begin[index]; k < end[index]; k++ )
+    {
+      foreach_arc( index, k, [&]( uint32_t fanin, liberty_arc const* arc ) {
+        foreach_transition( arc, [&]( uint32_t in, uint32_t out ) {
+          const double in_slew = slews[2u * fanin + in];
+          if ( arc == nullptr )
+          {
+            arrival[out] = std::max( arrival[out], arrivals[2u * fanin + in] );
+            slew[out] = std::max( slew[out], in_slew );
+            return;
+          }
+          auto const& delay = out == 0u ? arc->cell_rise : arc->cell_fall;
+          auto const& transition = out == 0u ? arc->rise_transition : arc->fall_transition;
+          if ( delay.empty() )
+            return;
+          arrival[out] = std::max( arrival[out], arrivals[2u * fanin + in] + delay.lookup( in_slew, loads[index] ) );
+          slew[out] = std::max( slew[out], transition.lookup( in_slew, loads[index] ) );
+        } );
+      } );
+    }
+    for ( uint32_t t = 0u; t < 2u; t++ )
+    {
+      arrivals[2u * index + t] = arrival[t] == -infinity ? 0.0 : arrival[t];
+      slews[2u * index + t] = slew[t];
+    }
+  }
+
+  /* outputs */
+  std::vector<uint32_t> endpoints;
+  ntk.foreach_po( [&]( auto const& f ) {
+    const auto n = ntk.get_node( f );
+    if ( ntk.is_constant( n ) )
+      return;
+    endpoints.push_back( ntk.node_to_index( n ) );
+    result.worst_arrival = std::max( result.worst_arrival, result.arrival( endpoints.back() ) );
+  } );
+  result.clock_period = ps.clock_period > 0.0 ? ps.clock_period : result.worst_arrival;
+  for ( auto index : endpoints )
+    requireds[2u * index] = requireds[2u * index + 1u] = result.clock_period;
+
+  /* required times, fanouts first */
+  for ( auto it = order.rbegin(); it != order.rend(); ++it )
+  {
+    const uint32_t index = *it;
+    if ( !gate[index] || ( requireds[2u * index] == infinity && requireds[2u * index + 1u] == infinity ) )
+      continue;
+    for ( auto k = begin[index]; k < end[index]; k++ )
+    {
+      foreach_arc( index, k, [&]( uint32_t fanin, liberty_arc const* arc ) {
+        foreach_transition( arc, [&]( uint32_t in, uint32_t out ) {
+          double delay = 0.0;
+          if ( arc != nullptr )
+          {
+            auto const& table = out == 0u ? arc->cell_rise : arc->cell_fall;
+            if ( table.empty() )
+              return;
+            delay = table.lookup( slews[2u * fanin + in], loads[index] );
+          }
+          auto& required = requireds[2u * fanin + in];
+          required = std::min( required, requireds[2u * index + out] - delay );
+        } );
+      } );
+    }
+  }
+
+  for ( auto index : endpoints )
+  {
+    const double slack = result.slack( index );
+    result.worst_slack = result.num_endpoints == 0u ? slack : std::min( result.worst_slack, slack );
+    result.total_negative_slack += std::min( 0.0, slack );
+    ++result.num_endpoints;
+  }
+  return result;
+}
+
+} /* namespace mockturtle */
@@ -0,0 +1,484 @@
+/* mockturtle: C++ logic network library
+ * Copyright (C) 2018-2019  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*!
+  \file liberty_reader.hpp
+  \brief Lorina reader for the combinational timing of Liberty cell libraries
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <lorina/liberty.hpp>
+
+namespace mockturtle
+{
+
+/*! \brief NLDM lookup table indexed by input slew and output load */
+struct liberty_table
+{
+  std::vector<double> slews;
+  std::vector<double> loads;
+  /*! \brief One row of loads.size() values per slew */
+  std::vector<double> values;
+
+  bool empty() const
+  {
+    return values.empty();
+  }
+
+  /*! \brief Bilinear interpolation, extrapolating beyond the table */
+  double lookup( double slew, double load ) const
+  {
+    if ( values.empty() )
+      return 0.0;
+    const auto [i, ti] = segment( slews, slew );
+    const auto [j, tj] = segment( loads, load );
+    const uint32_t columns = std::max<uint32_t>( 1u, static_cast<uint32_t>( loads.size() ) );
+    const uint32_t i1 = slews.size() > 1u ? i + 1u : i;
+    const uint32_t j1 = loads.size() > 1u ? j + 1u : j;
+    auto at = [&]( uint32_t r, uint32_t c ) { return values[r * columns + c]; };
+    const double low = at( i, j ) + tj * ( at( i, j1 ) - at( i, j ) );
+    const double high = at( i1, j ) + tj * ( at( i1, j1 ) - at( i1, j ) );
+    return low + ti * ( high - low );
+  }
+
+private:
+  /* index of the axis segment around x and the position of x in it */
+  static std::pair<uint32_t, double> segment( std::vector<double> const& axis, double x )
+  {
+    if ( axis.size() < 2u )
+      return {0u, 0.0};
+    const auto upper = std::upper_bound( axis.begin() + 1, axis.end() - 1, x );
+    const uint32_t i = static_cast<uint32_t>( upper - axis.begin() ) - 1u;
+    const double width = axis[i + 1u] - axis[i];
+    return {i, width == 0.0 ? 0.0 : ( x - axis[i] ) / width};
+  }
+};
+
+enum class liberty_timing_sense
+{
+  positive_unate,
+  negative_unate,
+  non_unate
+};
+
+/*! \brief Combinational timing arc from an input pin to the output of a cell */
+struct liberty_arc
+{
+  uint32_t pin = 0u;
+  liberty_timing_sense sense = liberty_timing_sense::non_unate;
+  liberty_table cell_rise;
+  liberty_table cell_fall;
+  liberty_table rise_transition;
+  liberty_table fall_transition;
+};
+
+/*! \brief Input pins, output pin and combinational timing arcs of a cell */
+struct liberty_cell
+{
+  static constexpr uint32_t no_pin = UINT32_MAX;
+
+  std::string name;
+  double area = 0.0;
+  std::vector<std::string> inputs;
+  std::vector<double> capacitances;
+  /*! \brief First output pin; only its arcs are kept */
+  std::string output;
+  std::vector<liberty_arc> arcs;
+  /*! \brief Indices into arcs of the arcs of every input pin */
+  std::vector<std::vector<uint32_t>> pin_arcs;
+
+  uint32_t find_input( std::string const& pin ) const
+  {
+    const auto it = std::find( inputs.begin(), inputs.end(), pin );
+    return it == inputs.end() ? no_pin : static_cast<uint32_t>( it - inputs.begin() );
+  }
+};
+
+/*! \brief Timing view of a Liberty library
+ *
+ * Times and capacitances are kept in the units of the library, which are
+ * recorded as given in time_unit and capacitive_load_unit.
+ */
+struct liberty_library
+{
+  std::string name;
+  std::string time_unit;
+  std::string capacitance_unit;
+  std::vector<liberty_cell> cells;
+  std::unordered_map<std::string, uint32_t> cell_index;
+
+  /*! \brief Cell with the given name, nullptr if the library has none */
+  liberty_cell const* find( std::string const& cell ) const
+  {
+    const auto it = cell_index.find( cell );
+    return it == cell_index.end() ? nullptr : &cells[it->second];
+  }
+};
+
+/*! \brief Lorina reader callback for Liberty files.
+ *
+ * Collects the input capacitances and the combinational NLDM delay and
+ * transition tables of every cell.  Reading several files into the same
+ * library adds their cells; a cell read again replaces the earlier one.
+ * Sequential arcs, power tables and bus pins are skipped.
+ *
+   \verbatim embed:rst
+
+   Example
+
+   .. code-block:: c++
+
+      liberty_library library;
+      lorina::read_liberty( "cells.lib", liberty_reader( library ) );
+   \endverbatim
+ */
+class liberty_reader : public lorina::liberty_reader
+{
+public:
+  explicit liberty_reader( liberty_library& library )
+      : _library( library )
+  {
+  }
+
+  void on_group_begin( const std::string& name, const std::vector<std::string>& args ) const override
+  {
+    const std::string parent = _groups.empty() ? "" : _groups.back();
+    _groups.push_back( name );
+    const std::string arg = args.empty() ? "" : unquote( args.front() );
+
+    if ( name == "library" )
+    {
+      _library.name = arg;
+    }
+    else if ( name == "lu_table_template" && parent == "library" )
+    {
+      _template_name = arg;
+      _template = table_template{};
+    }
+    else if ( name == "cell" && parent == "library" )
+    {
+      _cell = liberty_cell{};
+      _cell.name = arg;
+      _cell_arcs.clear();
+    }
+    else if ( name == "pin" && parent == "cell" )
+    {
+      _pin = pin_group{};
+      for ( auto const& a : args )
+        _pin.names.push_back( unquote( a ) );
+    }
+    else if ( name == "timing" && parent == "pin" )
+    {
+      _timing = timing_group{};
+    }
+    else if ( parent == "timing" && is_table( name ) )
+    {
+      _table = table_group{};
+      _table.template_name = arg;
+    }
+  }
+
+  void on_group_end( const std::string& name ) const override
+  {
+    _groups.pop_back();
+    const std::string parent = _groups.empty() ? "" : _groups.back();
+
+    if ( name == "lu_table_template" && parent == "library" )
+    {
+      _templates[_template_name] = _template;
+    }
+    else if ( parent == "timing" && is_table( name ) )
+    {
+      auto& table = name == "cell_rise" ? _timing.arc.cell_rise : name == "cell_fall" ? _timing.arc.cell_fall : name == "rise_transition" ? _timing.arc.rise_transition : _timing.arc.fall_transition;
+      table = make_table( _table );
+    }
+    else if ( name == "timing" && parent == "pin" )
+    {
+      if ( _timing.type.empty() || _timing.type == "combinational" || _timing.type == "combinational_rise" || _timing.type == "combinational_fall" )
+        _pin.arcs.push_back( std::move( _timing ) );
+    }
+    else if ( name == "pin" && parent == "cell" )
+    {
+      if ( _pin.direction == "input" )
+      {
+        for ( auto const& pin : _pin.names )
+        {
+          _cell.inputs.push_back( pin );
+          _cell.capacitances.push_back( _pin.capacitance >= 0.0 ? _pin.capacitance : _pin.transition_capacitance );
+        }
+      }
+      else if ( _pin.direction == "output" && _cell.output.empty() && !_pin.names.empty() )
+      {
+        _cell.output = _pin.names.front();
+        _cell_arcs = std::move( _pin.arcs );
+      }
+    }
+    else if ( name == "cell" && parent == "library" )
+    {
+      /* related pins may be declared after the output pin */
+      _cell.pin_arcs.resize( _cell.inputs.size() );
+      for ( auto& timing : _cell_arcs )
+      {
+        for ( auto const& pin : split( timing.related_pin ) )
+        {
+          const auto index = _cell.find_input( pin );
+          if ( index == liberty_cell::no_pin )
+            continue;
+          _cell.pin_arcs[index].push_back( static_cast<uint32_t>( _cell.arcs.size() ) );
+          _cell.arcs.push_back( timing.arc );
+          _cell.arcs.back().pin = index;
+        }
+      }
+
+      const auto it = _library.cell_index.find( _cell.name );
+      if ( it == _library.cell_index.end() )
+      {
+        _library.cell_index.emplace( _cell.name, static_cast<uint32_t>( _library.cells.size() ) );
+        _library.cells.push_back( std::move( _cell ) );
+      }
+      else
+      {
+        _library.cells[it->second] = std::move( _cell );
+      }
+    }
+  }
+
+  void on_simple_attribute( const std::string& name, const std::string& value ) const override
+  {
+    if ( _groups.empty() )
+      return;
+    const std::string& group = _groups.back();
+    const std::string parent = _groups.size() > 1u ? _groups[_groups.size() - 2u] : "";
+
+    if ( group == "library" && name == "time_unit" )
+    {
+      _library.time_unit = unquote( value );
+    }
+    else if ( group == "lu_table_template" )
+    {
+      if ( name == "variable_1" )
+        _template.variable_1 = unquote( value );
+      else if ( name == "variable_2" )
+        _template.variable_2 = unquote( value );
+    }
+    else if ( group == "cell" && parent == "library" && name == "area" )
+    {
+      _cell.area = std::strtod( unquote( value ).c_str(), nullptr );
+    }
+    else if ( group == "pin" && parent == "cell" )
+    {
+      if ( name == "direction" )
+        _pin.direction = unquote( value );
+      else if ( name == "capacitance" )
+        _pin.capacitance = std::strtod( unquote( value ).c_str(), nullptr );
+      else if ( name == "rise_capacitance" || name == "fall_capacitance" )
+        _pin.transition_capacitance = std::max( _pin.transition_capacitance, std::strtod( unquote( value ).c_str(), nullptr ) );
+    }
+    else if ( group == "timing" && parent == "pin" )
+    {
+      if ( name == "related_pin" )
+        _timing.related_pin = unquote( value );
+      else if ( name == "timing_type" )
+        _timing.type = unquote( value );
+      else if ( name == "timing_sense" )
+      {
+        const auto sense = unquote( value );
+        _timing.arc.sense = sense == "positive_unate" ? liberty_timing_sense::positive_unate : sense == "negative_unate" ? liberty_timing_sense::negative_unate : liberty_timing_sense::non_unate;
+      }
+    }
+  }
+
+  void on_complex_attribute( const std::string& name, const std::vector<std::string>& values ) const override
+  {
+    if ( _groups.empty() )
+      return;
+    const std::string& group = _groups.back();
+    const std::string parent = _groups.size() > 1u ? _groups[_groups.size() - 2u] : "";
+
+    if ( group == "library" && name == "capacitive_load_unit" )
+    {
+      _library.capacitance_unit.clear();
+      for ( auto const& v : values )
+        _library.capacitance_unit += unquote( v );
+    }
+    else if ( group == "lu_table_template" )
+    {
+      if ( name == "index_1" )
+        _template.index_1 = numbers( values );
+      else if ( name == "index_2" )
+        _template.index_2 = numbers( values );
+    }
+    else if ( parent == "timing" && is_table( group ) )
+    {
+      if ( name == "index_1" )
+        _table.index_1 = numbers( values );
+      else if ( name == "index_2" )
+        _table.index_2 = numbers( values );
+      else if ( name == "values" )
+        _table.values = numbers( values );
+    }
+  }
+
+private:
+  struct table_template
+  {
+    std::string variable_1;
+    std::string variable_2;
+    std::vector<double> index_1;
+    std::vector<double> index_2;
+  };
+
+  struct table_group
+  {
+    std::string template_name;
+    std::vector<double> index_1;
+    std::vector<double> index_2;
+    std::vector<double> values;
+  };
+
+  struct timing_group
+  {
+    std::string related_pin;
+    std::string type;
+    liberty_arc arc;
+  };
+
+  struct pin_group
+  {
+    std::vector<std::string> names;
+    std::string direction;
+    /* capacitance, or else the larger of rise_capacitance and fall_capacitance */
+    double capacitance = -1.0;
+    double transition_capacitance = 0.0;
+    std::vector<timing_group> arcs;
+  };
+
+  static bool is_table( std::string const& name )
+  {
+    return name == "cell_rise" || name == "cell_fall" || name == "rise_transition" || name == "fall_transition";
+  }
+
+  static std::string unquote( std::string const& s )
+  {
+    if ( s.size() >= 2u && s.front() == '"' && s.back() == '"' )
+      return s.substr( 1u, s.size() - 2u );
+    return s;
+  }
+
+  static std::vector<std::string> split( std::string const& s )
+  {
+    std::vector<std::string> result;
+    std::string word;
+    for ( char c : s + " " )
+    {
+      if ( c == ' ' || c == '\t' || c == ',' )
+      {
+        if ( !word.empty() )
+          result.push_back( word );
+        word.clear();
+      }
+      else
+      {
+        word.push_back( c );
+      }
+    }
+    return result;
+  }
+
+  static std::vector<double> numbers( std::vector<std::string> const& values )
+  {
+    std::vector<double> result;
+    for ( auto const& v : values )
+    {
+      for ( auto const& word : split( unquote( v ) ) )
+        result.push_back( std::strtod( word.c_str(), nullptr ) );
+    }
+    return result;
+  }
+
+  /* Brings the values into slew major order, whichever template variable
+   * holds the output load. Tables that do not fit their axes are dropped. */
+  liberty_table make_table( table_group const& group ) const
+  {
+    table_template tmpl;
+    const auto it = _templates.find( group.template_name );
+    if ( it != _templates.end() )
+      tmpl = it->second;
+    const auto& axis_1 = group.index_1.empty() ? tmpl.index_1 : group.index_1;
+    const auto& axis_2 = group.index_2.empty() ? tmpl.index_2 : group.index_2;
+
+    liberty_table table;
+    if ( group.values.size() == 1u )
+    {
+      table.values = group.values;
+      return table;
+    }
+    if ( group.values.size() != std::max<std::size_t>( 1u, axis_1.size() ) * std::max<std::size_t>( 1u, axis_2.size() ) )
+      return table;
+
+    if ( tmpl.variable_1 == "total_output_net_capacitance" )
+    {
+      table.loads = axis_1;
+      table.slews = axis_2;
+      const std::size_t rows = std::max<std::size_t>( 1u, table.slews.size() ), columns = std::max<std::size_t>( 1u, table.loads.size() );
+      table.values.resize( group.values.size() );
+      for ( std::size_t l = 0u; l < columns; l++ )
+      {
+        for ( std::size_t s = 0u; s < rows; s++ )
+          table.values[s * columns + l] = group.values[l * rows + s];
+      }
+    }
+    else
+    {
+      table.slews = axis_1;
+      table.loads = axis_2;
+      table.values = group.values;
+    }
+    return table;
+  }
+
+  liberty_library& _library;
+
+  mutable std::vector<std::string> _groups;
+  mutable std::unordered_map<std::string, table_template> _templates;
+  mutable std::string _template_name;
+  mutable table_template _template;
+  mutable liberty_cell _cell;
+  mutable std::vector<timing_group> _cell_arcs;
+  mutable pin_group _pin;
+  mutable timing_group _timing;
+  mutable table_group _table;
+};
+
+} /* namespace mockturtle */
@@ -91,6 +91,7 @@
 #include "mockturtle/io/write_blif.hpp"
 #include "mockturtle/io/write_dot.hpp"
 #include "mockturtle/io/pla_reader.hpp"
+#include "mockturtle/io/liberty_reader.hpp"
 #include "mockturtle/io/write_dimacs.hpp"
 #include "mockturtle/networks/aig.hpp"
 #include "mockturtle/networks/events.hpp"
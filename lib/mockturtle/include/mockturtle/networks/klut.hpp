@@ -234,22 +234,17 @@ public:
     return n <= 1;
   }
 
+  /* combinational inputs are the only nodes other than the constants without fanins */
   bool is_ci( node const& n ) const
   {
-    bool found = false;
-    detail::foreach_element( _storage->inputs.begin(), _storage->inputs.end(), [&found,&n]( auto const& node ){
-        if ( node == n )
-        {
-          found = true;
-          return false;
-        }
-        return true;
-      } );
-    return found;
+    return n > 1 && _storage->nodes[n].children.empty();
   }
 
   bool is_pi( node const& n ) const
   {
+    if ( _storage->data.num_pis == _storage->inputs.size() )
+      return is_ci( n );
+
     bool found = false;
     detail::foreach_element( _storage->inputs.begin(), _storage->inputs.begin() + _storage->data.num_pis, [&found,&n]( auto const& node ){
         if ( node == n )
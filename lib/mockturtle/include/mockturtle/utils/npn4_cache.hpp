@@ -0,0 +1,66 @@
+/*!
+  \file npn4_cache.hpp
+  \brief Cache of exact NPN configurations of 4-input functions
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include <kitty/npn.hpp>
+#include <kitty/static_truth_table.hpp>
+
+namespace mockturtle
+{
+
+/*! \brief Exact NPN configurations of 4-input functions.
+ *
+ * Stores the result of `kitty::exact_npn_canonization` for each 4-input
+ * function, indexed by its 16 bits.  A configuration is computed the first
+ * time its function is looked up; later lookups neither canonize again nor
+ * allocate memory.
+ */
+class npn4_cache
+{
+public:
+  struct config
+  {
+    /*! \brief Bits of the NPN representative. */
+    uint16_t repr;
+
+    /*! \brief Input negations in bits 0 to 3, output negation in bit 4. */
+    uint8_t phase;
+
+    /*! \brief Permutation of the inputs. */
+    std::array<uint8_t, 4> perm;
+  };
+
+  npn4_cache() : _configs( 1u << 16 ), _known( 1u << 16, false )
+  {
+  }
+
+  /*! \brief Returns the NPN configuration of `tt`. */
+  config const& operator[]( kitty::static_truth_table<4> const& tt )
+  {
+    const auto function = static_cast<uint16_t>( *tt.cbegin() );
+    auto& c = _configs[function];
+    if ( !_known[function] )
+    {
+      const auto [repr, phase, perm] = kitty::exact_npn_canonization( tt );
+      c.repr = static_cast<uint16_t>( *repr.cbegin() );
+      c.phase = static_cast<uint8_t>( phase );
+      std::copy( perm.begin(), perm.end(), c.perm.begin() );
+      _known[function] = true;
+    }
+    return c;
+  }
+
+private:
+  std::vector<config> _configs;
+  std::vector<bool> _known;
+};
+
+} /* namespace mockturtle */
@@ -34,11 +34,109 @@
 
 #include "../traits.hpp"
 
-#include <map>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
 
 namespace mockturtle
 {
 
+namespace detail
+{
+
+/*! \brief Append-only arena of interned strings
+ *
+ * Every distinct string is stored once, in large character blocks, and
+ * referred to by a dense id starting at 1 (0 means "no name").  A pool is
+ * shared by a names_view, its copies, and the networks converted from it,
+ * and may be used from several threads.
+ */
+class name_pool
+{
+public:
+  uint32_t intern( std::string_view name )
+  {
+    std::lock_guard<std::mutex> lock( _mutex );
+    if ( const auto it = _ids.find( name ); it != _ids.end() )
+    {
+      return it->second;
+    }
+
+    char* data;
+    if ( name.size() > _block_size / 4u )
+    {
+      /* long strings get a block of their own */
+      _blocks.emplace_back( new char[name.size()] );
+      data = _blocks.back().get();
+    }
+    else
+    {
+      if ( name.size() > _block_left )
+      {
+        _blocks.emplace_back( new char[_block_size] );
+        _block_cursor = _blocks.back().get();
+        _block_left = _block_size;
+      }
+      data = _block_cursor;
+      _block_cursor += name.size();
+      _block_left -= name.size();
+    }
+    if ( !name.empty() )
+    {
+      std::memcpy( data, name.data(), name.size() );
+    }
+
+    _strings.emplace_back( data, name.size() );
+    const auto id = static_cast<uint32_t>( _strings.size() );
+    _ids.emplace( _strings.back(), id );
+    return id;
+  }
+
+  /*! \brief The interned string, valid as long as the pool lives */
+  std::string_view get( uint32_t id ) const
+  {
+    std::lock_guard<std::mutex> lock( _mutex );
+    return _strings[id - 1u];
+  }
+
+private:
+  static constexpr std::size_t _block_size = 1u << 16;
+
+  mutable std::mutex _mutex;
+  std::vector<std::unique_ptr<char[]>> _blocks;
+  char* _block_cursor = nullptr;
+  std::size_t _block_left = 0u;
+  std::vector<std::string_view> _strings;
+  std::unordered_map<std::string_view, uint32_t> _ids;
+};
+
+/*! \brief Name ids of the signals (by literal) and outputs (by index) of a network */
+struct name_table
+{
+  std::shared_ptr<name_pool> pool = std::make_shared<name_pool>();
+  std::vector<uint32_t> signal_names;
+  std::vector<uint32_t> output_names;
+};
+
+} /* namespace detail */
+
+/*! \brief Declares names for the signals and outputs of a network
+ *
+ * Names are kept as ids into an interned string pool, in arrays indexed by
+ * signal literal (node index and complement bit) and output index.  Copies
+ * of a names_view share the same tables until one of them is renamed
+ * (copy-on-write); a names_view that has no names allocates nothing.
+ * Networks derived from a named network can share its pool with
+ * share_name_pool and take over names with copy_name and copy_output_name
+ * without copying the strings.
+ */
 template<class Ntk>
 class names_view : public Ntk
 {
@@ -55,25 +153,33 @@ public:
 
   names_view( names_view<Ntk> const& named_ntk )
     : Ntk( named_ntk )
-    , _signal_names( named_ntk._signal_names )
-    , _output_names( named_ntk._output_names )
+    , _names( named_ntk._names )
   {
   }
 
   names_view<Ntk>& operator=( names_view<Ntk> const& named_ntk )
   {
-    std::map<signal, std::string> new_signal_names;
-    std::vector<signal> current_pis;
+    /* the names of the current primary inputs are carried over, by position,
+       to the primary inputs of the assigned network */
+    std::vector<uint32_t> pi_names;
     this->foreach_pi( [&]( auto const& n ) {
-      current_pis.emplace_back( this->make_signal( n ) );
-    });
-    named_ntk.foreach_pi( [&]( auto const& n, auto i ) {
-      if ( const auto it = _signal_names.find( current_pis[i] ); it != _signal_names.end() )
-        new_signal_names[named_ntk.make_signal( n )] = it->second;
+      pi_names.emplace_back( name_id( this->make_signal( n ) ) );
     } );
 
     Ntk::operator=( named_ntk );
-    _signal_names = new_signal_names;
+    if ( !_names )
+    {
+      return *this;
+    }
+
+    auto table = std::make_shared<detail::name_table>();
+    table->pool = _names->pool;
+    table->output_names = _names->output_names;
+    _names = table;
+    this->foreach_pi( [&]( auto const& n, auto i ) {
+      if ( i < pi_names.size() && pi_names[i] != 0u )
+        set_name_id( this->make_signal( n ), pi_names[i] );
+    } );
     return *this;
   }
 
@@ -99,37 +205,214 @@ public:
 
   bool has_name( signal const& s ) const
   {
-    return ( _signal_names.find( s ) != _signal_names.end() );
+    return name_id( s ) != 0u;
   }
 
   void set_name( signal const& s, std::string const& name )
   {
-    _signal_names[s] = name;
+    set_name_id( s, mutable_names().pool->intern( name ) );
   }
 
   std::string get_name( signal const& s ) const
   {
-    return _signal_names.at( s );
+    const auto id = name_id( s );
+    if ( id == 0u )
+    {
+      throw std::out_of_range( "names_view: signal has no name" );
+    }
+    return std::string( _names->pool->get( id ) );
   }
 
   bool has_output_name( uint32_t index ) const
   {
-    return ( _output_names.find( index ) != _output_names.end() );
+    return output_name_id( index ) != 0u;
   }
 
   void set_output_name( uint32_t index, std::string const& name )
   {
-    _output_names[index] = name;
+    set_output_name_id( index, mutable_names().pool->intern( name ) );
   }
 
   std::string get_output_name( uint32_t index ) const
   {
-    return _output_names.at( index );
+    const auto id = output_name_id( index );
+    if ( id == 0u )
+    {
+      throw std::out_of_range( "names_view: output has no name" );
+    }
+    return std::string( _names->pool->get( id ) );
+  }
+
+  /*! \brief Calls fn( signal, name ) for every named signal, in signal order
+   *
+   * name is a std::string_view into the string pool; it stays valid as long as
+   * the names of this view are neither modified nor destroyed.
+   */
+  template<typename Fn>
+  void foreach_signal_name( Fn&& fn ) const
+  {
+    if ( !_names )
+    {
+      return;
+    }
+    for ( uint64_t literal = 0u; literal < _names->signal_names.size(); ++literal )
+    {
+      if ( const auto id = _names->signal_names[literal]; id != 0u )
+      {
+        fn( literal_to_signal( literal ), _names->pool->get( id ) );
+      }
+    }
+  }
+
+  /*! \brief Calls fn( index, name ) for every named output, in index order
+   *
+   * name is a std::string_view with the same lifetime as in foreach_signal_name.
+   */
+  template<typename Fn>
+  void foreach_output_name( Fn&& fn ) const
+  {
+    if ( !_names )
+    {
+      return;
+    }
+    for ( uint32_t index = 0u; index < _names->output_names.size(); ++index )
+    {
+      if ( const auto id = _names->output_names[index]; id != 0u )
+      {
+        fn( index, _names->pool->get( id ) );
+      }
+    }
+  }
+
+  /*! \brief Interns all further names in the string pool of other
+   *
+   * Names already set are moved to the new pool.  Afterwards copy_name and
+   * copy_output_name from other only copy ids.
+   */
+  template<class OtherNtk>
+  void share_name_pool( names_view<OtherNtk> const& other )
+  {
+    if ( !other._names || ( _names && _names->pool == other._names->pool ) )
+    {
+      return;
+    }
+
+    auto table = std::make_shared<detail::name_table>();
+    table->pool = other._names->pool;
+    if ( _names )
+    {
+      auto reintern = [&]( std::vector<uint32_t> const& from, std::vector<uint32_t>& to ) {
+        to.resize( from.size(), 0u );
+        for ( std::size_t i = 0u; i < from.size(); ++i )
+        {
+          if ( from[i] != 0u )
+            to[i] = table->pool->intern( _names->pool->get( from[i] ) );
+        }
+      };
+      reintern( _names->signal_names, table->signal_names );
+      reintern( _names->output_names, table->output_names );
+    }
+    _names = table;
+  }
+
+  /*! \brief Gives s the name of signal t in other, if it has one */
+  template<class OtherNtk>
+  void copy_name( signal const& s, names_view<OtherNtk> const& other, typename OtherNtk::signal const& t )
+  {
+    if ( const auto id = other.name_id( t ); id != 0u )
+    {
+      auto& table = mutable_names();
+      set_name_id( s, table.pool == other._names->pool ? id : table.pool->intern( other._names->pool->get( id ) ) );
+    }
+  }
+
+  /*! \brief Gives output index the name of output other_index in other, if it has one */
+  template<class OtherNtk>
+  void copy_output_name( uint32_t index, names_view<OtherNtk> const& other, uint32_t other_index )
+  {
+    if ( const auto id = other.output_name_id( other_index ); id != 0u )
+    {
+      auto& table = mutable_names();
+      set_output_name_id( index, table.pool == other._names->pool ? id : table.pool->intern( other._names->pool->get( id ) ) );
+    }
+  }
+
+private:
+  template<class OtherNtk>
+  friend class names_view;
+
+  uint64_t literal( signal const& s ) const
+  {
+    return ( static_cast<uint64_t>( this->node_to_index( this->get_node( s ) ) ) << 1 ) | ( this->is_complemented( s ) ? 1u : 0u );
+  }
+
+  signal literal_to_signal( uint64_t lit ) const
+  {
+    auto s = this->make_signal( this->index_to_node( static_cast<uint32_t>( lit >> 1 ) ) );
+    if constexpr ( std::is_same_v<std::decay_t<decltype( !s )>, signal> )
+    {
+      if ( lit & 1u )
+        s = !s;
+    }
+    return s;
+  }
+
+  uint32_t name_id( signal const& s ) const
+  {
+    if ( !_names )
+    {
+      return 0u;
+    }
+    const auto lit = literal( s );
+    return lit < _names->signal_names.size() ? _names->signal_names[lit] : 0u;
+  }
+
+  uint32_t output_name_id( uint32_t index ) const
+  {
+    if ( !_names )
+    {
+      return 0u;
+    }
+    return index < _names->output_names.size() ? _names->output_names[index] : 0u;
+  }
+
+  void set_name_id( signal const& s, uint32_t id )
+  {
+    auto& names = mutable_names().signal_names;
+    const auto lit = literal( s );
+    if ( lit >= names.size() )
+    {
+      names.resize( lit + 1u, 0u );
+    }
+    names[lit] = id;
+  }
+
+  void set_output_name_id( uint32_t index, uint32_t id )
+  {
+    auto& names = mutable_names().output_names;
+    if ( index >= names.size() )
+    {
+      names.resize( index + 1u, 0u );
+    }
+    names[index] = id;
+  }
+
+  /* the name table, copied first if it is shared with another names_view */
+  detail::name_table& mutable_names()
+  {
+    if ( !_names )
+    {
+      _names = std::make_shared<detail::name_table>();
+    }
+    else if ( _names.use_count() > 1 )
+    {
+      _names = std::make_shared<detail::name_table>( *_names );
+    }
+    return *_names;
   }
 
 private:
-  std::map<signal, std::string> _signal_names;
-  std::map<uint32_t, std::string> _output_names;
+  std::shared_ptr<detail::name_table> _names;
 }; /* names_view */
 
 template<class T>
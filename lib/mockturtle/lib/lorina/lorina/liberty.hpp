@@ -43,11 +43,53 @@ namespace lorina
 
 /*! \brief A reader visitor for the LIBERTY format.
  *
- * Callbacks for the LIBERTY format.
+ * Callbacks for the LIBERTY format.  The library itself is reported as a
+ * group named `library`.
  */
     class liberty_reader
     {
     public:
+        /*! \brief Callback method for the beginning of a group.
+         *
+         * \param name Group name, such as library, cell, pin or timing
+         * \param args Arguments in parentheses after the group name
+         */
+        virtual void on_group_begin( const std::string& name, const std::vector<std::string>& args ) const
+        {
+            (void)name;
+            (void)args;
+        }
+
+        /*! \brief Callback method for the end of a group.
+         *
+         * \param name Group name
+         */
+        virtual void on_group_end( const std::string& name ) const
+        {
+            (void)name;
+        }
+
+        /*! \brief Callback method for a simple attribute `name : value;`.
+         *
+         * \param name Attribute name
+         * \param value Attribute value, including its quotes if it is quoted
+         */
+        virtual void on_simple_attribute( const std::string& name, const std::string& value ) const
+        {
+            (void)name;
+            (void)value;
+        }
+
+        /*! \brief Callback method for a complex attribute `name ( value, ... );`.
+         *
+         * \param name Attribute name
+         * \param values Attribute values, including their quotes if they are quoted
+         */
+        virtual void on_complex_attribute( const std::string& name, const std::vector<std::string>& values ) const
+        {
+            (void)name;
+            (void)values;
+        }
     }; // liberty_reader
 
 /*! \brief A LIBERTY reader for pretty-printing.
@@ -57,6 +99,37 @@ namespace lorina
     class liberty_pretty_printer : public liberty_reader
     {
     public:
+        /*! \brief Constructor of the LIBERTY pretty printer.
+         *
+         * \param os Output stream
+         */
+        liberty_pretty_printer( std::ostream& os = std::cout )
+                : _os( os )
+        {}
+
+        virtual void on_group_begin( const std::string& name, const std::vector<std::string>& args ) const override
+        {
+            _os << fmt::format( "{}( {} )\n", name, detail::join( args, ", " ) );
+            _os << "{" << std::endl;
+        }
+
+        virtual void on_group_end( const std::string& name ) const override
+        {
+            (void)name;
+            _os << "}" << std::endl;
+        }
+
+        virtual void on_simple_attribute( const std::string& name, const std::string& value ) const override
+        {
+            _os << fmt::format( "{} : {};\n", name, value );
+        }
+
+        virtual void on_complex_attribute( const std::string& name, const std::vector<std::string>& values ) const override
+        {
+            _os << fmt::format( "{}( {} );\n", name, detail::join( values, ", " ) );
+        }
+
+        std::ostream& _os; /*!< Output stream */
     }; // liberty_pretty_printer
 
     namespace detail
@@ -76,7 +149,7 @@ namespace lorina
             lexer_error = 9
         };
 
-        token_kind char_to_token_kind( char const c )
+        inline token_kind char_to_token_kind( char const c )
         {
             switch ( c )
             {
@@ -99,7 +172,7 @@ namespace lorina
             }
         }
 
-        std::string token_kind_to_string( token_kind const& kind )
+        inline std::string token_kind_to_string( token_kind const& kind )
         {
             switch ( kind )
             {
@@ -226,7 +299,7 @@ namespace lorina
 
             bool is_whitespace( char c ) const
             {
-                return ( c == ' ' || c == '\n' || c == '\\' );
+                return ( c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\\' );
             }
 
             bool is_separator( char c ) const
@@ -294,21 +367,20 @@ namespace lorina
                     return false;
                 consume();
 
-                std::cout << fmt::format( "library ( {} )\n", id );
-
                 if ( !is( token_kind::lscope ) )
                     return false;
                 consume();
 
-                std::cout << "{" << std::endl;
+                _reader.on_group_begin( "library", { id } );
 
-                parse_defs();
+                if ( !parse_defs() )
+                    return false;
 
                 if ( !is( token_kind::rscope ) )
                     return false;
                 consume();
 
-                std::cout << "}" << std::endl;
+                _reader.on_group_end( "library" );
 
                 if ( !is( token_kind::eof ) )
                     return false;
@@ -351,7 +423,7 @@ namespace lorina
                         return false;
                     consume();
 
-                    std::cout << fmt::format( "{} : {};\n", key, value );
+                    _reader.on_simple_attribute( key, value );
                     return true;
                 }
                 else if ( is( token_kind::lparan ) )
@@ -361,39 +433,23 @@ namespace lorina
 
                     while ( !is( token_kind::rparan ) )
                     {
-                        if ( is( token_kind::id ) )
-                        {
-                            values.emplace_back( _tok.lexem );
-                            consume();
+                        if ( !is( token_kind::id ) )
+                            return false;
+                        values.emplace_back( _tok.lexem );
+                        consume();
 
-                            if ( is( token_kind::comma ) )
-                                consume();
-                        }
+                        if ( is( token_kind::comma ) )
+                            consume();
                     }
 
                     assert( is( token_kind::rparan ) );
                     consume();
 
-                    if ( is( token_kind::semicolon ) )
-                    {
-                        consume();
-                        std::string out;
-                        for ( auto i = 0u; i < values.size(); ++i )
-                        {
-                            out += values.at( i );
-                            if ( i+1 < values.size() )
-                                out += ", ";
-                        }
-                        std::cout << fmt::format( "{}( {} );\n", key, out );
-                        return true;
-                    }
-                    else if ( is( token_kind::lscope ) )
+                    if ( is( token_kind::lscope ) )
                     {
                         consume();
 
-                        assert( values.size() <= 1u );
-                        std::cout << fmt::format( "{}( {} )\n", key, values.size() == 0u ? "" : values.at( 0u ) );
-                        std::cout << "{" << std::endl;
+                        _reader.on_group_begin( key, values );
 
                         bool okay = parse_defs();
                         if ( !okay )
@@ -403,9 +459,15 @@ namespace lorina
                             return false;
                         consume();
 
-                        std::cout << "}" << std::endl;
+                        _reader.on_group_end( key );
                         return true;
                     }
+
+                    /* the semicolon after a complex attribute is optional */
+                    if ( is( token_kind::semicolon ) )
+                        consume();
+                    _reader.on_complex_attribute( key, values );
+                    return true;
                 }
                 return false;
             }
@@ -1,10 +1,16 @@
 #include <catch.hpp>
 
+#include <algorithm>
 #include <iostream>
+#include <vector>
 
 #include <kitty/constructors.hpp>
 #include <kitty/dynamic_truth_table.hpp>
+#include <kitty/operations.hpp>
+#include <kitty/static_truth_table.hpp>
 #include <mockturtle/algorithms/cut_enumeration.hpp>
+#include <mockturtle/algorithms/cut_enumeration/mf_cut.hpp>
+#include <mockturtle/generators/arithmetic.hpp>
 #include <mockturtle/networks/aig.hpp>
 #include <mockturtle/networks/klut.hpp>
 
@@ -176,6 +182,85 @@ TEST_CASE( "compute XOR network cuts in 2-LUT network", "[cut_enumeration]" )
   }
 }
 
+TEST_CASE( "enumerate cuts of an AIG level by level on several threads", "[cut_enumeration]" )
+{
+  aig_network aig;
+  std::vector<aig_network::signal> a( 6u ), b( 6u );
+  std::generate( a.begin(), a.end(), [&aig]() { return aig.create_pi(); } );
+  std::generate( b.begin(), b.end(), [&aig]() { return aig.create_pi(); } );
+  for ( auto const& f : carry_ripple_multiplier( aig, a, b ) )
+  {
+    aig.create_po( f );
+  }
+
+  const auto to_vector = []( auto const& cut ) {
+    return std::vector<uint32_t>( cut.begin(), cut.end() );
+  };
+
+  cut_enumeration_params ps;
+  ps.cut_size = 6u;
+  ps.cut_limit = 8u;
+  const auto cuts = cut_enumeration<aig_network, true, cut_enumeration_mf_cut>( aig, ps );
+
+  for ( auto num_threads : {2u, 4u} )
+  {
+    ps.num_threads = num_threads;
+    const auto pcuts = cut_enumeration<aig_network, true, cut_enumeration_mf_cut>( aig, ps );
+    const auto pcuts_no_tt = cut_enumeration<aig_network, false, cut_enumeration_mf_cut>( aig, ps );
+
+    CHECK( pcuts.total_cuts() == cuts.total_cuts() );
+    CHECK( pcuts.total_tuples() == cuts.total_tuples() );
+    CHECK( pcuts_no_tt.total_cuts() == cuts.total_cuts() );
+
+    aig.foreach_node( [&]( auto n ) {
+      const auto index = aig.node_to_index( n );
+      auto const& set = cuts.cuts( index );
+      auto const& pset = pcuts.cuts( index );
+      auto const& pset_no_tt = pcuts_no_tt.cuts( index );
+      REQUIRE( pset.size() == set.size() );
+      REQUIRE( pset_no_tt.size() == set.size() );
+      for ( auto i = 0u; i < set.size(); ++i )
+      {
+        CHECK( to_vector( pset[i] ) == to_vector( set[i] ) );
+        CHECK( to_vector( pset_no_tt[i] ) == to_vector( set[i] ) );
+        CHECK( pcuts.truth_table( pset[i] ) == cuts.truth_table( set[i] ) );
+        CHECK( pset[i]->data.delay == set[i]->data.delay );
+        CHECK( pset[i]->data.flow == set[i]->data.flow );
+      }
+    } );
+  }
+}
+
+TEST_CASE( "compute static truth tables of AIG cuts", "[cut_enumeration]" )
+{
+  aig_network aig;
+  std::vector<aig_network::signal> a( 4u ), b( 4u );
+  std::generate( a.begin(), a.end(), [&aig]() { return aig.create_pi(); } );
+  std::generate( b.begin(), b.end(), [&aig]() { return aig.create_pi(); } );
+  for ( auto const& f : carry_ripple_multiplier( aig, a, b ) )
+  {
+    aig.create_po( f );
+  }
+
+  cut_enumeration_params ps;
+  ps.cut_size = 4u;
+  const auto cuts = cut_enumeration<aig_network, true>( aig, ps );
+  const auto scuts = cut_enumeration<aig_network, true, empty_cut_data, kitty::static_truth_table<4>>( aig, ps );
+
+  CHECK( scuts.total_cuts() == cuts.total_cuts() );
+  aig.foreach_node( [&]( auto n ) {
+    const auto index = aig.node_to_index( n );
+    auto const& set = cuts.cuts( index );
+    auto const& sset = scuts.cuts( index );
+    REQUIRE( sset.size() == set.size() );
+    for ( auto i = 0u; i < set.size(); ++i )
+    {
+      CHECK( std::vector<uint32_t>( sset[i].begin(), sset[i].end() ) == std::vector<uint32_t>( set[i].begin(), set[i].end() ) );
+      CHECK( kitty::shrink_to( scuts.truth_table( sset[i] ), set[i].size() ) == cuts.truth_table( set[i] ) );
+    }
+  } );
+}
+
 TEST_CASE( "enumerate cuts for an AIG (small graph version)", "[fast_small_cut_enumeration]" )
 {
   aig_network aig;
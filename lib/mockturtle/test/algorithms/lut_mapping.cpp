@@ -1,6 +1,8 @@
 #include <catch.hpp>
 
 #include <mockturtle/traits.hpp>
+#include <mockturtle/algorithms/cut_enumeration.hpp>
+#include <mockturtle/algorithms/cut_enumeration/mf_cut.hpp>
 #include <mockturtle/algorithms/lut_mapping.hpp>
 #include <mockturtle/generators/arithmetic.hpp>
 #include <mockturtle/networks/aig.hpp>
@@ -141,3 +143,68 @@ TEST_CASE( "LUT mapping with functions of full adder", "[lut_mapping]" )
   CHECK( mapped_aig.cell_function( aig.get_node( sum ) )._bits[0] == 0x96 );
   CHECK( mapped_aig.cell_function( aig.get_node( carry ) )._bits[0] == 0x17 );
 }
+
+TEST_CASE( "LUT mapping on restricted cuts", "[lut_mapping]" )
+{
+  aig_network aig;
+
+  std::vector<aig_network::signal> a( 8 ), b( 8 );
+  std::generate( a.begin(), a.end(), [&aig]() { return aig.create_pi(); } );
+  std::generate( b.begin(), b.end(), [&aig]() { return aig.create_pi(); } );
+  auto carry = aig.get_constant( false );
+
+  carry_ripple_adder_inplace( aig, a, b, carry );
+
+  std::for_each( a.begin(), a.end(), [&]( auto f ) { aig.create_po( f ); } );
+  aig.create_po( carry );
+
+  using mapped_t = mapping_view<aig_network, true>;
+  cut_enumeration_params cps;
+  cps.cut_size = 6u;
+  cps.cut_limit = 16u;
+  mapped_t enumerated{ aig };
+  const auto cuts = cut_enumeration<mapped_t, true, cut_enumeration_mf_cut>( enumerated, cps );
+
+  /* same parameters as the enumeration: same mapping as lut_mapping alone */
+  for ( auto limit : {16u, 8u} )
+  {
+    lut_mapping_params ps;
+    ps.cut_enumeration_ps.cut_size = 6u;
+    ps.cut_enumeration_ps.cut_limit = limit;
+
+    mapped_t mapped_aig{ aig }, reference{ aig };
+    lut_mapping<mapped_t, true>( mapped_aig, restrict_cuts( mapped_aig, cuts, ps.cut_enumeration_ps ), ps );
+    lut_mapping<mapped_t, true>( reference, ps );
+
+    CHECK( mapped_aig.num_cells() <= reference.num_cells() );
+    if ( limit == 16u )
+    {
+      CHECK( mapped_aig.num_cells() == reference.num_cells() );
+      aig.foreach_gate( [&]( auto n ) {
+        CHECK( mapped_aig.is_cell_root( n ) == reference.is_cell_root( n ) );
+        if ( mapped_aig.is_cell_root( n ) )
+          CHECK( mapped_aig.cell_function( n ) == reference.cell_function( n ) );
+      } );
+    }
+  }
+
+  /* smaller cut size: every cut fits */
+  lut_mapping_params ps;
+  ps.cut_enumeration_ps.cut_size = 2u;
+  ps.cut_enumeration_ps.cut_limit = 4u;
+  mapped_t mapped_aig{ aig };
+  const auto small_cuts = restrict_cuts( mapped_aig, cuts, ps.cut_enumeration_ps );
+  aig.foreach_gate( [&]( auto n ) {
+    for ( auto const* cut : small_cuts.cuts( aig.node_to_index( n ) ) )
+      CHECK( cut->size() <= 2u );
+  } );
+  lut_mapping<mapped_t, true>( mapped_aig, restrict_cuts( mapped_aig, cuts, ps.cut_enumeration_ps ), ps );
+  CHECK( mapped_aig.has_mapping() );
+  aig.foreach_gate( [&]( auto n ) {
+    if ( !mapped_aig.is_cell_root( n ) )
+      return;
+    uint32_t fanins = 0u;
+    mapped_aig.foreach_cell_fanin( n, [&]( auto ) { ++fanins; } );
+    CHECK( fanins <= 2u );
+  } );
+}
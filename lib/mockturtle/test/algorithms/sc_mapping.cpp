@@ -0,0 +1,135 @@
+#include <catch.hpp>
+
+#include <utility>
+#include <vector>
+
+#include <kitty/constructors.hpp>
+#include <kitty/dynamic_truth_table.hpp>
+#include <kitty/operations.hpp>
+#include <kitty/print.hpp>
+#include <mockturtle/algorithms/sc_mapping.hpp>
+#include <mockturtle/networks/aig.hpp>
+#include <mockturtle/traits.hpp>
+#include <mockturtle/views/mapping_view.hpp>
+
+using namespace mockturtle;
+
+namespace
+{
+
+/* every 2-input function with area 1 and delay 1, and some larger gates */
+struct test_library
+{
+  void add( std::string const& hex, uint32_t num_vars, double area, double delay )
+  {
+    kitty::dynamic_truth_table tt( num_vars );
+    kitty::create_from_hex_string( tt, hex );
+    gates.emplace_back( tt, sc_supergate{area, std::vector<double>( num_vars, delay )} );
+  }
+
+  sc_supergate const* match( kitty::dynamic_truth_table const& function ) const
+  {
+    if ( function.num_vars() == 2u )
+      return &two_input;
+    for ( auto const& g : gates )
+    {
+      if ( g.first.num_vars() == function.num_vars() && g.first == function )
+        return &g.second;
+    }
+    return nullptr;
+  }
+
+  sc_supergate two_input{1.0, {1.0, 1.0}};
+  std::vector<std::pair<kitty::dynamic_truth_table, sc_supergate>> gates;
+};
+
+struct empty_library
+{
+  sc_supergate const* match( kitty::dynamic_truth_table const& ) const
+  {
+    return nullptr;
+  }
+};
+
+} // namespace
+
+TEST_CASE( "Standard cell mapping of a 3-input XOR", "[sc_mapping]" )
+{
+  aig_network aig;
+  const auto a = aig.create_pi();
+  const auto b = aig.create_pi();
+  const auto c = aig.create_pi();
+  aig.create_po( aig.create_xor( aig.create_xor( a, b ), c ) );
+
+  test_library library;
+  library.add( "96", 3u, 1.5, 1.0 );
+
+  mapping_view<aig_network, true> mapped{aig};
+  sc_mapping_stats st;
+  sc_mapping( mapped, library, {}, &st );
+
+  CHECK( mapped.num_cells() == 1u );
+  CHECK( st.num_cells == 1u );
+  CHECK( st.num_unmatched == 0u );
+  CHECK( st.area == Approx( 1.5 ) );
+  CHECK( st.delay == Approx( 1.0 ) );
+
+  const auto root = aig.get_node( aig.po_at( 0 ) );
+  CHECK( mapped.is_cell_root( root ) );
+  auto fn = mapped.cell_function( root );
+  if ( aig.is_complemented( aig.po_at( 0 ) ) )
+    fn = ~fn;
+  CHECK( kitty::to_hex( fn ) == "96" );
+}
+
+TEST_CASE( "Standard cell mapping keeps the delay of the delay oriented mapping", "[sc_mapping]" )
+{
+  aig_network aig;
+  const auto a = aig.create_pi();
+  const auto b = aig.create_pi();
+  const auto c = aig.create_pi();
+  const auto d = aig.create_pi();
+  aig.create_po( aig.create_and( aig.create_and( a, b ), aig.create_and( c, d ) ) );
+
+  sc_mapping_params ps;
+  ps.cut_enumeration_ps.cut_size = 4;
+
+  /* a slow 4-input AND is smaller but would increase the delay */
+  test_library slow;
+  slow.add( "8000", 4u, 1.0, 5.0 );
+
+  mapping_view<aig_network, true> mapped{aig};
+  sc_mapping_stats st;
+  sc_mapping( mapped, slow, ps, &st );
+
+  CHECK( mapped.num_cells() == 3u );
+  CHECK( st.area == Approx( 3.0 ) );
+  CHECK( st.delay == Approx( 2.0 ) );
+
+  /* a fast one is both smaller and faster */
+  test_library fast;
+  fast.add( "8000", 4u, 1.0, 1.5 );
+
+  sc_mapping( mapped, fast, ps, &st );
+
+  CHECK( mapped.num_cells() == 1u );
+  CHECK( st.area == Approx( 1.0 ) );
+  CHECK( st.delay == Approx( 1.5 ) );
+}
+
+TEST_CASE( "Standard cell mapping without matching cuts", "[sc_mapping]" )
+{
+  aig_network aig;
+  const auto a = aig.create_pi();
+  const auto b = aig.create_pi();
+  const auto c = aig.create_pi();
+  aig.create_po( aig.create_and( aig.create_and( a, b ), c ) );
+
+  mapping_view<aig_network, true> mapped{aig};
+  sc_mapping_stats st;
+  sc_mapping( mapped, empty_library{}, {}, &st );
+
+  CHECK( mapped.num_cells() > 0u );
+  CHECK( st.num_unmatched == mapped.num_cells() );
+  CHECK( st.area == Approx( 0.0 ) );
+}
@@ -0,0 +1,96 @@
+#include <catch.hpp>
+
+#include <sstream>
+#include <string>
+
+#include <kitty/constructors.hpp>
+#include <kitty/dynamic_truth_table.hpp>
+#include <lorina/liberty.hpp>
+#include <mockturtle/algorithms/sta.hpp>
+#include <mockturtle/io/liberty_reader.hpp>
+#include <mockturtle/networks/klut.hpp>
+
+using namespace mockturtle;
+
+/* delays are 10 + slew + load (INV rise), 5 + slew + load (INV fall),
+ * 20 + slew + 2 load (NAND2 rise) and 10 + slew + load (NAND2 fall);
+ * transitions are 4 + load and 5 + load */
+static std::string const library_file{
+    "library (test) {\n"
+    "  lu_table_template (t) { variable_1 : input_net_transition; variable_2 : total_output_net_capacitance; index_1 (\"0, 10\"); index_2 (\"0, 10\"); }\n"
+    "  cell (INV) {\n"
+    "    pin (A) { direction : input; capacitance : 1.0; }\n"
+    "    pin (Y) { direction : output; timing () { related_pin : \"A\"; timing_sense : negative_unate;\n"
+    "      cell_rise (t) { values (\"10, 20\", \"20, 30\"); } cell_fall (t) { values (\"5, 15\", \"15, 25\"); }\n"
+    "      rise_transition (t) { values (\"4, 14\", \"4, 14\"); } fall_transition (t) { values (\"4, 14\", \"4, 14\"); } } }\n"
+    "  }\n"
+    "  cell (NAND2) {\n"
+    "    pin (A) { direction : input; capacitance : 2.0; }\n"
+    "    pin (B) { direction : input; capacitance : 3.0; }\n"
+    "    pin (Y) { direction : output; timing () { related_pin : \"A B\"; timing_sense : negative_unate;\n"
+    "      cell_rise (t) { values (\"20, 40\", \"30, 50\"); } cell_fall (t) { values (\"10, 20\", \"20, 30\"); }\n"
+    "      rise_transition (t) { values (\"5, 15\", \"5, 15\"); } fall_transition (t) { values (\"5, 15\", \"5, 15\"); } } }\n"
+    "  }\n"
+    "}\n"};
+
+TEST_CASE( "static timing analysis of a small netlist", "[sta]" )
+{
+  std::istringstream in( library_file );
+  liberty_library library;
+  REQUIRE( lorina::read_liberty( in, liberty_reader( library ) ) == lorina::return_code::success );
+
+  klut_network klut;
+  const auto a = klut.create_pi();
+  const auto b = klut.create_pi();
+  kitty::dynamic_truth_table inv( 1u ), nand( 2u );
+  kitty::create_from_hex_string( inv, "1" );
+  kitty::create_from_hex_string( nand, "7" );
+  const auto n1 = klut.create_node( {a}, inv );
+  const auto n2 = klut.create_node( {n1, b}, nand );
+  klut.create_po( n2 );
+
+  const auto inv_binding = *bind_cell( library, "INV", {"A"} );
+  const auto nand_binding = *bind_cell( library, "NAND2", {"A", "B"} );
+  CHECK( !bind_cell( library, "NOR2", {"A", "B"} ) );
+  auto binding = [&]( auto const& n ) -> liberty_binding const* {
+    return n == n1 ? &inv_binding : n == n2 ? &nand_binding : nullptr;
+  };
+
+  sta_params ps;
+  ps.output_load = 2.0;
+  ps.clock_period = 40.0;
+  const auto timing = static_timing_analysis( klut, binding, ps );
+
+  CHECK( timing.loads[a] == 1.0 );
+  CHECK( timing.loads[b] == 3.0 );
+  CHECK( timing.loads[n1] == 2.0 );
+  CHECK( timing.loads[n2] == 2.0 );
+
+  /* the rise of n2 follows the fall of n1, which follows the rise of a */
+  CHECK( timing.arrivals[2 * n1] == 12.0 );
+  CHECK( timing.arrivals[2 * n1 + 1] == 7.0 );
+  CHECK( timing.slews[2 * n1] == 6.0 );
+  CHECK( timing.arrivals[2 * n2] == 37.0 );
+  CHECK( timing.arrivals[2 * n2 + 1] == 30.0 );
+  CHECK( timing.worst_arrival == 37.0 );
+
+  CHECK( timing.requireds[2 * n1 + 1] == 10.0 );
+  CHECK( timing.requireds[2 * n1] == 22.0 );
+  CHECK( timing.slack( n1 ) == 3.0 );
+  CHECK( timing.slack( a ) == 3.0 );
+  CHECK( timing.slack( b ) == 16.0 );
+  CHECK( timing.worst_slack == 3.0 );
+  CHECK( timing.total_negative_slack == 0.0 );
+  CHECK( timing.num_endpoints == 1u );
+  CHECK( timing.num_unbound == 0u );
+
+  ps.clock_period = 30.0;
+  const auto late = static_timing_analysis( klut, binding, ps );
+  CHECK( late.worst_slack == -7.0 );
+  CHECK( late.total_negative_slack == -7.0 );
+
+  /* gates without a cell are timed as wires */
+  const auto wires = static_timing_analysis( klut, []( auto const& ) -> liberty_binding const* { return nullptr; } );
+  CHECK( wires.worst_arrival == 0.0 );
+  CHECK( wires.num_unbound == 2u );
+}
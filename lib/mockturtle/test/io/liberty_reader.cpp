@@ -0,0 +1,83 @@
+#include <catch.hpp>
+
+#include <sstream>
+#include <string>
+
+#include <lorina/liberty.hpp>
+#include <mockturtle/io/liberty_reader.hpp>
+
+using namespace mockturtle;
+
+TEST_CASE( "read Liberty timing", "[liberty_reader]" )
+{
+  std::string file{
+      "/* two cells */\n"
+      "library (test) {\n"
+      "\ttime_unit : \"1ps\";\n"
+      "\tcapacitive_load_unit (1,ff);\n"
+      "\tlu_table_template (load_first) {\n"
+      "\t\tvariable_1 : total_output_net_capacitance;\n"
+      "\t\tvariable_2 : input_net_transition;\n"
+      "\t\tindex_1 (\"0, 10\");\n"
+      "\t\tindex_2 (\"0, 10\");\n"
+      "\t}\n"
+      "\tcell (NAND2) {\n"
+      "\t\tarea : 0.5;\n"
+      "\t\tpin (Y) {\n"
+      "\t\t\tdirection : output;\n"
+      "\t\t\ttiming () {\n"
+      "\t\t\t\trelated_pin : \"A B\";\n"
+      "\t\t\t\ttiming_sense : negative_unate;\n"
+      "\t\t\t\tcell_rise (load_first) {\n"
+      "\t\t\t\t\tvalues (\"20, 30\", \\\n"
+      "\t\t\t\t\t        \"40, 50\");\n"
+      "\t\t\t\t}\n"
+      "\t\t\t}\n"
+      "\t\t}\n"
+      "\t\tpin (A) { direction : input; capacitance : 2.0; }\n"
+      "\t\tpin (B) { direction : input; rise_capacitance : 2.5; fall_capacitance : 3.0; }\n"
+      "\t}\n"
+      "\tcell (DFF) {\n"
+      "\t\tff (IQ, IQN) { next_state : \"D\"; }\n"
+      "\t\tpin (D) { direction : input; capacitance : 1.0; }\n"
+      "\t\tpin (Q) { direction : output;\n"
+      "\t\t\ttiming () { related_pin : \"CLK\"; timing_type : rising_edge; cell_rise (scalar) { values (\"30\"); } }\n"
+      "\t\t}\n"
+      "\t}\n"
+      "}\n"};
+
+  std::istringstream in( file );
+  liberty_library library;
+  CHECK( lorina::read_liberty( in, liberty_reader( library ) ) == lorina::return_code::success );
+
+  CHECK( library.name == "test" );
+  CHECK( library.time_unit == "1ps" );
+  CHECK( library.capacitance_unit == "1ff" );
+  CHECK( library.cells.size() == 2u );
+  CHECK( library.find( "AND2" ) == nullptr );
+
+  auto const* nand = library.find( "NAND2" );
+  REQUIRE( nand != nullptr );
+  CHECK( nand->area == 0.5 );
+  CHECK( nand->output == "Y" );
+  CHECK( nand->inputs == std::vector<std::string>{"A", "B"} );
+  CHECK( nand->capacitances == std::vector<double>{2.0, 3.0} );
+  REQUIRE( nand->arcs.size() == 2u );
+  CHECK( nand->pin_arcs[nand->find_input( "B" )] == std::vector<uint32_t>{1u} );
+
+  /* the table is stored slew first and interpolated, or extrapolated, in both directions */
+  auto const& arc = nand->arcs[0];
+  CHECK( arc.sense == liberty_timing_sense::negative_unate );
+  CHECK( arc.cell_rise.slews == std::vector<double>{0.0, 10.0} );
+  CHECK( arc.cell_rise.values == std::vector<double>{20.0, 40.0, 30.0, 50.0} );
+  CHECK( arc.cell_rise.lookup( 0.0, 10.0 ) == 40.0 );
+  CHECK( arc.cell_rise.lookup( 5.0, 5.0 ) == 35.0 );
+  CHECK( arc.cell_rise.lookup( 20.0, 0.0 ) == 40.0 );
+  CHECK( arc.cell_fall.empty() );
+
+  /* sequential arcs are not kept */
+  auto const* dff = library.find( "DFF" );
+  REQUIRE( dff != nullptr );
+  CHECK( dff->inputs.size() == 1u );
+  CHECK( dff->arcs.empty() );
+}
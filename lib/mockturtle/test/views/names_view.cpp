@@ -1,6 +1,10 @@
 #include <catch.hpp>
 
 #include <set>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
 
 #include <mockturtle/traits.hpp>
 #include <mockturtle/networks/aig.hpp>
@@ -99,3 +103,60 @@ TEST_CASE( "copy names", "[names_view]" )
   test_copy_names_view<xmg_network>();
   test_copy_names_view<klut_network>();
 }
+
+template<typename Ntk>
+void test_shared_names_view()
+{
+  names_view<Ntk> named_ntk;
+  auto const a = named_ntk.create_pi( "a" );
+  auto const b = named_ntk.create_pi( "b" );
+  named_ntk.create_po( named_ntk.create_and( a, b ), "f" );
+
+  /* copies share the names until one of them is renamed */
+  names_view<Ntk> copy = named_ntk;
+  copy.set_name( a, "x" );
+  CHECK( copy.get_name( a ) == "x" );
+  CHECK( named_ntk.get_name( a ) == "a" );
+  CHECK( copy.get_name( b ) == "b" );
+  CHECK( copy.get_output_name( 0 ) == "f" );
+
+  /* names copied into another network, with or without a shared pool */
+  for ( auto share : {true, false} )
+  {
+    names_view<Ntk> other;
+    if ( share )
+    {
+      other.share_name_pool( named_ntk );
+    }
+    auto const c = other.create_pi();
+    auto const d = other.create_pi( "d" );
+    other.create_po( d );
+    other.copy_name( c, named_ntk, b );
+    other.copy_name( d, named_ntk, named_ntk.get_constant( false ) );
+    other.copy_output_name( 0, named_ntk, 0 );
+    CHECK( other.get_name( c ) == "b" );
+    CHECK( other.get_name( d ) == "d" );
+    CHECK( other.get_output_name( 0 ) == "f" );
+  }
+
+  std::vector<std::string> names;
+  std::vector<std::string_view> views;
+  named_ntk.foreach_signal_name( [&]( auto const& s, auto const& name ) {
+    CHECK( named_ntk.get_name( s ) == name );
+    names.emplace_back( name );
+    views.push_back( name );
+  } );
+  CHECK( names == std::vector<std::string>{"a", "b"} );
+  /* the names passed to foreach_signal_name stay valid after the call */
+  CHECK( std::vector<std::string>( views.begin(), views.end() ) == names );
+  CHECK_THROWS_AS( named_ntk.get_output_name( 1 ), std::out_of_range );
+}
+
+TEST_CASE( "share names between copies and derived networks", "[names_view]" )
+{
+  test_shared_names_view<aig_network>();
+  test_shared_names_view<mig_network>();
+  test_shared_names_view<xag_network>();
+  test_shared_names_view<xmg_network>();
+  test_shared_names_view<klut_network>();
+}